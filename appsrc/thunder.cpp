@@ -146,6 +146,64 @@ void readPara(OptimiserPara& dst,
     dst.ctfRefineS = src["Advanced"]["CTF Refine Standard Deviation"].asFloat();
 
     dst.transSearchFactor = src["Professional"]["Translation Search Factor"].asFloat();
+    dst.transSearchFFT = src["Professional"]["Translation Search by FFT"].asBool();
+    if (src["Professional"].isMember("Padding Factor of Translation Search by FFT"))
+        dst.transSearchFFTPf = src["Professional"]["Padding Factor of Translation Search by FFT"].asInt();
+    dst.earlyAbandonEps = src["Professional"]["Early Abandon Threshold in Local Search"].asFloat();
+    if (src["Professional"].isMember("Number of Significant Poses in Global Search"))
+        dst.nSigPose = src["Professional"]["Number of Significant Poses in Global Search"].asInt();
+    if (src["Professional"].isMember("Number of Stages in Global Search"))
+        dst.nStageGSearch = src["Professional"]["Number of Stages in Global Search"].asInt();
+    if (src["Professional"].isMember("Fraction of Orientations Kept by Each Stage in Global Search"))
+        dst.keepFracGSearch = src["Professional"]["Fraction of Orientations Kept by Each Stage in Global Search"].asFloat();
+    if (src["Professional"].isMember("Projection Cache Size in Local Search (MB)"))
+        dst.projCacheSize = src["Professional"]["Projection Cache Size in Local Search (MB)"].asFloat();
+    if (src["Professional"].isMember("Quantisation Step of Quaternion in Projection Cache"))
+        dst.projCacheStep = src["Professional"]["Quantisation Step of Quaternion in Projection Cache"].asFloat();
+    if (src["Professional"].isMember("Warm Start of Balancing Weights in Reconstruction"))
+        dst.warmStartW = src["Professional"]["Warm Start of Balancing Weights in Reconstruction"].asBool();
+    if (src["Professional"].isMember("Over-Relaxation Factor of Balancing Weights in Reconstruction"))
+        dst.balanceRelax = src["Professional"]["Over-Relaxation Factor of Balancing Weights in Reconstruction"].asFloat();
+    if (src["Professional"].isMember("Symmetrizing in Reconstruction"))
+    {
+        if (src["Professional"]["Symmetrizing in Reconstruction"].asString() == "After Insertion")
+            dst.symmetrizeMode = SYMMETRIZE_AFTER_INSERT;
+        else if (src["Professional"]["Symmetrizing in Reconstruction"].asString() == "By Insertion")
+            dst.symmetrizeMode = SYMMETRIZE_BY_INSERT;
+        else if (src["Professional"]["Symmetrizing in Reconstruction"].asString() == "Auto")
+            dst.symmetrizeMode = SYMMETRIZE_AUTO;
+        else
+        {
+            REPORT_ERROR("INEXISTENT WAY OF SYMMETRIZING");
+
+            abort();
+        }
+    }
+    if (src["Professional"].isMember("Chunk Size of Allreducing in Reconstruction (MB)"))
+        dst.reduceChunk = src["Professional"]["Chunk Size of Allreducing in Reconstruction (MB)"].asFloat();
+    if (src["Professional"].isMember("Sharing Volumes of Reconstruction on Node"))
+        dst.nodeShared = src["Professional"]["Sharing Volumes of Reconstruction on Node"].asBool();
+    if (src["Professional"].isMember("Sharing Projectees on Node"))
+        dst.projNodeShared = src["Professional"]["Sharing Projectees on Node"].asBool();
+    if (src["Professional"].isMember("Spreading Classes across Processes"))
+        dst.classParallel = src["Professional"]["Spreading Classes across Processes"].asBool();
+    if (src["Professional"].isMember("Rigour of Creating FFTW Plans"))
+    {
+        if (src["Professional"]["Rigour of Creating FFTW Plans"].asString() == "Estimate")
+            dst.fftwRigour = FFTW_ESTIMATE;
+        else if (src["Professional"]["Rigour of Creating FFTW Plans"].asString() == "Measure")
+            dst.fftwRigour = FFTW_MEASURE;
+        else if (src["Professional"]["Rigour of Creating FFTW Plans"].asString() == "Patient")
+            dst.fftwRigour = FFTW_PATIENT;
+        else
+        {
+            REPORT_ERROR("INEXISTENT RIGOUR OF CREATING FFTW PLANS");
+
+            abort();
+        }
+    }
+    if (src["Professional"].isMember("FFTW Wisdom File"))
+        copy_string(dst.fftwWisdom, src["Professional"]["FFTW Wisdom File"].asString());
     dst.perturbFactorL = src["Professional"]["Perturbation Factor (Large)"].asFloat();
     dst.perturbFactorSGlobal = src["Professional"]["Perturbation Factor (Small, Global)"].asFloat();
     dst.perturbFactorSLocal = src["Professional"]["Perturbation Factor (Small, Local)"].asFloat();
@@ -185,6 +243,9 @@ int main(int argc, char* argv[])
     int rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
+    int commSize;
+    MPI_Comm_size(MPI_COMM_WORLD, &commSize);
+
     if(rank == 0)
     {
         startTime = MPI_Wtime();
@@ -239,6 +300,17 @@ int main(int argc, char* argv[])
     CLOG(INFO, "LOGGER_SYS") << "Setting Time Limit for Creating FFTW Plan";
     TSFFTW_set_timelimit(60);
 
+    CLOG(INFO, "LOGGER_SYS") << "Setting Rigour of Creating FFTW Plans";
+    FFT::setPlanRigour(para.fftwRigour);
+
+    if (para.fftwWisdom[0] != '\0')
+    {
+        CLOG(INFO, "LOGGER_SYS") << "Importing FFTW Wisdom from " << para.fftwWisdom;
+
+        if (!FFT::importWisdom(para.fftwWisdom))
+            CLOG(WARNING, "LOGGER_SYS") << "Fail to Import FFTW Wisdom from " << para.fftwWisdom;
+    }
+
     CLOG(INFO, "LOGGER_SYS") << "Setting Parameters";
     
     Optimiser opt;
@@ -264,8 +336,20 @@ int main(int argc, char* argv[])
         
     }
 
+    // the master barely performs Fourier transforms, thus a slave exports
+
+    if ((rank == GSL_MIN_INT(1, commSize - 1)) && (para.fftwWisdom[0] != '\0'))
+    {
+        CLOG(INFO, "LOGGER_SYS") << "Exporting FFTW Wisdom to " << para.fftwWisdom;
+
+        if (!FFT::exportWisdom(para.fftwWisdom))
+            CLOG(WARNING, "LOGGER_SYS") << "Fail to Export FFTW Wisdom to " << para.fftwWisdom;
+    }
+
     MPI_Finalize();
 
+    FFT::destroyPlans();
+
     TSFFTW_cleanup_threads();
 
     return 0;
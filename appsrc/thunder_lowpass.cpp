@@ -43,6 +43,8 @@ int main(int argc, char* argv[])
 
     imf.writeVolume(argv[1], ref, atof(argv[4]));
 
+    FFT::destroyPlans();
+
     TSFFTW_cleanup_threads();
 
     return 0;
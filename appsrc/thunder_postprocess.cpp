@@ -27,6 +27,8 @@ int main(int argc, char* argv[])
 
     pp.run();
 
+    FFT::destroyPlans();
+
     TSFFTW_cleanup_threads();
 
     return 0;
@@ -11,25 +11,64 @@
 #ifndef COMPLEX_H
 #define COMPLEX_H
 
+#include <cmath>
+
 #include <gsl/gsl_complex.h>
 #include <gsl/gsl_complex_math.h>
 
 #include "Typedef.h"
 
-#define CONJUGATE(a) gsl_complex_conjugate(a)
+/**
+ * The arithmetic of Complex is implemented inline on the layout of gsl_complex
+ * rather than by calling the out-of-line functions of GSL, so that loops over
+ * complex numbers can be inlined and vectorised by the compiler. The results
+ * are identical to those of the corresponding GSL functions.
+ */
+
+#define CONJUGATE(a) complexConj(a)
 
-#define ABS(a) gsl_complex_abs(a)
+#define ABS(a) complexAbs(a)
 
-#define ABS2(a) gsl_complex_abs2(a)
+#define ABS2(a) complexAbs2(a)
 
-#define COMPLEX_POLAR(phi) gsl_complex_polar(1, phi)
+#define COMPLEX_POLAR(phi) complexPolar(phi)
 
-#define COMPLEX(a, b) gsl_complex_rect(a, b)
+#define COMPLEX(a, b) complexRect(a, b)
 
 #define REAL(a) GSL_REAL(a)
 
 #define IMAG(a) GSL_IMAG(a)
 
+inline Complex complexRect(const RFLOAT a, const RFLOAT b)
+{
+    Complex z;
+
+    z.dat[0] = a;
+    z.dat[1] = b;
+
+    return z;
+};
+
+inline Complex complexPolar(const RFLOAT phi)
+{
+    return complexRect(cos(phi), sin(phi));
+};
+
+inline Complex complexConj(const Complex a)
+{
+    return complexRect(REAL(a), -IMAG(a));
+};
+
+inline RFLOAT complexAbs2(const Complex a)
+{
+    return REAL(a) * REAL(a) + IMAG(a) * IMAG(a);
+};
+
+inline RFLOAT complexAbs(const Complex a)
+{
+    return hypot(REAL(a), IMAG(a));
+};
+
 inline RFLOAT gsl_real(const Complex a)
 {
     return REAL(a);
@@ -52,22 +91,31 @@ inline Complex operator-(const Complex a)
 
 inline Complex operator+(const Complex a, const Complex b)
 {
-    return gsl_complex_add(a, b);
+    return COMPLEX(REAL(a) + REAL(b), IMAG(a) + IMAG(b));
 };
 
 inline Complex operator-(const Complex a, const Complex b)
 {
-    return gsl_complex_sub(a, b);
+    return COMPLEX(REAL(a) - REAL(b), IMAG(a) - IMAG(b));
 };
 
 inline Complex operator*(const Complex a, const Complex b)
 {
-    return gsl_complex_mul(a, b);
+    return COMPLEX(REAL(a) * REAL(b) - IMAG(a) * IMAG(b),
+                   REAL(a) * IMAG(b) + IMAG(a) * REAL(b));
 };
 
 inline Complex operator/(const Complex a, const Complex b)
 {
-    return gsl_complex_div(a, b);
+    // scaled as gsl_complex_div for avoiding overflow
+
+    RFLOAT s = 1.0 / ABS(b);
+
+    RFLOAT sbr = s * REAL(b);
+    RFLOAT sbi = s * IMAG(b);
+
+    return COMPLEX((REAL(a) * sbr + IMAG(a) * sbi) * s,
+                   (IMAG(a) * sbr - REAL(a) * sbi) * s);
 };
 
 inline void operator+=(Complex& a, const Complex b) { a = a + b; };
@@ -80,7 +128,7 @@ inline void operator/=(Complex& a, const Complex b) { a = a / b; };
 
 inline Complex operator*(const Complex a, const RFLOAT x)
 {
-    return gsl_complex_mul_real(a, x);
+    return COMPLEX(REAL(a) * x, IMAG(a) * x);
 };
 
 inline Complex operator*(const RFLOAT x, const Complex a)
@@ -92,9 +140,38 @@ inline void operator*=(Complex& a, const RFLOAT x) { a = a * x; };
 
 inline Complex operator/(const Complex a, const RFLOAT x)
 {
-    return gsl_complex_div_real(a, x);
+    return COMPLEX(REAL(a) / x, IMAG(a) / x);
 };
 
 inline void operator/=(Complex& a, const RFLOAT x) { a = a / x; };
 
+/**
+ * single precision complex, used for storing and scoring in expectation
+ */
+
+inline ComplexF COMPLEX_F(const float a, const float b)
+{
+    ComplexF z;
+
+    z.dat[0] = a;
+    z.dat[1] = b;
+
+    return z;
+};
+
+inline ComplexF complexF(const Complex a)
+{
+    return COMPLEX_F(REAL(a), IMAG(a));
+};
+
+inline Complex complexD(const ComplexF a)
+{
+    return COMPLEX(REAL(a), IMAG(a));
+};
+
+inline Complex complexD(const Complex a)
+{
+    return a;
+};
+
 #endif // COMPLEX_H
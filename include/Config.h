@@ -81,6 +81,8 @@
 
 #define PROJECTOR_CORRECT_CONVOLUTION_KERNEL
 
+//#define PROJECTOR_BRICK
+
 #define MODEL_AVERAGE_TWO_HEMISPHERE
 
 #ifndef MODEL_AVERAGE_TWO_HEMISPHERE
@@ -97,8 +99,14 @@
 
 #define MODEL_RECONSTRUCTOR_RESIZE
 
+#define MODEL_PROJECTOR_RESIZE
+
 #define OPTIMISER_PARTICLE_FILTER
 
+#define OPTIMISER_GLOBAL_SEARCH_GEMM
+
+//#define OPTIMISER_E_STEP_SINGLE_PRECISION
+
 //#define OPTIMISER_NORM_CORRECTION
 
 #define OPTIMISER_REFRESH_SIGMA
@@ -55,23 +55,16 @@
 }
 
 /**
- * This macro destroys the plan for performing Fourier transform and assigns
- * the pointers to NULL.
+ * This macro assigns the pointers to NULL after performing Fourier transform.
+ * The plan is kept in the plan cache for the following transforms.
  */
 #define FW_CLEAN_UP \
 { \
-    _Pragma("omp critical"); \
-    fftw_destroy_plan(fwPlan); \
     _dstC = NULL; \
     _srcR = NULL; \
 }
 
-#define FW_CLEAN_UP_MT \
-{ \
-    fftw_destroy_plan(fwPlan); \
-    _dstC = NULL; \
-    _srcR = NULL; \
-}
+#define FW_CLEAN_UP_MT FW_CLEAN_UP
 
 /**
  * This macro destroys the plan for performing multi-thread Fourier transform 
@@ -95,28 +88,20 @@
 }
 
 /**
- * This macro destroys the plan for performing inverse Fourier transform,
- * assigns the pointers to NULL and clear up the Fourier space of the image
- * (volume).
+ * This macro assigns the pointers to NULL and clear up the Fourier space of the
+ * image (volume) after performing inverse Fourier transform. The plan is kept
+ * in the plan cache for the following transforms.
  *
  * @param obj the image (volume) performed inverse Fourier transform.
  */
 #define BW_CLEAN_UP(obj) \
 { \
-    _Pragma("omp critical"); \
-    fftw_destroy_plan(bwPlan); \
     _dstR = NULL; \
     _srcC = NULL; \
     obj.clearFT(); \
 }
 
-#define BW_CLEAN_UP_MT(obj) \
-{ \
-    fftw_destroy_plan(bwPlan); \
-    _dstR = NULL; \
-    _srcC = NULL; \
-    obj.clearFT(); \
-}
+#define BW_CLEAN_UP_MT(obj) BW_CLEAN_UP(obj)
 
 /**
  * This macro destroys the plan for performing multi-threaded inverse Fourier 
@@ -386,6 +371,19 @@ class FFT
 
         void bwExecutePlanMT(Volume& vol);
 
+        /**
+         * This function performs inverse Fourier transform by the plan from a
+         * half spectrum to an array in real space, which are both aligned and
+         * of the size the plan is created for. Neither array is allocated or
+         * freed, the half spectrum is destroyed, and the result is not
+         * normalised.
+         *
+         * @param src the half spectrum
+         * @param dst the array in real space
+         */
+        void bwExecutePlan(Complex* src,
+                           RFLOAT* dst);
+
         void fwDestroyPlan();
 
         void bwDestroyPlan();
@@ -393,6 +391,38 @@ class FFT
         void fwDestroyPlanMT();
 
         void bwDestroyPlanMT();
+
+        /**
+         * This function sets the rigour of creating plans, FFTW_ESTIMATE,
+         * FFTW_MEASURE or FFTW_PATIENT. The plans created by fwCreatePlan and
+         * bwCreatePlan are at least measured. It shall be called before any
+         * transform.
+         *
+         * @param rigour the rigour of creating plans
+         */
+        static void setPlanRigour(const unsigned rigour);
+
+        /**
+         * This function imports the wisdom of FFTW from a file, returning
+         * whether the import succeeds.
+         *
+         * @param filename the file of wisdom
+         */
+        static bool importWisdom(const char* filename);
+
+        /**
+         * This function exports the wisdom of FFTW to a file, returning whether
+         * the export succeeds.
+         *
+         * @param filename the file of wisdom
+         */
+        static bool exportWisdom(const char* filename);
+
+        /**
+         * This function destroys all the plans in the plan cache. It shall be
+         * called before cleaning up the threads of FFTW.
+         */
+        static void destroyPlans();
 };
 
 #endif // FFT_H 
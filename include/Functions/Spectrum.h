@@ -21,6 +21,7 @@
 
 #include "Image.h"
 #include "Volume.h"
+#include "RealHalfVolume.h"
 #include "Filter.h"
 
 /**
@@ -105,6 +106,18 @@ void ringAverage(vec& dst,
                  const function<RFLOAT(const Complex)> func,
                  const int r);
 
+/**
+ * This function calculates the ring averages of a real image of half spectrum
+ * within a given radius.
+ *
+ * @param dst the ring averages
+ * @param src the image, of one slice
+ * @param r   the radius
+ */
+void ringAverage(vec& dst,
+                 const RealHalfVolume& src,
+                 const int r);
+
 /**
  * This function calculates the shell average at a certain resolution with a
  * given function.
@@ -123,6 +136,18 @@ void shellAverage(vec& dst,
                   const function<RFLOAT(const Complex)> func,
                   const int r);
 
+/**
+ * This function calculates the shell averages of a real volume of half
+ * spectrum within a given radius.
+ *
+ * @param dst the shell averages
+ * @param src the volume
+ * @param r   the radius
+ */
+void shellAverage(vec& dst,
+                  const RealHalfVolume& src,
+                  const int r);
+
 /**
  * This function calculates the power spectrum of a certain image within a
  * given spatial frequency.
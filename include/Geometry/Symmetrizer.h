@@ -0,0 +1,222 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependency:
+ * Test:
+ * Execution:
+ * Description: symmetrizing a volume cropped to a sphere in Fourier space by
+ *              precomputed interpolation stencils
+ *
+ * Manual:
+ * ****************************************************************************/
+
+#ifndef SYMMETRIZER_H
+#define SYMMETRIZER_H
+
+#include <cstddef>
+#include <cstring>
+
+#include "omp_compat.h"
+
+#include "Config.h"
+#include "Macro.h"
+#include "Typedef.h"
+#include "Logging.h"
+
+#include "Functions.h"
+
+#include "RealHalfVolume.h"
+#include "SphereVolume.h"
+
+#include "Symmetry.h"
+
+/**
+ * the interpolation stencil of a voxel under a symmetry element
+ */
+struct SymmetryStencil
+{
+    /**
+     * the index in the storage of the first voxel of the cell in each of the
+     * four rows of the cell, row (j, k) at j + 2 * k
+     */
+    size_t index[4];
+
+    /**
+     * the fractional part of the rotated coordinate, the weights of trilinear
+     * interpolation
+     */
+    RFLOAT xd[3];
+
+    /**
+     * whether the voxel of the cell at (i, j, k) is inside the sphere, at bit
+     * i + 2 * j + 4 * k
+     */
+    unsigned char mask;
+
+    /**
+     * whether the rotated coordinate falls in the other half of the spectrum
+     */
+    bool conj;
+
+    /**
+     * whether the rotated coordinate is inside the radius of symmetrizing
+     */
+    bool valid;
+};
+
+/**
+ * Symmetrizing a volume adds, on each voxel, the value at the coordinate
+ * rotated by each symmetry element. The rotated coordinates and the cells of
+ * interpolation only depend on the symmetry, the size and the radius, which
+ * stay the same through iterations. A Symmetrizer computes these stencils once
+ * and keeps them, as long as they fit in the memory given, and applies all
+ * symmetry elements in one pass over the volume. When the stencils do not fit
+ * in, they are computed on the fly in the same pass.
+ *
+ * The result is the same as SYMMETRIZE_FT, which sums up the symmetry elements
+ * in the same order.
+ */
+class Symmetrizer
+{
+    private:
+
+        /**
+         * the symmetry of which the stencils are prepared, identified by its
+         * address, its point group and its order
+         */
+        const Symmetry* _sym;
+
+        int _pgGroup;
+
+        int _pgOrder;
+
+        int _nSymmetryElement;
+
+        /**
+         * rotation matrices of the symmetry elements
+         */
+        vector<mat33> _R;
+
+        int _nCol;
+
+        int _nRow;
+
+        int _nSlc;
+
+        /**
+         * radius of the sphere of the volume
+         */
+        int _sphere;
+
+        /**
+         * radius of symmetrizing
+         */
+        RFLOAT _r;
+
+        /**
+         * whether the stencils are cached
+         */
+        bool _cached;
+
+        /**
+         * the number of voxels symmetrized in each row, the leading voxels of
+         * the row
+         */
+        vector<int> _nVoxel;
+
+        /**
+         * the index of the first voxel symmetrized of each row in the stencils
+         */
+        vector<size_t> _voxelOffset;
+
+        /**
+         * stencils of each voxel symmetrized and each symmetry element
+         */
+        vector<SymmetryStencil> _stencil;
+
+        Symmetrizer(const Symmetrizer&);
+
+        Symmetrizer& operator=(const Symmetrizer&);
+
+    public:
+
+        Symmetrizer();
+
+        void clear();
+
+        bool cached() const { return _cached; };
+
+        /**
+         * This function returns the memory taken by the cached stencils (byte).
+         */
+        size_t memory() const { return _stencil.capacity() * sizeof(SymmetryStencil); };
+
+        /**
+         * This function prepares the stencils for a symmetry, a volume and a
+         * radius, which are kept when they are the same as the last call.
+         *
+         * @param sym    the symmetry
+         * @param index  the index of the volume
+         * @param nCol   number of columns in real space of the volume
+         * @param nRow   number of rows in real space of the volume
+         * @param nSlc   number of slices in real space of the volume
+         * @param r      the radius of symmetrizing
+         * @param memory the memory which can be used for caching the stencils
+         *               (byte)
+         */
+        void init(const Symmetry& sym,
+                  const SphereIndex& index,
+                  const int nCol,
+                  const int nRow,
+                  const int nSlc,
+                  const RFLOAT r,
+                  const size_t memory);
+
+        /**
+         * This function symmetrizes a volume by trilinear interpolation. The
+         * volume should be of the size and the sphere given to init().
+         *
+         * @param dst the symmetrized volume
+         * @param src the volume
+         */
+        void apply(SphereVolume& dst,
+                   const SphereVolume& src) const;
+
+        /**
+         * This function symmetrizes a real volume by trilinear interpolation.
+         * The volume should be of the size and the sphere given to init().
+         *
+         * @param dst the symmetrized volume
+         * @param src the volume
+         */
+        void apply(RealHalfVolume& dst,
+                   const RealHalfVolume& src) const;
+
+    private:
+
+        /**
+         * This function computes the stencil of the voxel (i, j, k) under the
+         * symmetry element l.
+         */
+        void stencil(SymmetryStencil& dst,
+                     const SphereIndex& index,
+                     const int l,
+                     const int i,
+                     const int j,
+                     const int k) const;
+
+        /**
+         * This function returns the number of voxels symmetrized in a row of
+         * a volume, the voxels from column 0 within the radius of symmetrizing.
+         */
+        int nVoxel(const SphereIndex& index,
+                   const size_t row) const;
+
+        template <typename T>
+        void symmetrize(T* dst,
+                        const T* src,
+                        const SphereIndex& index) const;
+};
+
+#endif // SYMMETRIZER_H
@@ -26,6 +26,8 @@
 
 #include "Image.h"
 #include "Volume.h"
+#include "RealHalfVolume.h"
+#include "SphereVolume.h"
 
 #include "Symmetry.h"
 
@@ -129,4 +131,76 @@ inline void SYMMETRIZE_FT(Volume& dst,
     dst.swap(result);
 }
 
+inline void SYMMETRIZE_FT(RealHalfVolume& dst,
+                          const RealHalfVolume& src,
+                          const Symmetry& sym,
+                          const RFLOAT r)
+{
+    RealHalfVolume result(src.nColRL(), src.nRowRL(), src.nSlcRL(), src.radius());
+
+    #pragma omp parallel for
+    FOR_EACH_PIXEL_FT(result)
+        result[i] = src[i];
+
+    mat33 L, R;
+
+    for (int l = 0; l < sym.nSymmetryElement(); l++)
+    {
+        sym.get(L, R, l);
+
+        #pragma omp parallel for schedule(dynamic)
+        VOLUME_FOR_EACH_PIXEL_FT(result)
+        {
+            vec3 newCor((RFLOAT)i, (RFLOAT)j, (RFLOAT)k);
+            vec3 oldCor = R * newCor;
+
+            if ((oldCor.squaredNorm() < gsl_pow_2(r)) &&
+                result.inside(i, j, k))
+                result[result.iFTHalf(i, j, k)] += src.getByInterpolationFT(oldCor(0),
+                                                                            oldCor(1),
+                                                                            oldCor(2));
+        }
+    }
+
+    #pragma omp parallel for
+    FOR_EACH_PIXEL_FT(dst)
+        dst[i] = result[i];
+}
+
+inline void SYMMETRIZE_FT(SphereVolume& dst,
+                          const SphereVolume& src,
+                          const Symmetry& sym,
+                          const RFLOAT r,
+                          const int interp)
+{
+    SphereVolume result(src.nColRL(), src.nRowRL(), src.nSlcRL(), src.radius());
+
+    #pragma omp parallel for
+    FOR_EACH_PIXEL_FT(result)
+        result[i] = src[i];
+
+    mat33 L, R;
+
+    for (int l = 0; l < sym.nSymmetryElement(); l++)
+    {
+        sym.get(L, R, l);
+
+        #pragma omp parallel for schedule(dynamic)
+        VOLUME_FOR_EACH_PIXEL_FT(result)
+        {
+            vec3 newCor((RFLOAT)i, (RFLOAT)j, (RFLOAT)k);
+            vec3 oldCor = R * newCor;
+
+            if ((oldCor.squaredNorm() < gsl_pow_2(r)) &&
+                result.inside(i, j, k))
+                result[result.iFTHalf(i, j, k)] += src.getByInterpolationFT(oldCor(0),
+                                                                            oldCor(1),
+                                                                            oldCor(2),
+                                                                            interp);
+        }
+    }
+
+    dst.swap(result);
+}
+
 #endif // TRANSFORMATION_H
@@ -359,6 +359,64 @@ void translate(Complex* dst,
                const int* iRow,
                const int nPxl);
 
+/**
+ * This function generates the phase shift of a translation on given pixels,
+ * storing the real and imaginary part in separate arrays.
+ */
+void translate(RFLOAT* dstRe,
+               RFLOAT* dstIm,
+               const RFLOAT nTransCol,
+               const RFLOAT nTransRow,
+               const int nCol,
+               const int nRow,
+               const int* iCol,
+               const int* iRow,
+               const int nPxl);
+
+void translate(float* dstRe,
+               float* dstIm,
+               const RFLOAT nTransCol,
+               const RFLOAT nTransRow,
+               const int nCol,
+               const int nRow,
+               const int* iCol,
+               const int* iRow,
+               const int nPxl);
+
+/**
+ * This function generates the phase shifts of a set of translations on given
+ * pixels, storing the real and imaginary part in separate arrays, one
+ * translation after another. Sine and cosine are only evaluated on the 1-D
+ * phase vectors of columns and rows of each translation, and the phase shift
+ * of each pixel is assembled by one complex multiplication.
+ *
+ * @param dstRe the real part of the phase shifts (nT * nPxl)
+ * @param dstIm the imaginary part of the phase shifts (nT * nPxl)
+ * @param tra   the translations, one translation per row
+ * @param nCol  number of columns of the image
+ * @param nRow  number of rows of the image
+ * @param iCol  the column index of each pixel
+ * @param iRow  the row index of each pixel
+ * @param nPxl  number of pixels
+ */
+void translate(RFLOAT* dstRe,
+               RFLOAT* dstIm,
+               const mat2& tra,
+               const int nCol,
+               const int nRow,
+               const int* iCol,
+               const int* iRow,
+               const int nPxl);
+
+void translate(float* dstRe,
+               float* dstIm,
+               const mat2& tra,
+               const int nCol,
+               const int nRow,
+               const int* iCol,
+               const int* iRow,
+               const int nPxl);
+
 void translateMT(Complex* dst,
                  const RFLOAT nTransCol,
                  const RFLOAT nTransRow,
@@ -0,0 +1,225 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependency:
+ * Test:
+ * Execution:
+ * Description: a real-valued volume in Fourier space, of which only the half
+ *              spectrum is stored
+ *
+ * Manual:
+ * ****************************************************************************/
+
+#ifndef REAL_HALF_VOLUME_H
+#define REAL_HALF_VOLUME_H
+
+#include "omp_compat.h"
+
+#include "Config.h"
+#include "Macro.h"
+#include "Typedef.h"
+#include "Logging.h"
+
+#include "Volume.h"
+#include "SphereIndex.h"
+
+/**
+ * A volume in Fourier space which is real and even, such as the weights of
+ * reconstruction, stores one real number per voxel of the half spectrum, in
+ * the same layout as the Fourier space of Volume. As the value at -k equals
+ * the value at k, no conjugation is needed. An image is a volume of one slice.
+ * It may be cropped to a sphere in the same way as SphereVolume, where reading
+ * a voxel outside the sphere returns 0 and writing one is ignored.
+ */
+class RealHalfVolume
+{
+    private:
+
+        RFLOAT* _data;
+
+        /**
+         * whether the data is allocated by the volume, or attached from a
+         * buffer owned by others, such as memory shared by processes
+         */
+        bool _own;
+
+        SphereIndex _index;
+
+        int _nCol;
+
+        int _nRow;
+
+        int _nSlc;
+
+        RealHalfVolume(const RealHalfVolume&);
+
+        RealHalfVolume& operator=(const RealHalfVolume&);
+
+    public:
+
+        RealHalfVolume();
+
+        /**
+         * @param nCol number of columns in real space
+         * @param nRow number of rows in real space
+         * @param nSlc number of slices in real space, 1 for an image
+         * @param r    radius of the sphere, negative for no cropping
+         */
+        RealHalfVolume(const int nCol,
+                       const int nRow,
+                       const int nSlc,
+                       const int r = -1);
+
+        ~RealHalfVolume();
+
+        void swap(RealHalfVolume& that);
+
+        void alloc(const int nCol,
+                   const int nRow,
+                   const int nSlc,
+                   const int r = -1);
+
+        /**
+         * This function makes the volume work on a buffer owned by others,
+         * which is not freed by the volume. The buffer should hold sizeFT()
+         * elements of the volume of the size and the sphere given.
+         *
+         * @param data the buffer
+         * @param nCol number of columns in real space
+         * @param nRow number of rows in real space
+         * @param nSlc number of slices in real space
+         * @param r    radius of the sphere, negative for no cropping
+         */
+        void attach(RFLOAT* data,
+                    const int nCol,
+                    const int nRow,
+                    const int nSlc,
+                    const int r = -1);
+
+        void clear();
+
+        bool isEmptyFT() const { return _data == NULL; };
+
+        bool own() const { return _own; };
+
+        int nColRL() const { return _nCol; };
+
+        int nRowRL() const { return _nRow; };
+
+        int nSlcRL() const { return _nSlc; };
+
+        int radius() const { return _index.radius(); };
+
+        size_t sizeFT() const { return _index.size(); };
+
+        const SphereIndex& index() const { return _index; };
+
+        inline RFLOAT& operator[](const size_t i)
+        {
+            return _data[i];
+        };
+
+        inline const RFLOAT& operator[](const size_t i) const
+        {
+            return _data[i];
+        };
+
+        inline bool inside(const int i,
+                           const int j,
+                           const int k = 0) const
+        {
+            return _index.inside(i, j, k);
+        }
+
+        /**
+         * This function returns the index of a voxel of the half spectrum,
+         * which should be inside the sphere.
+         */
+        inline size_t iFTHalf(const int i,
+                              const int j,
+                              const int k = 0) const
+        {
+            return _index.index(i, j, k);
+        }
+
+        inline RFLOAT getFTHalf(const int iCol,
+                                const int iRow,
+                                const int iSlc = 0) const
+        {
+            return _index.inside(iCol, iRow, iSlc)
+                 ? _data[_index.index(iCol, iRow, iSlc)]
+                 : 0;
+        }
+
+        inline void setFTHalf(const RFLOAT value,
+                              const int iCol,
+                              const int iRow,
+                              const int iSlc = 0)
+        {
+            if (_index.inside(iCol, iRow, iSlc))
+                _data[_index.index(iCol, iRow, iSlc)] = value;
+        }
+
+        inline RFLOAT getFT(const int iCol,
+                            const int iRow,
+                            const int iSlc = 0) const
+        {
+            return (iCol >= 0) ? getFTHalf(iCol, iRow, iSlc)
+                               : getFTHalf(-iCol, -iRow, -iSlc);
+        }
+
+        /**
+         * This function adds a value on a voxel atomically.
+         */
+        void addFT(const RFLOAT value,
+                   const int iCol,
+                   const int iRow,
+                   const int iSlc);
+
+        /**
+         * This function adds a value at an unregular voxel by trilinear
+         * interpolation, or bilinear interpolation in an image, atomically.
+         *
+         * @param value the value
+         * @param iCol  the index of the column
+         * @param iRow  the index of the row
+         * @param iSlc  the index of the slice, 0 in an image
+         */
+        void addFT(const RFLOAT value,
+                   RFLOAT iCol,
+                   RFLOAT iRow,
+                   RFLOAT iSlc = 0);
+
+        /**
+         * This function adds a value at an unregular voxel by a kernel of
+         * certain radius, atomically.
+         *
+         * @param value  the value
+         * @param iCol   the index of the column
+         * @param iRow   the index of the row
+         * @param iSlc   the index of the slice
+         * @param a      the radius of the kernel
+         * @param kernel the kernel, as a function of the square of distance
+         */
+        void addFT(const RFLOAT value,
+                   const RFLOAT iCol,
+                   const RFLOAT iRow,
+                   const RFLOAT iSlc,
+                   const RFLOAT a,
+                   const TabFunction& kernel);
+
+        /**
+         * This function returns the value at an unregular voxel by trilinear
+         * interpolation.
+         *
+         * @param iCol the index of the column
+         * @param iRow the index of the row
+         * @param iSlc the index of the slice
+         */
+        RFLOAT getByInterpolationFT(RFLOAT iCol,
+                                    RFLOAT iRow,
+                                    RFLOAT iSlc) const;
+};
+
+#endif // REAL_HALF_VOLUME_H
@@ -0,0 +1,226 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependency:
+ * Test:
+ * Execution:
+ * Description: an index of the half spectrum of a volume, keeping only the
+ *              voxels inside a sphere
+ *
+ * Manual:
+ * ****************************************************************************/
+
+#ifndef SPHERE_INDEX_H
+#define SPHERE_INDEX_H
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+#include "Config.h"
+#include "Macro.h"
+#include "Typedef.h"
+#include "Logging.h"
+
+/**
+ * the edge of a brick is 2^SPHERE_INDEX_BRICK_SHIFT voxels
+ */
+#define SPHERE_INDEX_BRICK_SHIFT 2
+
+#define SPHERE_INDEX_BRICK_EDGE (1 << SPHERE_INDEX_BRICK_SHIFT)
+
+#define SPHERE_INDEX_BRICK_MASK (SPHERE_INDEX_BRICK_EDGE - 1)
+
+#define SPHERE_INDEX_BRICK_SIZE (SPHERE_INDEX_BRICK_EDGE * SPHERE_INDEX_BRICK_EDGE * SPHERE_INDEX_BRICK_EDGE)
+
+/**
+ * the offset of a brick which is not stored, as it is outside the sphere
+ */
+#define SPHERE_INDEX_NO_BRICK ((size_t)-1)
+
+/**
+ * The half spectrum of a volume is made of rows along the column axis, one
+ * row per (iRow, iSlc). Cropping the half spectrum to a sphere of radius r
+ * keeps the voxels of column 0 to column sqrt(r^2 - iRow^2 - iSlc^2) of each
+ * row, which are stored contiguously. This index records the offset and the
+ * length of each row. A negative radius keeps the whole half spectrum, in the
+ * same layout as the Fourier space of Volume.
+ *
+ * Optionally, the voxels are stored in bricks of SPHERE_INDEX_BRICK_EDGE^3
+ * voxels instead, the bricks touching the sphere only, and the voxels of a
+ * brick contiguously. The rows and the slices are ordered by frequency, from
+ * -N / 2 to N / 2 - 1, so that the voxels close in Fourier space are close in
+ * the storage, and the cell of trilinear interpolation is mostly in a single
+ * brick. The voxels of the bricks outside the sphere are kept 0. This layout
+ * is meant for volumes which are read by interpolation, such as projectees,
+ * and offset() of a row is only valid in the row layout.
+ */
+class SphereIndex
+{
+    private:
+
+        int _nRow;
+
+        int _nSlc;
+
+        int _nColFT;
+
+        int _r;
+
+        /**
+         * offset of each row in the storage
+         */
+        size_t* _offset;
+
+        /**
+         * number of voxels of each row in the storage
+         */
+        int* _len;
+
+        size_t _size;
+
+        /**
+         * whether the voxels are stored in bricks
+         */
+        bool _brick;
+
+        int _nBrickCol;
+
+        int _nBrickRow;
+
+        int _nBrickSlc;
+
+        /**
+         * offset of each brick in the storage, SPHERE_INDEX_NO_BRICK for a
+         * brick not stored
+         */
+        size_t* _brickOffset;
+
+        /**
+         * the part of the index of the brick, and of the index of the voxel
+         * in the brick, given by the row or the slice, of which the frequency
+         * is signed or wrapped, looked up at the frequency plus the number of
+         * rows or slices
+         */
+        size_t* _rowBrick;
+
+        int* _rowVoxel;
+
+        size_t* _slcBrick;
+
+        int* _slcVoxel;
+
+        SphereIndex(const SphereIndex&);
+
+        SphereIndex& operator=(const SphereIndex&);
+
+    public:
+
+        SphereIndex();
+
+        ~SphereIndex();
+
+        /**
+         * @param nCol  number of columns in real space
+         * @param nRow  number of rows in real space
+         * @param nSlc  number of slices in real space, 1 for an image
+         * @param r     radius of the sphere, negative for no cropping
+         * @param brick whether the voxels are stored in bricks
+         */
+        void alloc(const int nCol,
+                   const int nRow,
+                   const int nSlc,
+                   const int r,
+                   const bool brick = false);
+
+        void clear();
+
+        void swap(SphereIndex& that);
+
+        bool isEmpty() const { return _offset == NULL; };
+
+        int radius() const { return _r; };
+
+        bool brick() const { return _brick; };
+
+        /**
+         * number of voxels inside the sphere
+         */
+        size_t size() const { return _size; };
+
+        size_t nRowFT() const { return (size_t)_nRow * _nSlc; };
+
+        inline size_t iRowFT(const int j,
+                             const int k) const
+        {
+            return (size_t)(k >= 0 ? k : k + _nSlc) * _nRow
+                 + (j >= 0 ? j : j + _nRow);
+        }
+
+        inline size_t offset(const size_t row) const { return _offset[row]; };
+
+        inline int len(const size_t row) const { return _len[row]; };
+
+        /**
+         * This function returns whether a voxel of the half spectrum, of which
+         * the column index is non-negative, is inside the sphere.
+         */
+        inline bool inside(const int i,
+                           const int j,
+                           const int k = 0) const
+        {
+            return i < _len[iRowFT(j, k)];
+        }
+
+        /**
+         * This function returns the index of a voxel of the half spectrum in
+         * the storage. The voxel should be inside the sphere.
+         */
+        inline size_t index(const int i,
+                            const int j,
+                            const int k = 0) const
+        {
+            if (_brick)
+                return _brickOffset[iBrick(i, j, k)] + iInBrick(i, j, k);
+            else
+                return _offset[iRowFT(j, k)] + i;
+        }
+
+        /**
+         * This function returns the index of the brick of a voxel, of which
+         * the frequency of the row and the slice is signed or wrapped.
+         */
+        inline size_t iBrick(const int i,
+                             const int j,
+                             const int k) const
+        {
+            return (i >> SPHERE_INDEX_BRICK_SHIFT)
+                 + _rowBrick[j + _nRow]
+                 + _slcBrick[k + _nSlc];
+        }
+
+        /**
+         * This function returns the index of a voxel in its brick, of which
+         * the frequency of the row and the slice is signed or wrapped.
+         */
+        inline int iInBrick(const int i,
+                            const int j,
+                            const int k) const
+        {
+            return (i & SPHERE_INDEX_BRICK_MASK)
+                 + _rowVoxel[j + _nRow]
+                 + _slcVoxel[k + _nSlc];
+        }
+
+        /**
+         * This function returns the offset of a brick in the storage, or
+         * SPHERE_INDEX_NO_BRICK for a brick not stored.
+         */
+        inline size_t brickOffset(const size_t b) const
+        {
+            return _brickOffset[b];
+        }
+};
+
+#endif // SPHERE_INDEX_H
@@ -0,0 +1,271 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependency:
+ * Test:
+ * Execution:
+ * Description: a complex volume in Fourier space, of which only the half
+ *              spectrum inside a sphere is stored
+ *
+ * Manual:
+ * ****************************************************************************/
+
+#ifndef SPHERE_VOLUME_H
+#define SPHERE_VOLUME_H
+
+#include <cstring>
+
+#include "omp_compat.h"
+
+#include "Config.h"
+#include "Macro.h"
+#include "Complex.h"
+#include "Typedef.h"
+#include "Logging.h"
+
+#include "Volume.h"
+#include "SphereIndex.h"
+
+/**
+ * Inserting into a reconstructor and projecting from a projector only touch
+ * the voxels below a certain frequency, about a half of the padded cube. A
+ * SphereVolume stores the half spectrum of a volume inside a sphere, row by
+ * row, as indexed by SphereIndex. Reading a voxel outside the sphere returns
+ * 0, while writing a voxel outside the sphere is ignored. A volume stored in
+ * bricks, as indexed by SphereIndex, is meant to be read by interpolation, and
+ * is not added to by addFT() of an unregular voxel.
+ */
+class SphereVolume
+{
+    private:
+
+        Complex* _data;
+
+        /**
+         * whether the data is allocated by the volume, or attached from a
+         * buffer owned by others, such as memory shared by processes
+         */
+        bool _own;
+
+        SphereIndex _index;
+
+        int _nCol;
+
+        int _nRow;
+
+        int _nSlc;
+
+        SphereVolume(const SphereVolume&);
+
+        SphereVolume& operator=(const SphereVolume&);
+
+        /**
+         * This function returns the value of a cell of trilinear
+         * interpolation in a volume stored in bricks.
+         *
+         * @param w  the weights of the voxels of the cell
+         * @param x0 the indices of the first voxel of the cell
+         */
+        Complex getBrickFT(const RFLOAT w[2][2][2],
+                           const int x0[3]) const;
+
+    public:
+
+        SphereVolume();
+
+        /**
+         * @param nCol number of columns in real space
+         * @param nRow number of rows in real space
+         * @param nSlc number of slices in real space
+         * @param r    radius of the sphere, negative for no cropping
+         */
+        SphereVolume(const int nCol,
+                     const int nRow,
+                     const int nSlc,
+                     const int r);
+
+        ~SphereVolume();
+
+        void swap(SphereVolume& that);
+
+        /**
+         * @param nCol  number of columns in real space
+         * @param nRow  number of rows in real space
+         * @param nSlc  number of slices in real space
+         * @param r     radius of the sphere, negative for no cropping
+         * @param brick whether the voxels are stored in bricks, which is
+         *              meant for volumes read by interpolation only
+         */
+        void alloc(const int nCol,
+                   const int nRow,
+                   const int nSlc,
+                   const int r,
+                   const bool brick = false);
+
+        /**
+         * This function makes the volume work on a buffer owned by others,
+         * which is not freed by the volume. The buffer should hold sizeFT()
+         * elements of the volume of the size and the sphere given.
+         *
+         * @param data  the buffer
+         * @param nCol  number of columns in real space
+         * @param nRow  number of rows in real space
+         * @param nSlc  number of slices in real space
+         * @param r     radius of the sphere, negative for no cropping
+         * @param brick whether the voxels are stored in bricks
+         */
+        void attach(Complex* data,
+                    const int nCol,
+                    const int nRow,
+                    const int nSlc,
+                    const int r,
+                    const bool brick = false);
+
+        void clear();
+
+        bool isEmptyFT() const { return _data == NULL; };
+
+        bool own() const { return _own; };
+
+        int nColRL() const { return _nCol; };
+
+        int nRowRL() const { return _nRow; };
+
+        int nSlcRL() const { return _nSlc; };
+
+        int radius() const { return _index.radius(); };
+
+        bool brick() const { return _index.brick(); };
+
+        size_t sizeFT() const { return _index.size(); };
+
+        const SphereIndex& index() const { return _index; };
+
+        inline Complex& operator[](const size_t i)
+        {
+            return _data[i];
+        };
+
+        inline const Complex& operator[](const size_t i) const
+        {
+            return _data[i];
+        };
+
+        inline bool inside(const int i,
+                           const int j,
+                           const int k) const
+        {
+            return _index.inside(i, j, k);
+        }
+
+        /**
+         * This function returns the index of a voxel of the half spectrum,
+         * which should be inside the sphere.
+         */
+        inline size_t iFTHalf(const int i,
+                              const int j,
+                              const int k) const
+        {
+            return _index.index(i, j, k);
+        }
+
+        inline Complex getFTHalf(const int iCol,
+                                 const int iRow,
+                                 const int iSlc) const
+        {
+            return _index.inside(iCol, iRow, iSlc)
+                 ? _data[_index.index(iCol, iRow, iSlc)]
+                 : COMPLEX(0, 0);
+        }
+
+        inline void setFTHalf(const Complex value,
+                              const int iCol,
+                              const int iRow,
+                              const int iSlc)
+        {
+            if (_index.inside(iCol, iRow, iSlc))
+                _data[_index.index(iCol, iRow, iSlc)] = value;
+        }
+
+        Complex getFT(int iCol,
+                      int iRow,
+                      int iSlc) const;
+
+        /**
+         * This function adds a value on a voxel atomically.
+         */
+        void addFT(const Complex value,
+                   int iCol,
+                   int iRow,
+                   int iSlc);
+
+        /**
+         * This function adds a value at an unregular voxel by trilinear
+         * interpolation, atomically.
+         *
+         * @param value the value
+         * @param iCol  the index of the column
+         * @param iRow  the index of the row
+         * @param iSlc  the index of the slice
+         */
+        void addFT(const Complex value,
+                   RFLOAT iCol,
+                   RFLOAT iRow,
+                   RFLOAT iSlc);
+
+        /**
+         * This function adds a value at an unregular voxel by a kernel of
+         * certain radius, atomically.
+         *
+         * @param value  the value
+         * @param iCol   the index of the column
+         * @param iRow   the index of the row
+         * @param iSlc   the index of the slice
+         * @param a      the radius of the kernel
+         * @param kernel the kernel, as a function of the square of distance
+         */
+        void addFT(const Complex value,
+                   const RFLOAT iCol,
+                   const RFLOAT iRow,
+                   const RFLOAT iSlc,
+                   const RFLOAT a,
+                   const TabFunction& kernel);
+
+        /**
+         * This function returns the value at an unregular voxel by
+         * interpolation.
+         *
+         * @param iCol   the index of the column
+         * @param iRow   the index of the row
+         * @param iSlc   the index of the slice
+         * @param interp the type of interpolation
+         */
+        Complex getByInterpolationFT(RFLOAT iCol,
+                                     RFLOAT iRow,
+                                     RFLOAT iSlc,
+                                     const int interp) const;
+
+        /**
+         * This function crops the Fourier space of a volume to a sphere. A
+         * volume on a buffer owned by others is filled in place, which should
+         * be of the size of the volume and the sphere given.
+         *
+         * @param src   the volume in Fourier space
+         * @param r     radius of the sphere, negative for no cropping
+         * @param brick whether the voxels are stored in bricks
+         */
+        void fromVolume(const Volume& src,
+                        const int r,
+                        const bool brick = false);
+
+        /**
+         * This function expands the sphere into the Fourier space of a volume,
+         * of which the voxels outside the sphere are 0.
+         *
+         * @param dst the volume in Fourier space
+         */
+        void toVolume(Volume& dst) const;
+};
+
+#endif // SPHERE_VOLUME_H
@@ -36,6 +36,12 @@
 
 #define SEARCH_RES_GAP_GLOBAL 10
 
+/**
+ * the margin beyond the frequency of projection kept in the references cropped
+ * for building the projectees (pixel)
+ */
+#define PROJECTOR_RESIZE_MARGIN 4
+
 #define SEARCH_TYPE_STOP -1
 
 #define SEARCH_TYPE_GLOBAL 0
@@ -305,6 +311,24 @@ class Model : public Parallel
          */
         bool _increaseR;
 
+        /**
+         * whether the projectees are shared by the processes of the
+         * hemisphere on the same node
+         */
+        bool _projNodeShared;
+
+        /**
+         * the processes of the hemisphere on the same node, which share the
+         * projectees
+         */
+        MPI_Comm _node;
+
+        /**
+         * whether the classes are spread across the processes of the
+         * hemisphere, each of which builds the projectees of its own classes
+         */
+        bool _classParallel;
+
     public:
 
         /**
@@ -346,6 +370,9 @@ class Model : public Parallel
             _sym = NULL;
             _searchType = SEARCH_TYPE_GLOBAL;
             _increaseR = false;
+            _projNodeShared = false;
+            _node = MPI_COMM_NULL;
+            _classParallel = false;
         }
 
         /**
@@ -510,6 +537,38 @@ class Model : public Parallel
          */
         Projector& proj(const int i = 0);
 
+        /**
+         * This function sets whether the projectees in 3D mode are shared by
+         * the processes of the hemisphere on the same node, which are built
+         * by one process and read by all of them. It should be called by all
+         * the processes of the hemisphere, before the projectors are
+         * refreshed.
+         *
+         * @param projNodeShared whether the projectees are shared on the node
+         */
+        void setProjNodeShared(const bool projNodeShared);
+
+        /**
+         * This function sets whether the classes are spread across the
+         * processes of the hemisphere. The projectees in 3D mode of different
+         * classes are then built by different processes at the same time, and
+         * handed to the others, which makes refreshing the projectors
+         * collective in the hemisphere.
+         *
+         * @param classParallel whether the classes are spread across the
+         *                      processes
+         */
+        void setClassParallel(const bool classParallel);
+
+        /**
+         * This function returns the rank in the hemisphere of the process
+         * which works on the l-th class when the classes are spread across the
+         * processes of the hemisphere.
+         *
+         * @param l the index of the class
+         */
+        int classOwner(const int l) const;
+
         /**
          * This function returns a reference to the reconstructor of the i-th
          * reference.
@@ -830,6 +889,40 @@ class Model : public Parallel
 #endif
 
         void avgHemi();
+
+        /**
+         * This function refreshs the projectors in 3D mode, the projectee of
+         * each class built by one process and handed to the others.
+         */
+        void refreshProjByClass();
+
+        /**
+         * This function gives the size of the references from which the
+         * projectees are built. When MODEL_PROJECTOR_RESIZE is defined, the
+         * references are cropped in Fourier space to the frequency of
+         * projection plus a margin, otherwise the size is kept.
+         */
+        int projSize() const;
+
+        /**
+         * This function extracts the reference of a class in 2D mode, cropped
+         * in Fourier space to the size of building the projectee.
+         *
+         * @param dst the destination image in Fourier space
+         * @param l   the index of the class
+         */
+        void projRef(Image& dst,
+                     const int l) const;
+
+        /**
+         * This function extracts the reference of a class in 3D mode, cropped
+         * in Fourier space to the size of building the projectee.
+         *
+         * @param dst the destination volume in Fourier space
+         * @param l   the index of the class
+         */
+        void projRef(Volume& dst,
+                     const int l) const;
 };
 
 #endif // MODEL_H
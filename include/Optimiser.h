@@ -18,6 +18,7 @@
 #include <string>
 #include <climits>
 #include <queue>
+#include <set>
 #include <functional>
 
 #include <gsl/gsl_sort.h>
@@ -40,6 +41,7 @@
 #include "Particle.h"
 #include "Database.h"
 #include "Model.h"
+#include "ProjectionCache.h"
 
 #define FOR_EACH_2D_IMAGE for (ptrdiff_t l = 0; l < static_cast<ptrdiff_t>(_ID.size()); l++)
 
@@ -60,6 +62,30 @@
 
 #define MIN_STD_FACTOR 2
 
+/**
+ * the lowest radius of a stage in coarse-to-fine global search, above the lower
+ * boundary of frequency (pixel)
+ */
+#define MIN_R_GLOBAL_SEARCH_STAGE 8
+
+/**
+ * the number of rotations projected together by a thread in global search,
+ * before they are scored one after another
+ */
+#define OPTIMISER_GLOBAL_SEARCH_BATCH 64
+
+/**
+ * the number of locks guarding the leader boards of significant poses in global
+ * search, the leader board of image l guarded by lock l modulo this number
+ */
+#define OPTIMISER_LEADER_BOARD_N_LOCK 256
+
+/**
+ * the fraction of the available memory of a node which can be used for
+ * inserting images into reconstructors
+ */
+#define INSERT_MEMORY_FRACTION 0.5
+
 #define CLASS_BALANCE_FACTOR 0.05
 
 struct OptimiserPara
@@ -249,6 +275,110 @@ struct OptimiserPara
 
     RFLOAT transSearchFactor;
 
+    /**
+     * whether to score translations in global search by the cross correlation
+     * map calculated by Fourier transform or not
+     */
+    bool transSearchFFT;
+
+    /**
+     * padding factor of the cross correlation map in translation search by
+     * Fourier transform, deciding the sub-pixel step of translations
+     */
+    int transSearchFFTPf;
+
+    /**
+     * in local search, a candidate is abandoned once its weight can not be
+     * above this fraction of the weight of the best candidate, 0 for scoring
+     * all candidates completely
+     */
+    RFLOAT earlyAbandonEps;
+
+    /**
+     * number of significant poses (class, rotation and translation) kept for
+     * each image in global search, from which the weights of classes,
+     * rotations and translations are reduced
+     */
+    int nSigPose;
+
+    /**
+     * number of stages of coarse-to-fine global search, each stage doubling
+     * the radius of the previous one, 1 for scanning all rotations at the
+     * full radius
+     */
+    int nStageGSearch;
+
+    /**
+     * fraction of orientations of each image kept by a stage of coarse-to-fine
+     * global search, and refined by the next stage
+     */
+    RFLOAT keepFracGSearch;
+
+    /**
+     * memory of the cache of projections shared by images in local search
+     * (MB), 0 for no cache
+     */
+    RFLOAT projCacheSize;
+
+    /**
+     * quantisation step of each component of quaternion in the cache of
+     * projections, rotations in the same bin share the projection at the
+     * centre of the bin
+     */
+    RFLOAT projCacheStep;
+
+    /**
+     * whether balancing the weights in reconstruction starts from the weights
+     * of the previous reconstruction
+     */
+    bool warmStartW;
+
+    /**
+     * factor of over-relaxation in balancing the weights in reconstruction,
+     * 1 for the plain fixed-point iteration
+     */
+    RFLOAT balanceRelax;
+
+    /**
+     * the way of symmetrizing in reconstruction, SYMMETRIZE_AFTER_INSERT,
+     * SYMMETRIZE_BY_INSERT or SYMMETRIZE_AUTO
+     */
+    int symmetrizeMode;
+
+    /**
+     * size of a chunk in all-reducing F and T of reconstruction (MB)
+     */
+    RFLOAT reduceChunk;
+
+    /**
+     * whether the volumes of reconstruction are shared by the processes on
+     * the same node, and all-reduced among the nodes
+     */
+    bool nodeShared;
+
+    /**
+     * whether the projectees are shared by the processes on the same node
+     */
+    bool projNodeShared;
+
+    /**
+     * whether the classes are spread across the processes of a hemisphere in
+     * reconstructing the references and building the projectees
+     */
+    bool classParallel;
+
+    /**
+     * the rigour of creating FFTW plans, FFTW_ESTIMATE, FFTW_MEASURE or
+     * FFTW_PATIENT
+     */
+    unsigned fftwRigour;
+
+    /**
+     * the file of FFTW wisdom, imported at startup and exported at shutdown,
+     * empty for not using wisdom
+     */
+    char fftwWisdom[FILE_NAME_LENGTH];
+
     RFLOAT perturbFactorL;
 
     RFLOAT perturbFactorSGlobal;
@@ -293,6 +423,23 @@ struct OptimiserPara
         thresReportFSC = 0.143;
         thresSclCorFSC = 0.75;
         transSearchFactor = 1;
+        transSearchFFT = false;
+        transSearchFFTPf = 2;
+        earlyAbandonEps = 0;
+        nSigPose = 1000;
+        nStageGSearch = 1;
+        keepFracGSearch = 0.05;
+        projCacheSize = 0;
+        projCacheStep = 0.005;
+        warmStartW = false;
+        balanceRelax = 1;
+        symmetrizeMode = SYMMETRIZE_AFTER_INSERT;
+        reduceChunk = 64;
+        nodeShared = false;
+        projNodeShared = false;
+        classParallel = false;
+        fftwRigour = FFTW_ESTIMATE;
+        fftwWisdom[0] = '\0';
         perturbFactorL = 0.8;
         perturbFactorSGlobal = 0.8;
         perturbFactorSLocal = 0.8;
@@ -504,11 +651,48 @@ class Optimiser : public Parallel
 
         int* _iSig;
 
-        Complex* _datP;
+        /**
+         * number of shells of the pre-calculated pixels
+         */
+        int _nShl;
+
+        /**
+         * the pre-calculated pixels are ordered by shell, pixels of shell v
+         * end at _shlEnd[v]
+         */
+        int* _shlEnd;
+
+        /**
+         * real and imaginary part of each pixel of each image, split for
+         * vectorisation
+         */
+        EFLOAT* _datReP;
 
-        RFLOAT* _ctfP;
+        EFLOAT* _datImP;
 
-        RFLOAT* _sigRcpP;
+        EFLOAT* _ctfP;
+
+        EFLOAT* _sigRcpP;
+
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+        /**
+         * conj(X) * CTF * (-0.5 / sigma^2) of each pixel of each image, in
+         * pixel major, real and imaginary part split
+         */
+        EFLOAT* _datCrossReP;
+
+        EFLOAT* _datCrossImP;
+
+        /**
+         * CTF^2 * (-0.5 / sigma^2) of each pixel of each image, in pixel major
+         */
+        EFLOAT* _ctf2SigRcpP;
+
+        /**
+         * |X|^2 * (-0.5 / sigma^2) summed over pixels of each image
+         */
+        RFLOAT* _datNormP;
+#endif
 
         /**
          * spatial frequency of each pixel
@@ -553,9 +737,20 @@ class Optimiser : public Parallel
             _iRow = NULL;
             _iSig = NULL;
 
-            _datP = NULL;
+            _nShl = 0;
+            _shlEnd = NULL;
+
+            _datReP = NULL;
+            _datImP = NULL;
             _ctfP = NULL;
             _sigRcpP = NULL;
+
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+            _datCrossReP = NULL;
+            _datCrossImP = NULL;
+            _ctf2SigRcpP = NULL;
+            _datNormP = NULL;
+#endif
         }
 
         ~Optimiser();
@@ -742,6 +937,13 @@ class Optimiser : public Parallel
                             const bool avgSave,
                             const bool finished = false);
 
+        /**
+         * This function broadcasts the reference of each class from the
+         * process of the hemisphere which reconstructs it to the others, when
+         * the classes are spread across the processes of the hemisphere.
+         */
+        void bcastClassRef();
+
         /***
          * @param mask           whether mask on the reference is allowed or
          *                       not
@@ -760,6 +962,17 @@ class Optimiser : public Parallel
 
         void freePreCal(const bool ctf);
 
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+        /**
+         * expand the pixel major pre-calculated images, CTFs and sigmas into
+         * image norms, cross term coefficients and prior norm coefficients,
+         * allocPreCal(true, ...) should be called first
+         */
+        void allocPreCalGEMM();
+
+        void freePreCalGEMM();
+#endif
+
         void saveDatabase() const;
 
         /**
@@ -845,6 +1058,72 @@ RFLOAT logDataVSPrior(const Complex* dat,
                       const RFLOAT* sigRcp,
                       const int m);
 
+/**
+ * This function calculates the logarithm of the possibility that the image is
+ * from the projection, in which the real and imaginary part of the image and
+ * the projection are stored in separate arrays. Each term is evaluated in the
+ * precision of the arrays while the sum is accumulated in RFLOAT.
+ *
+ * @param datRe  real part of the image
+ * @param datIm  imaginary part of the image
+ * @param priRe  real part of the projection
+ * @param priIm  imaginary part of the projection
+ * @param ctf    CTF values of each pixel
+ * @param sigRcp the reciprocal of sigma of noise of each pixel
+ * @param m      the number of pixels
+ */
+RFLOAT logDataVSPrior(const RFLOAT* datRe,
+                      const RFLOAT* datIm,
+                      const RFLOAT* priRe,
+                      const RFLOAT* priIm,
+                      const RFLOAT* ctf,
+                      const RFLOAT* sigRcp,
+                      const int m);
+
+RFLOAT logDataVSPrior(const float* datRe,
+                      const float* datIm,
+                      const float* priRe,
+                      const float* priIm,
+                      const float* ctf,
+                      const float* sigRcp,
+                      const int m);
+
+/**
+ * This function calculates the logarithm of the possibility that the image is
+ * from the projection shell by shell, from low frequency to high frequency. As
+ * every term is non-positive, the calculation stops once the partial result
+ * falls below the threshold, and the partial result is returned.
+ *
+ * @param datRe  real part of the image
+ * @param datIm  imaginary part of the image
+ * @param priRe  real part of the projection
+ * @param priIm  imaginary part of the projection
+ * @param ctf    CTF values of each pixel
+ * @param sigRcp the reciprocal of sigma of noise of each pixel
+ * @param shlEnd the end of pixels of each shell
+ * @param nShl   the number of shells
+ * @param thres  the threshold
+ */
+RFLOAT logDataVSPrior(const RFLOAT* datRe,
+                      const RFLOAT* datIm,
+                      const RFLOAT* priRe,
+                      const RFLOAT* priIm,
+                      const RFLOAT* ctf,
+                      const RFLOAT* sigRcp,
+                      const int* shlEnd,
+                      const int nShl,
+                      const RFLOAT thres);
+
+RFLOAT logDataVSPrior(const float* datRe,
+                      const float* datIm,
+                      const float* priRe,
+                      const float* priIm,
+                      const float* ctf,
+                      const float* sigRcp,
+                      const int* shlEnd,
+                      const int nShl,
+                      const RFLOAT thres);
+
 RFLOAT logDataVSPrior(const Complex* dat,
                       const Complex* pri,
                       const RFLOAT* frequency,
@@ -956,6 +1235,157 @@ vec logDataVSPrior(const Complex* dat,
                    const int n,
                    const int m);
 
+/**
+ * This function calculates the logarithm of the possibilities of a series of
+ * images is from a certain projection, in which the real and imaginary part of
+ * the images and the projection are stored in separate arrays. The images, the
+ * CTF values and the reciprocal of sigma are in pixel major.
+ *
+ * @param datRe  real part of the series of images
+ * @param datIm  imaginary part of the series of images
+ * @param priRe  real part of the projection
+ * @param priIm  imaginary part of the projection
+ * @param ctf    CTF values of each pixel correspondingly
+ * @param sigRcp the reciprocal of sigma of noise of each pixel correspondingly
+ * @param n      the number of images
+ * @param m      the number of pixels in each image
+ */
+vec logDataVSPrior(const RFLOAT* datRe,
+                   const RFLOAT* datIm,
+                   const RFLOAT* priRe,
+                   const RFLOAT* priIm,
+                   const RFLOAT* ctf,
+                   const RFLOAT* sigRcp,
+                   const int n,
+                   const int m);
+
+vec logDataVSPrior(const float* datRe,
+                   const float* datIm,
+                   const float* priRe,
+                   const float* priIm,
+                   const float* ctf,
+                   const float* sigRcp,
+                   const int n,
+                   const int m);
+
+/**
+ * This function calculates the logarithm of the possibilities of an image is
+ * from a certain projection under a series of translations. The CTF and sigma
+ * weighted cross correlation between the image and the projection under all
+ * shifts is calculated by a single inverse Fourier transform on a padded grid,
+ * and the score of each translation is read from it by bi-linear interpolation.
+ *
+ * @param result the logarithm of possibilities of each translation
+ * @param cc     the workspace of the cross correlation map in real space,
+ *               whose size is the size of image times pf
+ * @param ccFT   the workspace of the cross correlation map in Fourier space,
+ *               the half spectrum of cc allocated by TSFFTW_malloc, which
+ *               stays allocated
+ * @param fft    FFT with a backward plan of the size of cc
+ * @param datRe  real part of the image
+ * @param datIm  imaginary part of the image
+ * @param priRe  real part of the projection
+ * @param priIm  imaginary part of the projection
+ * @param ctf    CTF values of each pixel
+ * @param sigRcp the reciprocal of sigma of noise of each pixel
+ * @param iCol   the column indices of the pixels
+ * @param iRow   the row indices of the pixels
+ * @param tra    translations (pixel), one in each row
+ * @param pf     padding factor of the cross correlation map
+ * @param m      the number of pixels in the image
+ * @param stride the stride of pixels in the image, ctf and sigRcp
+ */
+void logDataVSPrior(vec& result,
+                    Image& cc,
+                    Complex* ccFT,
+                    FFT& fft,
+                    const RFLOAT* datRe,
+                    const RFLOAT* datIm,
+                    const RFLOAT* priRe,
+                    const RFLOAT* priIm,
+                    const RFLOAT* ctf,
+                    const RFLOAT* sigRcp,
+                    const int* iCol,
+                    const int* iRow,
+                    const mat2& tra,
+                    const int pf,
+                    const int m,
+                    const size_t stride);
+
+void logDataVSPrior(vec& result,
+                    Image& cc,
+                    Complex* ccFT,
+                    FFT& fft,
+                    const float* datRe,
+                    const float* datIm,
+                    const float* priRe,
+                    const float* priIm,
+                    const float* ctf,
+                    const float* sigRcp,
+                    const int* iCol,
+                    const int* iRow,
+                    const mat2& tra,
+                    const int pf,
+                    const int m,
+                    const size_t stride);
+
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+/**
+ * This function calculates the logarithm of the possibilities of a series of
+ * images is from a certain projection under a series of translations. The term
+ * |X - CTF * P|^2 * sigRcp is expanded into the image norm, the cross term and
+ * the prior norm, in which the cross terms of all images and all translations
+ * are evaluated by matrix multiplications. As only the real part of the cross
+ * terms is needed, it is evaluated by two real matrix multiplications on the
+ * split real and imaginary parts. The matrix multiplications are performed in
+ * the precision of the arrays while the image norm is added in RFLOAT.
+ *
+ * @param result     the logarithm of possibilities, n x nT
+ * @param datCrossRe real part of conj(X) * CTF * sigRcp, in pixel major
+ * @param datCrossIm imaginary part of conj(X) * CTF * sigRcp, in pixel major
+ * @param ctf2SigRcp CTF^2 * sigRcp of each pixel, in pixel major
+ * @param datNorm    |X|^2 * sigRcp summed over pixels of each image
+ * @param priRe      real part of a certain projection
+ * @param priIm      imaginary part of a certain projection
+ * @param traRe      real part of a series of translations, m pixels each
+ * @param traIm      imaginary part of a series of translations, m pixels each
+ * @param workRe     a buffer of nT * m
+ * @param workIm     a buffer of nT * m
+ * @param nT         the number of translations
+ * @param n          the number of images
+ * @param m          the number of pixels in each image
+ */
+void logDataVSPrior(mat& result,
+                    const RFLOAT* datCrossRe,
+                    const RFLOAT* datCrossIm,
+                    const RFLOAT* ctf2SigRcp,
+                    const RFLOAT* datNorm,
+                    const RFLOAT* priRe,
+                    const RFLOAT* priIm,
+                    const RFLOAT* traRe,
+                    const RFLOAT* traIm,
+                    RFLOAT* workRe,
+                    RFLOAT* workIm,
+                    const int nT,
+                    const int n,
+                    const int m);
+
+void logDataVSPrior(mat& result,
+                    const float* datCrossRe,
+                    const float* datCrossIm,
+                    const float* ctf2SigRcp,
+                    const RFLOAT* datNorm,
+                    const float* priRe,
+                    const float* priIm,
+                    const float* traRe,
+                    const float* traIm,
+                    float* workRe,
+                    float* workIm,
+                    const int nT,
+                    const int n,
+                    const int m);
+#endif
+
 RFLOAT dataVSPrior(const Image& dat,
                    const Image& pri,
                    const Image& ctf,
@@ -12,6 +12,7 @@
 #define PARALLEL_H
 
 #include <cstdio>
+#include <vector>
 
 #include <mpi.h>
 
@@ -26,6 +27,11 @@
  */
 #define MPI_MAX_BUF 2000000000
 
+/**
+ * the default size of a chunk in MPI_Iallreduce_Large (byte)
+ */
+#define MPI_IALLREDUCE_CHUNK (64 * 1024 * 1024)
+
 /**
  * rank ID of master process
  */
@@ -276,4 +282,54 @@ void MPI_Allreduce_Large(void* buf,
                          MPI_Op op,
                          MPI_Comm comm);
 
+/**
+ * the handle of a non-blocking all-reducing of large data, made of the
+ * requests of its chunks
+ */
+struct MPI_Request_Large
+{
+    std::vector<MPI_Request> request;
+};
+
+/**
+ * This function starts a non-blocking all-reducing of large data in place.
+ * The data is split into chunks, each of which is all-reduced by
+ * MPI_Iallreduce, so that the chunks are pipelined through the network while
+ * the caller goes on with other work. The buffer should not be touched until
+ * MPI_Wait_Large returns. As the chunks are posted at once, the all-reducings
+ * on the same communicator are matched in the order of the calls, which
+ * should be the same in all processes of the communicator.
+ *
+ * @param buf      the buffer area of all-reducing data
+ * @param count    the number of the data
+ * @param datatype the type of the data
+ * @param op       the operator of all-reducing
+ * @param comm     the communicator
+ * @param request  the handle of the all-reducing
+ * @param chunk    the size of a chunk (byte)
+ */
+void MPI_Iallreduce_Large(void* buf,
+                          size_t count,
+                          MPI_Datatype datatype,
+                          MPI_Op op,
+                          MPI_Comm comm,
+                          MPI_Request_Large& request,
+                          size_t chunk = MPI_IALLREDUCE_CHUNK);
+
+/**
+ * This function drives a non-blocking all-reducing of large data, and returns
+ * whether it is complete.
+ *
+ * @param request the handle of the all-reducing
+ */
+bool MPI_Test_Large(MPI_Request_Large& request);
+
+/**
+ * This function waits for a non-blocking all-reducing of large data to
+ * complete.
+ *
+ * @param request the handle of the all-reducing
+ */
+void MPI_Wait_Large(MPI_Request_Large& request);
+
 #endif // PARALLEL_H
@@ -0,0 +1,208 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependency:
+ * Test:
+ * Execution:
+ * Description: a thread-safe cache of projections, keyed by class and
+ *              quantised quaternion, with bounded memory and clock eviction
+ *
+ * Manual:
+ * ****************************************************************************/
+
+#ifndef PROJECTION_CACHE_H
+#define PROJECTION_CACHE_H
+
+#include <map>
+#include <vector>
+
+#include <omp_compat.h>
+
+#include <gsl/gsl_math.h>
+
+#include "Config.h"
+#include "Macro.h"
+#include "Typedef.h"
+#include "Functions.h"
+#include "Logging.h"
+
+/**
+ * the maximum number of independently locked shards of a projection cache, a
+ * cache holding fewer projections having as many shards as projections
+ */
+#define PROJECTION_CACHE_N_SHARD 64
+
+struct ProjectionCacheKey
+{
+    unsigned int cls;
+
+    int q[4];
+
+    bool operator<(const ProjectionCacheKey& that) const
+    {
+        if (cls != that.cls) return cls < that.cls;
+
+        for (int i = 0; i < 4; i++)
+            if (q[i] != that.q[i]) return q[i] < that.q[i];
+
+        return false;
+    }
+};
+
+/**
+ * The projections of rotations falling into the same bin of quantised
+ * quaternion are regarded as identical, and the projection is always
+ * evaluated at the centre of the bin, thus a cached projection does not depend
+ * on which image requests it first. A cache is only valid for the projectors
+ * it is filled by, i.e., within an iteration.
+ *
+ * The cache is divided into shards, each with its own lock, slots and clock
+ * hand. A slot referenced since the last pass of the clock hand survives the
+ * pass, otherwise it is evicted. The slots of all shards fit in the given
+ * memory, except that a cache holds at least one projection.
+ *
+ * A cache should be initialised before looking up or storing projections.
+ */
+class ProjectionCache
+{
+    private:
+
+        struct Shard
+        {
+            omp_lock_t lock;
+
+            std::map<ProjectionCacheKey, int> index;
+
+            std::vector<ProjectionCacheKey> key;
+
+            std::vector<bool> valid;
+
+            std::vector<bool> ref;
+
+            int hand;
+
+            size_t nHit;
+
+            size_t nMiss;
+        };
+
+        /**
+         * number of pixels of a projection
+         */
+        int _nPxl;
+
+        /**
+         * quantisation step of each component of quaternion
+         */
+        RFLOAT _step;
+
+        /**
+         * whether q and -q represent the same rotation (3D) or not (2D)
+         */
+        bool _antipodal;
+
+        /**
+         * number of shards
+         */
+        int _nShard;
+
+        /**
+         * number of slots in each shard
+         */
+        int _nSlot;
+
+        std::vector<Shard> _shard;
+
+        /**
+         * real and imaginary part of the projections, slot by slot
+         */
+        EFLOAT* _re;
+
+        EFLOAT* _im;
+
+        void key(ProjectionCacheKey& dst,
+                 const unsigned int cls,
+                 const vec4& quat) const;
+
+        int shard(const ProjectionCacheKey& key) const;
+
+        void clear();
+
+        ProjectionCache(const ProjectionCache&);
+
+        ProjectionCache& operator=(const ProjectionCache&);
+
+    public:
+
+        ProjectionCache();
+
+        /**
+         * @param size      memory of projections (MB)
+         * @param nPxl      number of pixels of a projection
+         * @param step      quantisation step of each component of quaternion
+         * @param antipodal whether q and -q represent the same rotation
+         */
+        ProjectionCache(const RFLOAT size,
+                        const int nPxl,
+                        const RFLOAT step,
+                        const bool antipodal);
+
+        ~ProjectionCache();
+
+        void init(const RFLOAT size,
+                  const int nPxl,
+                  const RFLOAT step,
+                  const bool antipodal);
+
+        /**
+         * This function returns the quaternion at the centre of the bin the
+         * given quaternion falls into, at which projections are evaluated.
+         * The bin of zero is centred at the identity.
+         *
+         * @param dst  the quaternion at the centre of the bin
+         * @param quat the quaternion
+         */
+        void quantise(vec4& dst,
+                      const vec4& quat) const;
+
+        /**
+         * This function looks up the projection of a class at a rotation. It
+         * returns whether it is hit or not, and copies the projection on hit.
+         *
+         * @param dstRe the real part of the projection
+         * @param dstIm the imaginary part of the projection
+         * @param cls   the class
+         * @param quat  the quaternion of the rotation
+         */
+        bool get(EFLOAT* dstRe,
+                 EFLOAT* dstIm,
+                 const unsigned int cls,
+                 const vec4& quat);
+
+        /**
+         * This function stores the projection of a class at a rotation,
+         * which should be evaluated at the quantised quaternion.
+         *
+         * @param srcRe the real part of the projection
+         * @param srcIm the imaginary part of the projection
+         * @param cls   the class
+         * @param quat  the quaternion of the rotation
+         */
+        void put(const EFLOAT* srcRe,
+                 const EFLOAT* srcIm,
+                 const unsigned int cls,
+                 const vec4& quat);
+
+        size_t nHit() const;
+
+        size_t nMiss() const;
+
+        /**
+         * number of projections the cache holds at most, within the given
+         * memory unless it is smaller than one projection
+         */
+        int capacity() const;
+};
+
+#endif // PROJECTION_CACHE_H
@@ -13,20 +13,38 @@
 #ifndef PROJECTOR_H
 #define PROJECTOR_H
 
+#include <cstring>
+
+#include <mpi.h>
+
 #include "Config.h"
 #include "Macro.h"
 #include "Complex.h"
 #include "Logging.h"
+#include "Parallel.h"
 
 #include "Euler.h"
 
 #include "Image.h"
 #include "Volume.h"
+#include "SphereVolume.h"
 
 #include "Coordinate5D.h"
 
 #include "ImageFunctions.h"
 
+/**
+ * the number of pixels of which the coordinates are worked out together by
+ * the projection kernel, before the neighbours of each are gathered
+ */
+#define PROJECTOR_KERNEL_BLOCK 64
+
+/**
+ * the order of the Hilbert curve along which the slices of a batch of
+ * rotations are projected
+ */
+#define PROJECTOR_HILBERT_ORDER 10
+
 class Projector
 {
     BOOST_MOVABLE_BUT_NOT_COPYABLE(Projector)
@@ -59,9 +77,27 @@ class Projector
         Image _projectee2D;
 
         /**
-         * the volume to be projected
+         * the volume to be projected, of which only the sphere inscribed in
+         * the padded cube is stored in Fourier space
+         */
+        SphereVolume _projectee3D;
+
+        /**
+         * the processes on the same node sharing the projectee in 3D mode,
+         * MPI_COMM_NULL for a projectee of its own
+         */
+        MPI_Comm _node;
+
+        /**
+         * the memory shared on the node holding the projectee, MPI_WIN_NULL
+         * when the projectee is not shared
+         */
+        MPI_Win _win;
+
+        /**
+         * whether the projectee in 3D mode is stored in bricks
          */
-        Volume _projectee3D;
+        bool _brick;
 
     public:
 
@@ -72,6 +108,12 @@ class Projector
 
         Projector(BOOST_RV_REF(Projector) that)
         {
+            // the projector moved from frees nothing shared on the node
+
+            _node = MPI_COMM_NULL;
+
+            _win = MPI_WIN_NULL;
+
             swap(that);
         }
 
@@ -142,6 +184,30 @@ class Projector
          */
         void setPf(const int pf);
 
+        bool brick() const;
+
+        /**
+         * This function sets whether the projectee in 3D mode is stored in
+         * bricks of voxels, which keeps the voxels read by interpolating a
+         * central slice close in memory. It takes effect when the projectee
+         * is set.
+         *
+         * @param brick whether the projectee is stored in bricks
+         */
+        void setBrick(const bool brick);
+
+        /**
+         * This function sets the processes on the same node which share the
+         * projectee in 3D mode. The projectee is then built by the process of
+         * rank 0 in the memory shared on the node, which the others attach
+         * to, and setProjectee() becomes collective in the node. The
+         * communicator is not freed by the projector.
+         *
+         * @param node the processes on the same node, MPI_COMM_NULL for a
+         *             projectee of its own
+         */
+        void setNode(MPI_Comm node);
+
         /**
          * This function returns a constant reference to the projectee.
          */
@@ -150,7 +216,7 @@ class Projector
         /**
          * This function returns a constant reference to the projectee.
          */
-        const Volume& projectee3D() const;
+        const SphereVolume& projectee3D() const;
 
         /**
          * This function sets the projectee. Moreover, it automatically sets the
@@ -168,6 +234,38 @@ class Projector
          */
         void setProjectee(Volume src);
 
+        /**
+         * This function builds the projectee in 3D mode, as setProjectee()
+         * does, in the memory of the process alone, even if the projectee is
+         * shared on the node. It lets the processes build the projectees of
+         * different projectors at the same time, handing them to the others
+         * by shareProjectee() or bcastProjectee() afterwards.
+         *
+         * @param src the volume to be projected
+         */
+        void buildProjectee(Volume src);
+
+        /**
+         * This function moves the projectee in 3D mode built by a process on
+         * the node into the memory shared on the node, which the others
+         * attach to. It is collective in the node set by setNode().
+         *
+         * @param root the rank in the node of the process which builds the
+         *             projectee
+         */
+        void shareProjectee(const int root);
+
+        /**
+         * This function copies the projectee in 3D mode built by a process to
+         * the other processes of the communicator, each of which keeps it in
+         * its own memory. It is collective in the communicator.
+         *
+         * @param root the rank of the process which builds the projectee
+         * @param comm the communicator
+         */
+        void bcastProjectee(const int root,
+                            MPI_Comm comm);
+
         void project(Image& dst,
                      const mat22& mat) const;
 
@@ -217,6 +315,28 @@ class Projector
                      const int* iRow,
                      const int nPxl) const;
 
+        /**
+         * This function projects given the rotation matrix, storing the
+         * result in single precision.
+         *
+         * @param dst  the destination, one value per pixel
+         * @param mat  the rotation matrix
+         * @param iCol the column index of each pixel
+         * @param iRow the row index of each pixel
+         * @param nPxl the number of pixels
+         */
+        void project(ComplexF* dst,
+                     const mat22& mat,
+                     const int* iCol,
+                     const int* iRow,
+                     const int nPxl) const;
+
+        void project(ComplexF* dst,
+                     const mat33& mat,
+                     const int* iCol,
+                     const int* iRow,
+                     const int nPxl) const;
+
         void projectMT(Image& dst,
                        const mat22& mat) const;
 
@@ -267,6 +387,75 @@ class Projector
                        const int* iRow,
                        const int nPxl) const;
 
+        void projectBatch(Complex* dst,
+                          const mat22* rot,
+                          const int nRot,
+                          const int* iCol,
+                          const int* iRow,
+                          const int nPxl) const;
+
+        /**
+         * This function projects a batch of rotations on pre-determined
+         * pixels. The rotations are projected in the order of their slices
+         * along a Hilbert curve, so that a slice reads the voxels cached by
+         * the slices close to it. The projection of the m-th rotation is
+         * stored in dst[m * nPxl] to dst[(m + 1) * nPxl - 1], ready to be
+         * scored rotation after rotation.
+         *
+         * @param dst  the destination, nPxl values per rotation
+         * @param rot  the rotation matrices
+         * @param nRot the number of rotations
+         * @param iCol the column index of each pixel
+         * @param iRow the row index of each pixel
+         * @param nPxl the number of pixels
+         */
+        void projectBatch(Complex* dst,
+                          const mat33* rot,
+                          const int nRot,
+                          const int* iCol,
+                          const int* iRow,
+                          const int nPxl) const;
+
+        void projectBatch(ComplexF* dst,
+                          const mat22* rot,
+                          const int nRot,
+                          const int* iCol,
+                          const int* iRow,
+                          const int nPxl) const;
+
+        void projectBatch(ComplexF* dst,
+                          const mat33* rot,
+                          const int nRot,
+                          const int* iCol,
+                          const int* iRow,
+                          const int nPxl) const;
+
+        void projectBatchMT(Complex* dst,
+                            const mat22* rot,
+                            const int nRot,
+                            const int* iCol,
+                            const int* iRow,
+                            const int nPxl) const;
+
+        /**
+         * This function projects a batch of rotations on pre-determined
+         * pixels using multiple threads, each of which takes a run of
+         * consecutive slices along the Hilbert curve.
+         *
+         * @param dst  the destination, nPxl values per rotation
+         * @param rot  the rotation matrices
+         * @param nRot the number of rotations
+         * @param iCol the column index of each pixel
+         * @param iRow the row index of each pixel
+         * @param nPxl the number of pixels
+         */
+        void projectBatchMT(Complex* dst,
+                            const mat33* rot,
+                            const int nRot,
+                            const int* iCol,
+                            const int* iRow,
+                            const int nPxl) const;
+
         void project(Image& dst,
                      const mat22& rot,
                      const vec2& t) const;
@@ -368,10 +557,95 @@ class Projector
 
     private:
 
+        /**
+         * This function frees the projectee shared on the node. It is
+         * collective in the node.
+         */
+        void freeShared();
+
+        /**
+         * This function broadcasts the size of the projectee in 3D mode, the
+         * radius of the sphere kept and the max radius from a process to the
+         * others of the communicator.
+         *
+         * @param shape the size, the radius of the sphere, the max radius and
+         *              whether the projectee is stored in bricks
+         * @param root  the rank of the process which builds the projectee
+         * @param comm  the communicator
+         */
+        void bcastShape(int* shape,
+                        const int root,
+                        MPI_Comm comm);
+
         /**
          * This function performs gridding correction on projectee.
+         *
+         * @param projectee the padded projectee in real space
+         */
+        void gridCorrection(Image& projectee) const;
+
+        /**
+         * This function performs gridding correction on projectee.
+         *
+         * @param projectee the padded projectee in real space
+         */
+        void gridCorrection(Volume& projectee) const;
+
+        /**
+         * This function is the kernel of projecting pre-determined pixels.
+         * As the slice is planar, the rotated coordinate of a pixel is
+         * iCol * c0 + iRow * c1. The coordinates of a block of pixels are
+         * worked out and brought to the half spectrum together, keeping
+         * the Friedel conjugation as a mask of signs, and then the
+         * neighbours of each pixel are gathered.
+         *
+         * @param dst  the destination, one value per pixel
+         * @param mat  the rotation matrix
+         * @param iCol the column index of each pixel
+         * @param iRow the row index of each pixel
+         * @param iPxl the index of each pixel in the destination, NULL for
+         *             the pixels one after another
+         * @param nPxl the number of pixels
+         * @param mt   whether to use multiple threads
+         */
+        template <typename T>
+        void projectKernel(T* dst,
+                           const mat22& mat,
+                           const int* iCol,
+                           const int* iRow,
+                           const int* iPxl,
+                           const int nPxl,
+                           const bool mt) const;
+
+        template <typename T>
+        void projectKernel(T* dst,
+                           const mat33& mat,
+                           const int* iCol,
+                           const int* iRow,
+                           const int* iPxl,
+                           const int nPxl,
+                           const bool mt) const;
+
+        /**
+         * This function projects a batch of rotations through the projection
+         * kernel, in the order of their slices along a Hilbert curve.
+         *
+         * @param dst  the destination, nPxl values per rotation
+         * @param rot  the rotation matrices
+         * @param nRot the number of rotations
+         * @param iCol the column index of each pixel
+         * @param iRow the row index of each pixel
+         * @param nPxl the number of pixels
+         * @param mt   whether to use multiple threads
          */
-        void gridCorrection();
+        template <typename T, typename M>
+        void projectBatchKernel(T* dst,
+                                const M* rot,
+                                const int nRot,
+                                const int* iCol,
+                                const int* iRow,
+                                const int nPxl,
+                                const bool mt) const;
 };
 
 #endif // PROJECTOR_H
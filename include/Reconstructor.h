@@ -31,9 +31,12 @@
 #include "FFT.h"
 #include "Image.h"
 #include "Volume.h"
+#include "RealHalfVolume.h"
+#include "SphereVolume.h"
 #include "ImageFunctions.h"
 #include "Symmetry.h"
 #include "Transformation.h"
+#include "Symmetrizer.h"
 #include "TabFunction.h"
 #include "Spectrum.h"
 #include "Mask.h"
@@ -44,6 +47,12 @@
 
 #define PAD_SIZE (_pf * _size)
 
+/**
+ * In 3D mode, F, W, C and T are cropped to the sphere inscribed in the padded
+ * cube, which covers the maximum radius and the support of the kernel.
+ */
+#define PAD_SPHERE_RADIUS (PAD_SIZE / 2)
+
 #define RECO_LOOSE_FACTOR 1
 
 #define MIN_N_ITER_BALANCE 10
@@ -56,12 +65,81 @@
 
 #define N_DIFF_C_NO_DECREASE 2
 
+/**
+ * If the distance to total balanced of the weights kept from the previous
+ * reconstruction is above this threshold, the balancing restarts from 1.
+ */
+#define WARM_START_DIFF_C_THRES 0.5
+
 #define WIENER_FACTOR_MIN_R 5
 
 #define FSC_BASE_L 1e-3
 
 #define FSC_BASE_H (1 - 1e-3)
 
+/**
+ * inserting images by atomic additions on the volumes
+ */
+#define INSERT_ATOMIC 0
+
+/**
+ * inserting images into a partial volume for each thread, which are reduced
+ * before preparing F and T
+ */
+#define INSERT_THREAD_PRIVATE 1
+
+/**
+ * buffering the inserted pixels of each thread by tiles of the volume, which
+ * are applied tile by tile without atomic additions
+ */
+#define INSERT_TILE 2
+
+/**
+ * the thickness of a tile, in slices (3D) or rows (2D)
+ */
+#define INSERT_TILE_THICKNESS 1
+
+/**
+ * the number of tiles of the padded volume in INSERT_TILE mode
+ */
+#define INSERT_N_TILE ((PAD_SIZE + INSERT_TILE_THICKNESS - 1) / INSERT_TILE_THICKNESS)
+
+/**
+ * symmetrizing F and T by interpolation after all images are inserted and
+ * reduced
+ */
+#define SYMMETRIZE_AFTER_INSERT 0
+
+/**
+ * inserting each image at all the orientations related by symmetry, leaving
+ * F and T symmetric without interpolating them again
+ */
+#define SYMMETRIZE_BY_INSERT 1
+
+/**
+ * choosing between SYMMETRIZE_AFTER_INSERT and SYMMETRIZE_BY_INSERT by the
+ * number of images and the size of the volume
+ */
+#define SYMMETRIZE_AUTO 2
+
+/**
+ * the time of inserting a pixel relative to the time of interpolating a voxel
+ * of F and T in symmetrizing, for choosing the way of symmetrizing
+ */
+#define SYMMETRIZE_INSERT_COST 2
+
+/**
+ * a pixel to be inserted, with its coordinate on the half spectrum
+ */
+struct InsertSplat
+{
+    RFLOAT x[3];
+
+    Complex f;
+
+    RFLOAT t;
+};
+
 /**
  * @ingroup Reconstructor
  * @brief The 3D model reconstruction class.
@@ -100,6 +178,31 @@ class Reconstructor : public Parallel
 
         bool _joinHalf;
 
+        /**
+         * whether balancing the weights starts from the weights of the
+         * previous reconstruction, of which the frequencies are kept when the
+         * space is resized
+         */
+        bool _warmStartW;
+
+        /**
+         * whether W holds the balanced weights of a previous reconstruction
+         */
+        bool _validW;
+
+        /**
+         * the distance to total balanced of the previous reconstruction, with
+         * and without MAP, which balancing from warm start aims at
+         */
+        RFLOAT _diffCW[2];
+
+        /**
+         * the factor of over-relaxation in balancing the weights, W is divided
+         * by the power of C of this factor in each iteration, 1 for the plain
+         * fixed-point iteration
+         */
+        RFLOAT _balanceRelax;
+
         /**
          * The real size of the 3D Fourier reconstructor space that is used to
          * determine the size (PAD_SIZE) of Volume in 3 dimensions(xyz).
@@ -112,11 +215,14 @@ class Reconstructor : public Parallel
 
         Image _F2D;
 
-        Image _W2D;
+        /**
+         * W, C and T are real, thus stored as real images of half spectrum
+         */
+        RealHalfVolume _W2D;
 
-        Image _C2D;
+        RealHalfVolume _C2D;
 
-        Image _T2D;
+        RealHalfVolume _T2D;
 
         /**
          * The 3D grid volume used to save the accumulation of the pixels 
@@ -128,9 +234,10 @@ class Reconstructor : public Parallel
          * weights value of each grid point stored in @ref_W to get balanced.
          * Then an allreduce operation will be done to get the final sum of
          * _F volumes of all nodes, which the 3D Fourier transform of the 
-         * model is obtained. This volume is initialised to be all zero.
+         * model is obtained. This volume is initialised to be all zero. Only
+         * the half spectrum inside the sphere of PAD_SPHERE_RADIUS is stored.
          */
-        Volume _F3D;
+        SphereVolume _F3D;
         
         /**
          * The 3D grid volume used to save the balancing weights factors of 
@@ -143,9 +250,10 @@ class Reconstructor : public Parallel
          * that has been allreduced within all nodes, the weights are balanced
          * and normalized, with which can be multiply with volume @ref_F to 
          * get the 3D Fourier transform of the model. This volume initialised
-         * to be all one.
+         * to be all one. As W, C and T are real, they are stored as real
+         * volumes of half spectrum, cropped to the same sphere as _F3D.
          */
-        Volume _W3D;
+        RealHalfVolume _W3D;
         
         
         /**
@@ -159,9 +267,9 @@ class Reconstructor : public Parallel
          * by the divion of _W and _C, with which _C can be approximately equal
          * to 1. This volume initialised to be all zero.
          */
-        Volume _C3D;
+        RealHalfVolume _C3D;
 
-        Volume _T3D;
+        RealHalfVolume _T3D;
 
         /**
          * The vector to save the rotate matrixs of each insertion with image 
@@ -248,6 +356,123 @@ class Reconstructor : public Parallel
 
         FFT _fft;
 
+        /**
+         * the way images are inserted, INSERT_ATOMIC, INSERT_THREAD_PRIVATE or
+         * INSERT_TILE
+         */
+        int _insertMode;
+
+        /**
+         * number of threads inserting images
+         */
+        int _nThread;
+
+        /**
+         * the partial F and T of each thread in INSERT_THREAD_PRIVATE mode
+         */
+        Complex* _partF;
+
+        RFLOAT* _partT;
+
+        int _nTile;
+
+        /**
+         * the buffered pixels of each thread and each tile in INSERT_TILE mode
+         */
+        vector<InsertSplat>* _tile;
+
+        /**
+         * the number of pixels which can be buffered in INSERT_TILE mode
+         */
+        size_t _nSplatMax;
+
+        /**
+         * the memory which can be used for insertion, and for caching the
+         * stencils of symmetrizing after insertion (byte)
+         */
+        size_t _memory;
+
+        /**
+         * the stencils of symmetrizing F and T, which share the same sphere
+         */
+        Symmetrizer _symmetrizer;
+
+        /**
+         * the way F and T are symmetrized, SYMMETRIZE_AFTER_INSERT,
+         * SYMMETRIZE_BY_INSERT or SYMMETRIZE_AUTO
+         */
+        int _symmetrizeMode;
+
+        /**
+         * whether the images being inserted are inserted at all the
+         * orientations related by symmetry
+         */
+        bool _insertSym;
+
+        /**
+         * the rotations mapping an orientation to the orientations related by
+         * symmetry, except the identity, in SYMMETRIZE_BY_INSERT
+         */
+        vector<mat33> _symRot;
+
+        /**
+         * whether F and T are symmetric after insertion, from beginPrepareTF()
+         * to endPrepareTF()
+         */
+        bool _symmetrizedTF;
+
+        /**
+         * the size of a chunk in all-reducing F and T (byte)
+         */
+        size_t _reduceChunk;
+
+        /**
+         * the non-blocking all-reducing of F and T, from beginPrepareTF() to
+         * endPrepareTF()
+         */
+        MPI_Request_Large _reduceF;
+
+        MPI_Request_Large _reduceT;
+
+        /**
+         * whether F and T in 3D mode are shared by the processes of the
+         * hemisphere on the same node
+         */
+        bool _nodeShared;
+
+        /**
+         * whether reconstruct() is called by this process alone, rather than
+         * by all the processes sharing F and T on the node
+         */
+        bool _reconstructAlone;
+
+        /**
+         * the processes of the hemisphere on the same node
+         */
+        MPI_Comm _node;
+
+        /**
+         * the leaders of the nodes, the processes of rank 0 in _node, which
+         * all-reduce F and T shared on the nodes, MPI_COMM_NULL in others
+         */
+        MPI_Comm _nodeLeader;
+
+        int _nodeRank;
+
+        int _nodeSize;
+
+        /**
+         * the memory shared on the node, holding F, T and the locks of the
+         * tiles, MPI_WIN_NULL when F and T are not shared
+         */
+        MPI_Win _nodeWin;
+
+        /**
+         * the lock of each tile of F and T shared on the node, held in
+         * flushing the buffered pixels in INSERT_TILE mode
+         */
+        int* _tileLock;
+
         void defaultInit()
         {
             _mode = MODE_3D;
@@ -258,6 +483,14 @@ class Reconstructor : public Parallel
 
             _joinHalf = false;
 
+            _warmStartW = false;
+
+            _validW = false;
+
+            _diffCW[0] = _diffCW[1] = DIFF_C_THRES;
+
+            _balanceRelax = 1;
+
             _pf = 2;
             _sym = NULL;
             _a = 1.9;
@@ -271,6 +504,43 @@ class Reconstructor : public Parallel
             _FSC = vec::Constant(1, 1);
             _sig = vec::Zero(1);
             _tau = vec::Constant(1, 1);
+
+            _insertMode = INSERT_ATOMIC;
+
+            _nThread = 1;
+
+            _partF = NULL;
+            _partT = NULL;
+
+            _nTile = 0;
+
+            _tile = NULL;
+
+            _nSplatMax = 0;
+
+            _memory = 0;
+
+            _symmetrizeMode = SYMMETRIZE_AFTER_INSERT;
+
+            _insertSym = false;
+
+            _symmetrizedTF = false;
+
+            _reduceChunk = MPI_IALLREDUCE_CHUNK;
+
+            _nodeShared = false;
+
+            _reconstructAlone = false;
+
+            _node = MPI_COMM_NULL;
+            _nodeLeader = MPI_COMM_NULL;
+
+            _nodeRank = 0;
+            _nodeSize = 1;
+
+            _nodeWin = MPI_WIN_NULL;
+
+            _tileLock = NULL;
         }
 
     public:
@@ -341,6 +611,14 @@ class Reconstructor : public Parallel
 
         void setJoinHalf(const bool joinHalf);
 
+        void setWarmStartW(const bool warmStartW);
+
+        /**
+         * @param balanceRelax the factor of over-relaxation in balancing the
+         *                     weights, between 1 and 2
+         */
+        void setBalanceRelax(const RFLOAT balanceRelax);
+
         /** 
          * set the symmetry mark of the model to be reconstructed. 
          *
@@ -348,6 +626,49 @@ class Reconstructor : public Parallel
          */
         void setSymmetry(const Symmetry* sym);
 
+        /**
+         * @param symmetrizeMode the way F and T are symmetrized,
+         *                       SYMMETRIZE_AFTER_INSERT, SYMMETRIZE_BY_INSERT
+         *                       or SYMMETRIZE_AUTO
+         */
+        void setSymmetrizeMode(const int symmetrizeMode);
+
+        /**
+         * This function returns whether the images are inserted at all the
+         * orientations related by symmetry, as decided by allocInsert().
+         */
+        bool symmetrizeByInsert() const;
+
+        /**
+         * @param reduceChunk the size of a chunk in all-reducing F and T
+         *                    (byte)
+         */
+        void setReduceChunk(const size_t reduceChunk);
+
+        /**
+         * This function sets whether F and T in 3D mode are shared by the
+         * processes of the hemisphere on the same node. Each process then
+         * inserts into the volumes shared on the node, and only the leaders of
+         * the nodes all-reduce them, which saves the memory and the message
+         * volume by the number of processes on a node. It should be called
+         * after the MPI environment is set, by all the processes of the
+         * hemisphere. The space is allocated again if it is allocated already.
+         *
+         * @param nodeShared whether F and T are shared on the node
+         */
+        void setNodeShared(const bool nodeShared);
+
+        /**
+         * This function sets whether reconstruct() is called by this process
+         * alone, such as when the classes are spread across the processes of
+         * the hemisphere. T shared on the node is then divided by this
+         * process without waiting for the others on the node.
+         *
+         * @param reconstructAlone whether reconstruct() is called by this
+         *                         process alone
+         */
+        void setReconstructAlone(const bool reconstructAlone);
+
         void setFSC(const vec& FSC);
 
         void setTau(const vec& tau);
@@ -418,8 +739,65 @@ class Reconstructor : public Parallel
                      const RFLOAT w,
                      const vec* sig = NULL);
 
+        /**
+         * This function gets the reconstructor ready for insertP from multiple
+         * threads. A partial volume is allocated for each thread when the
+         * memory allows. Otherwise, the inserted pixels are buffered by tiles
+         * of the volume, and flushed by flushInsert(). Atomic additions are
+         * used when even the buffer does not fit in, or the kernel is not
+         * trilinear.
+         *
+         * In 3D mode with symmetry, it also decides whether the images are
+         * inserted at all the orientations related by symmetry. Inserting an
+         * image costs as many times as the symmetry elements, while
+         * symmetrizing after insertion costs as many interpolations of F and
+         * T as the voxels, independent of the number of images. In
+         * SYMMETRIZE_AUTO, the cheaper one is taken.
+         *
+         * @param memory  the memory which can be used for insertion, and for
+         *                caching the stencils of symmetrizing, which are taken
+         *                out of it when they are kept from the last iteration
+         *                (byte)
+         * @param nInsert the number of insertP calls to be made, 0 for unknown
+         */
+        void allocInsert(const size_t memory,
+                         const size_t nInsert = 0);
+
+        /**
+         * This function returns the number of insertP calls which can be made
+         * before flushInsert() has to be called.
+         */
+        int insertBatch() const;
+
+        /**
+         * This function applies the buffered pixels in INSERT_TILE mode. It
+         * should be called out of parallel regions.
+         */
+        void flushInsert();
+
+        /**
+         * This function prepares F and T for reconstruction, the same as
+         * beginPrepareTF() followed by endPrepareTF().
+         */
         void prepareTF();
 
+        /**
+         * This function finishes insertion and starts all-reducing T and F in
+         * the hemisphere without blocking. T is all-reduced while the partial
+         * volumes of F are still being added up. Other work, such as
+         * finishing the insertion into the reconstructors of other classes,
+         * can go on until endPrepareTF(). The reconstructors sharing a
+         * hemisphere should begin and end in the same order in all processes.
+         */
+        void beginPrepareTF();
+
+        /**
+         * This function waits for T and F to be all-reduced, and normalises
+         * and symmetrizes them. T is symmetrized while F is still being
+         * all-reduced.
+         */
+        void endPrepareTF();
+
         void reconstruct(Image& dst);
 
         /**
@@ -436,13 +814,111 @@ class Reconstructor : public Parallel
     private:
 
         /**
-         * The size of the reconstructor area that is used to determine the
-         * size of Volume in 3 dimension xyz.
+         * This function inserts a pixel by trilinear (3D) or bilinear (2D)
+         * interpolation, in the way given by _insertMode.
+         *
+         * @param f    the value added on F
+         * @param t    the value added on T
+         * @param iCol the index of the column
+         * @param iRow the index of the row
+         * @param iSlc the index of the slice, 0 in 2D
+         */
+        void insertLinear(const Complex f,
+                          const RFLOAT t,
+                          RFLOAT iCol,
+                          RFLOAT iRow,
+                          RFLOAT iSlc);
+
+        /**
+         * This function adds a pixel on F and T without atomic additions.
+         *
+         * @param F     F
+         * @param T     T
+         * @param splat the pixel
+         */
+        void addSplat(Complex* F,
+                      RFLOAT* T,
+                      const InsertSplat& splat) const;
+
+        /**
+         * This function applies the buffered pixels and reduces the partial
+         * volumes, and then frees them.
+         */
+        void freeInsert();
+
+        /**
+         * This function adds the partial T of each thread in
+         * INSERT_THREAD_PRIVATE mode up into T, and then frees them.
+         */
+        void addPartT();
+
+        /**
+         * This function adds the partial F of each thread in
+         * INSERT_THREAD_PRIVATE mode up into F, and then frees them.
+         */
+        void addPartF();
+
+        /**
+         * This function returns whether F and T are shared on the node.
+         */
+        bool nodeSharedTF() const { return _nodeWin != MPI_WIN_NULL; };
+
+        /**
+         * This function returns whether the process works on F and T in
+         * place, the leader of the node when F and T are shared on the node.
+         */
+        bool nodeLeaderTF() const { return !nodeSharedTF() || (_nodeRank == 0); };
+
+        /**
+         * This function allocates F and T in 3D mode in the memory shared on
+         * the node, freeing the previous ones. It is collective in the node.
+         */
+        void allocNodeShared();
+
+        /**
+         * This function frees F and T shared on the node. It is collective in
+         * the node.
+         */
+        void freeNodeShared();
+
+        /**
+         * This function starts all-reducing F in the hemisphere, which is
+         * waited for in endPrepareTF(). F shared on the node is all-reduced
+         * among the leaders of the nodes.
          */
         void allReduceF();
 
+        /**
+         * This function starts all-reducing T in the hemisphere, which is
+         * waited for in endPrepareTF(). T shared on the node is all-reduced
+         * among the leaders of the nodes.
+         */
         void allReduceT();
 
+        /**
+         * This function initialises W inside the max radius as 1 and outside
+         * as 0. In warm start, W inside the max radius is kept, except where
+         * it is not positive.
+         *
+         * @param warm whether to keep W of the previous reconstruction
+         */
+        void initW(const bool warm);
+
+        /**
+         * This function returns the factor dividing W in an iteration of
+         * balancing the weights.
+         *
+         * @param c     the value of C
+         * @param relax the factor of over-relaxation
+         */
+        static inline RFLOAT balanceFactor(const RFLOAT c,
+                                           const RFLOAT relax)
+        {
+            RFLOAT f = GSL_MAX_DBL(fabs(c), 1e-6);
+
+            return (relax == 1) ? f : pow(f, relax);
+        }
+
         RFLOAT checkC() const;
 
         void convoluteC();
@@ -13,10 +13,13 @@
 #ifndef TYPEDEF_H
 #define TYPEDEF_H
 
+#include <complex>
+
 #include <gsl/gsl_complex.h>
 
 #include <Eigen/Dense>
 
+#include "Config.h"
 #include "Macro.h"
 
 #ifdef MATRIX_BOUNDARY_NO_CHECK
@@ -29,9 +32,26 @@ typedef unsigned long size_t;
 
 typedef gsl_complex Complex;
 
+typedef gsl_complex_float ComplexF;
+
+/**
+ * precision of the data stored and scored in expectation, the logarithm of
+ * possibilities are always accumulated in RFLOAT
+ */
+#ifdef OPTIMISER_E_STEP_SINGLE_PRECISION
+typedef float EFLOAT;
+typedef ComplexF ComplexE;
+#else
+typedef RFLOAT EFLOAT;
+typedef Complex ComplexE;
+#endif
+
 typedef Matrix<RFLOAT, Dynamic, Dynamic> mat;
 typedef Matrix<RFLOAT, Dynamic, 1> vec;
 
+typedef Matrix<std::complex<RFLOAT>, Dynamic, Dynamic> cmat;
+typedef Matrix<std::complex<RFLOAT>, Dynamic, 1> cvec;
+
 typedef Matrix<unsigned int, Dynamic, Dynamic> umat;
 typedef Matrix<unsigned int, Dynamic, 1> uvec;
 
@@ -16,4 +16,10 @@ bool regexMatches(const char* str, const char* pattern);
 
 const char* getTempDirectory(void);
 
+/**
+ * This function returns the physical memory available on the node (byte),
+ * taken from /proc/meminfo, or the free pages when it is not available.
+ */
+size_t availableMemory(void);
+
 #endif // UTILS_H
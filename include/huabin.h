@@ -112,5 +112,11 @@ TSFFTW_PLAN TSFFTW_plan_dft_c2r_3d(int n0, int n1, int n2, TSFFTW_COMPLEX *in, R
 void TSFFTW_plan_with_nthreads(int nthreads);
 
 void TSFFTW_set_timelimit(RFLOAT seconds);
+
+int TSFFTW_alignment_of(RFLOAT *p);
+
+int TSFFTW_import_wisdom_from_filename(const char *filename);
+
+int TSFFTW_export_wisdom_to_filename(const char *filename);
 #endif
 
@@ -12,8 +12,135 @@
 
 #include "FFT.h"
 
+#include <map>
+
 #include <omp_compat.h>
 
+/**
+ * the key of a plan in the plan cache
+ */
+struct FFTPlanKey
+{
+    int nCol;
+
+    int nRow;
+
+    int nSlc;
+
+    bool fw;
+
+    int nThread;
+
+    bool aligned;
+
+    unsigned rigour;
+
+    bool operator<(const FFTPlanKey& that) const
+    {
+        if (nCol != that.nCol) return nCol < that.nCol;
+        if (nRow != that.nRow) return nRow < that.nRow;
+        if (nSlc != that.nSlc) return nSlc < that.nSlc;
+        if (fw != that.fw) return fw < that.fw;
+        if (nThread != that.nThread) return nThread < that.nThread;
+        if (aligned != that.aligned) return aligned < that.aligned;
+        return rigour < that.rigour;
+    }
+};
+
+/**
+ * the plans shared by all the FFT objects in the process
+ */
+static std::map<FFTPlanKey, TSFFTW_PLAN>& planCache()
+{
+    static std::map<FFTPlanKey, TSFFTW_PLAN> cache;
+
+    return cache;
+}
+
+static unsigned planRigour = FFTW_ESTIMATE;
+
+/**
+ * the rigour of the plans created for being executed many times
+ */
+static unsigned createRigour()
+{
+    return (planRigour == FFTW_ESTIMATE) ? FFTW_MEASURE : planRigour;
+}
+
+static bool aligned(RFLOAT* srcR,
+                    TSFFTW_COMPLEX* srcC)
+{
+    return (TSFFTW_alignment_of(srcR) == 0)
+        && (TSFFTW_alignment_of((RFLOAT*)srcC) == 0);
+}
+
+/**
+ * This function returns the plan of the given dimensions, direction, number of
+ * threads, alignment and rigour from the plan cache, creating it on scratch
+ * arrays when it is not in the cache yet, as creating a plan other than
+ * FFTW_ESTIMATE overwrites the arrays.
+ */
+static TSFFTW_PLAN cachedPlan(const int nCol,
+                              const int nRow,
+                              const int nSlc,
+                              const bool fw,
+                              const int nThread,
+                              const bool aligned,
+                              const unsigned rigour)
+{
+    FFTPlanKey key = {nCol, nRow, nSlc, fw, nThread, aligned, rigour};
+
+    TSFFTW_PLAN plan;
+
+    #pragma omp critical (FFTPlanCache)
+    {
+        std::map<FFTPlanKey, TSFFTW_PLAN>::const_iterator it = planCache().find(key);
+
+        if (it != planCache().end())
+            plan = it->second;
+        else
+        {
+            RFLOAT* r = (RFLOAT*)TSFFTW_malloc((size_t)nCol * nRow * nSlc * sizeof(RFLOAT));
+            TSFFTW_COMPLEX* c = (TSFFTW_COMPLEX*)TSFFTW_malloc((size_t)(nCol / 2 + 1) * nRow * nSlc * sizeof(Complex));
+
+            unsigned flags = aligned ? rigour : (rigour | FFTW_UNALIGNED);
+
+            if (nThread != 1) TSFFTW_plan_with_nthreads(nThread);
+
+            if (fw)
+            {
+                if (nSlc == 1)
+                    plan = TSFFTW_plan_dft_r2c_2d(nRow, nCol, r, c, flags);
+                else
+                    plan = TSFFTW_plan_dft_r2c_3d(nRow, nCol, nSlc, r, c, flags);
+            }
+            else
+            {
+                if (nSlc == 1)
+                    plan = TSFFTW_plan_dft_c2r_2d(nRow, nCol, c, r, flags);
+                else
+                    plan = TSFFTW_plan_dft_c2r_3d(nRow, nCol, nSlc, c, r, flags);
+            }
+
+            if (nThread != 1) TSFFTW_plan_with_nthreads(1);
+
+            TSFFTW_free(r);
+            TSFFTW_free(c);
+
+            if (plan == NULL)
+            {
+                REPORT_ERROR("FAIL TO CREATE FFTW PLAN");
+
+                abort();
+            }
+
+            planCache()[key] = plan;
+        }
+    }
+
+    return plan;
+}
+
 FFT::FFT() : _srcR(NULL),
              _srcC(NULL),
              _dstR(NULL),
@@ -31,14 +158,15 @@ void FFT::fw(Image& img)
     CHECK_SPACE_VALID(_dstC, _srcR);
     ***/
 
-    #pragma omp critical
-    fwPlan = TSFFTW_plan_dft_r2c_2d(img.nRowRL(),
-                                  img.nColRL(),
-                                  _srcR,
-                                  _dstC,
-                                  FFTW_ESTIMATE);
+    fwPlan = cachedPlan(img.nColRL(),
+                        img.nRowRL(),
+                        1,
+                        true,
+                        1,
+                        aligned(_srcR, _dstC),
+                        planRigour);
 
-    TSFFTW_execute(fwPlan);
+    TSFFTW_execute_dft_r2c(fwPlan, _srcR, _dstC);
 
     FW_CLEAN_UP;
 }
@@ -53,14 +181,15 @@ void FFT::bw(Image& img)
     CHECK_SPACE_VALID(_dstR, _srcC);
     ***/
 
-    #pragma omp critical
-    bwPlan = TSFFTW_plan_dft_c2r_2d(img.nRowRL(),
-                                  img.nColRL(),
-                                  _srcC,
-                                  _dstR,
-                                  FFTW_ESTIMATE);
+    bwPlan = cachedPlan(img.nColRL(),
+                        img.nRowRL(),
+                        1,
+                        false,
+                        1,
+                        aligned(_dstR, _srcC),
+                        planRigour);
 
-    TSFFTW_execute(bwPlan);
+    TSFFTW_execute_dft_c2r(bwPlan, _srcC, _dstR);
 
     SCALE_RL(img, 1.0 / img.sizeRL());
 
@@ -71,27 +200,15 @@ void FFT::fw(Volume& vol)
 {
     FW_EXTRACT_P(vol);
 
-    if (vol.nSlcRL() == 1)
-    {
-        #pragma omp critical
-        fwPlan = TSFFTW_plan_dft_r2c_2d(vol.nRowRL(),
-                                      vol.nColRL(),
-                                      _srcR,
-                                      _dstC,
-                                      FFTW_ESTIMATE);
-    }
-    else
-    {
-        #pragma omp critical
-        fwPlan = TSFFTW_plan_dft_r2c_3d(vol.nRowRL(),
-                                      vol.nColRL(),
-                                      vol.nSlcRL(),
-                                      _srcR,
-                                      _dstC,
-                                      FFTW_ESTIMATE);
-    }
+    fwPlan = cachedPlan(vol.nColRL(),
+                        vol.nRowRL(),
+                        vol.nSlcRL(),
+                        true,
+                        1,
+                        aligned(_srcR, _dstC),
+                        planRigour);
 
-    TSFFTW_execute(fwPlan);
+    TSFFTW_execute_dft_r2c(fwPlan, _srcR, _dstC);
 
     FW_CLEAN_UP;
 }
@@ -100,27 +217,15 @@ void FFT::bw(Volume& vol)
 {
     BW_EXTRACT_P(vol);
 
-    if (vol.nSlcRL() == 1)
-    {
-        #pragma omp critical
-        fwPlan = TSFFTW_plan_dft_r2c_2d(vol.nRowRL(),
-                                      vol.nColRL(),
-                                      _srcR,
-                                      _dstC,
-                                      FFTW_ESTIMATE);
-    }
-    else
-    {
-        #pragma omp critical
-        bwPlan = TSFFTW_plan_dft_c2r_3d(vol.nRowRL(),
-                                      vol.nColRL(),
-                                      vol.nSlcRL(),
-                                      _srcC,
-                                      _dstR,
-                                      FFTW_ESTIMATE);
-    }
+    bwPlan = cachedPlan(vol.nColRL(),
+                        vol.nRowRL(),
+                        vol.nSlcRL(),
+                        false,
+                        1,
+                        aligned(_dstR, _srcC),
+                        planRigour);
 
-    TSFFTW_execute(bwPlan);
+    TSFFTW_execute_dft_c2r(bwPlan, _srcC, _dstR);
 
     SCALE_RL(vol, 1.0 / vol.sizeRL());
 
@@ -137,17 +242,15 @@ void FFT::fwMT(Image& img)
     ***/
     FW_EXTRACT_P(img);
 
-    TSFFTW_plan_with_nthreads(omp_get_max_threads());
-
-    fwPlan = TSFFTW_plan_dft_r2c_2d(img.nRowRL(),
-                                  img.nColRL(),
-                                  _srcR,
-                                  _dstC,
-                                  FFTW_ESTIMATE);
+    fwPlan = cachedPlan(img.nColRL(),
+                        img.nRowRL(),
+                        1,
+                        true,
+                        omp_get_max_threads(),
+                        aligned(_srcR, _dstC),
+                        planRigour);
 
-    TSFFTW_plan_with_nthreads(1);
-
-    TSFFTW_execute(fwPlan);
+    TSFFTW_execute_dft_r2c(fwPlan, _srcR, _dstC);
 
     FW_CLEAN_UP_MT;
 }
@@ -162,17 +265,15 @@ void FFT::bwMT(Image& img)
     ***/
     BW_EXTRACT_P(img);
 
-    TSFFTW_plan_with_nthreads(omp_get_max_threads());
+    bwPlan = cachedPlan(img.nColRL(),
+                        img.nRowRL(),
+                        1,
+                        false,
+                        omp_get_max_threads(),
+                        aligned(_dstR, _srcC),
+                        planRigour);
 
-    bwPlan = TSFFTW_plan_dft_c2r_2d(img.nRowRL(),
-                                  img.nColRL(),
-                                  _srcC,
-                                  _dstR,
-                                  FFTW_ESTIMATE);
-
-    TSFFTW_plan_with_nthreads(1);
-
-    TSFFTW_execute(bwPlan);
+    TSFFTW_execute_dft_c2r(bwPlan, _srcC, _dstR);
 
     #pragma omp parallel for
     SCALE_RL(img, 1.0 / img.sizeRL());
@@ -184,25 +285,15 @@ void FFT::fwMT(Volume& vol)
 {
     FW_EXTRACT_P(vol);
 
-    TSFFTW_plan_with_nthreads(omp_get_max_threads());
-
-    if (vol.nSlcRL() == 1)
-        fwPlan = TSFFTW_plan_dft_r2c_2d(vol.nRowRL(),
-                                      vol.nColRL(),
-                                      _srcR,
-                                      _dstC,
-                                      FFTW_ESTIMATE);
-    else
-        fwPlan = TSFFTW_plan_dft_r2c_3d(vol.nRowRL(),
-                                      vol.nColRL(),
-                                      vol.nSlcRL(),
-                                      _srcR,
-                                      _dstC,
-                                      FFTW_ESTIMATE);
+    fwPlan = cachedPlan(vol.nColRL(),
+                        vol.nRowRL(),
+                        vol.nSlcRL(),
+                        true,
+                        omp_get_max_threads(),
+                        aligned(_srcR, _dstC),
+                        planRigour);
 
-    TSFFTW_plan_with_nthreads(1);
-
-    TSFFTW_execute(fwPlan);
+    TSFFTW_execute_dft_r2c(fwPlan, _srcR, _dstC);
 
     FW_CLEAN_UP_MT;
 }
@@ -211,25 +302,15 @@ void FFT::bwMT(Volume& vol)
 {
     BW_EXTRACT_P(vol);
 
-    TSFFTW_plan_with_nthreads(omp_get_max_threads());
-
-    if (vol.nSlcRL() == 1)
-        bwPlan = TSFFTW_plan_dft_c2r_2d(vol.nRowRL(),
-                                      vol.nColRL(),
-                                      _srcC,
-                                      _dstR,
-                                      FFTW_ESTIMATE);
-    else
-        bwPlan = TSFFTW_plan_dft_c2r_3d(vol.nRowRL(),
-                                      vol.nColRL(),
-                                      vol.nSlcRL(),
-                                      _srcC,
-                                      _dstR,
-                                      FFTW_ESTIMATE);
-
-    TSFFTW_plan_with_nthreads(1);
+    bwPlan = cachedPlan(vol.nColRL(),
+                        vol.nRowRL(),
+                        vol.nSlcRL(),
+                        false,
+                        omp_get_max_threads(),
+                        aligned(_dstR, _srcC),
+                        planRigour);
 
-    TSFFTW_execute(bwPlan);
+    TSFFTW_execute_dft_c2r(bwPlan, _srcC, _dstR);
 
     #pragma omp parallel for
     SCALE_RL(vol, 1.0 / vol.sizeRL());
@@ -240,170 +321,118 @@ void FFT::bwMT(Volume& vol)
 void FFT::fwCreatePlan(const int nCol,
                        const int nRow)
 {
-    //fwCreatePlan(nCol, nRow, 1);
-
-    _srcR = (RFLOAT*)TSFFTW_malloc(nCol * nRow * sizeof(RFLOAT));
-    _dstC = (TSFFTW_COMPLEX*)TSFFTW_malloc((nCol / 2 + 1) * nRow * sizeof(Complex));
-
-    fwPlan = fftw_plan_dft_r2c_2d(nRow,
-                                  nCol,
-                                  _srcR,
-                                  _dstC,
-                                  FFTW_MEASURE);
-
-    TSFFTW_free(_srcR);
-    TSFFTW_free(_dstC);
+    fwPlan = cachedPlan(nCol,
+                        nRow,
+                        1,
+                        true,
+                        1,
+                        true,
+                        createRigour());
 }
 
 void FFT::fwCreatePlan(const int nCol,
                        const int nRow,
                        const int nSlc)
 {
-    _srcR = (RFLOAT*)TSFFTW_malloc(nCol * nRow * nSlc * sizeof(RFLOAT));
-    _dstC = (TSFFTW_COMPLEX*)TSFFTW_malloc((nCol / 2 + 1) * nRow * nSlc * sizeof(Complex));
-
-    fwPlan = fftw_plan_dft_r2c_3d(nRow,
-                                  nCol,
-                                  nSlc,
-                                  _srcR,
-                                  _dstC,
-                                  FFTW_MEASURE);
-
-    TSFFTW_free(_srcR);
-    TSFFTW_free(_dstC);
+    fwPlan = cachedPlan(nCol,
+                        nRow,
+                        nSlc,
+                        true,
+                        1,
+                        true,
+                        createRigour());
 }
 
 void FFT::bwCreatePlan(const int nCol,
                        const int nRow)
 {
-    // bwCreatePlan(nCol, nRow, 1);
-
-    _srcC = (TSFFTW_COMPLEX*)TSFFTW_malloc((nCol / 2 + 1) * nRow * sizeof(Complex));
-    _dstR = (RFLOAT*)TSFFTW_malloc(nCol * nRow * sizeof(RFLOAT));
-
-    #pragma omp critical
-    bwPlan = fftw_plan_dft_c2r_2d(nRow,
-                                  nCol,
-                                  _srcC,
-                                  _dstR,
-                                  FFTW_MEASURE);
-
-    TSFFTW_free(_srcC);
-    TSFFTW_free(_dstR);
+    bwPlan = cachedPlan(nCol,
+                        nRow,
+                        1,
+                        false,
+                        1,
+                        true,
+                        createRigour());
 }
 
 void FFT::bwCreatePlan(const int nCol,
                        const int nRow,
                        const int nSlc)
 {
-    _srcC = (TSFFTW_COMPLEX*)TSFFTW_malloc((nCol / 2 + 1) * nRow * nSlc * sizeof(Complex));
-    _dstR = (RFLOAT*)TSFFTW_malloc(nCol * nRow * nSlc * sizeof(RFLOAT));
-
-    #pragma omp critical
-    bwPlan = fftw_plan_dft_c2r_3d(nRow,
-                                  nCol,
-                                  nSlc,
-                                  _srcC,
-                                  _dstR,
-                                  FFTW_MEASURE);
-
-    TSFFTW_free(_srcC);
-    TSFFTW_free(_dstR);
+    bwPlan = cachedPlan(nCol,
+                        nRow,
+                        nSlc,
+                        false,
+                        1,
+                        true,
+                        createRigour());
 }
 
 void FFT::fwCreatePlanMT(const int nCol,
                          const int nRow)
 {
-    //fwCreatePlanMT(nCol, nRow, 1);
-
-    _srcR = (RFLOAT*)TSFFTW_malloc(nCol * nRow * sizeof(RFLOAT));
-    _dstC = (TSFFTW_COMPLEX*)TSFFTW_malloc((nCol / 2 + 1) * nRow * sizeof(Complex));
-
-    TSFFTW_plan_with_nthreads(omp_get_max_threads());
-
-    fwPlan = fftw_plan_dft_r2c_2d(nRow,
-                                  nCol,
-                                  _srcR,
-                                  _dstC,
-                                  FFTW_MEASURE);
-
-    TSFFTW_plan_with_nthreads(1);
-
-    TSFFTW_free(_srcR);
-    TSFFTW_free(_dstC);
+    fwPlan = cachedPlan(nCol,
+                        nRow,
+                        1,
+                        true,
+                        omp_get_max_threads(),
+                        true,
+                        createRigour());
 }
 
 void FFT::fwCreatePlanMT(const int nCol,
                          const int nRow,
                          const int nSlc)
 {
-    _srcR = (RFLOAT*)TSFFTW_malloc(nCol * nRow * nSlc * sizeof(RFLOAT));
-    _dstC = (TSFFTW_COMPLEX*)TSFFTW_malloc((nCol / 2 + 1) * nRow * nSlc * sizeof(Complex));
-
-    TSFFTW_plan_with_nthreads(omp_get_max_threads());
-
-    fwPlan = fftw_plan_dft_r2c_3d(nRow,
-                                  nCol,
-                                  nSlc,
-                                  _srcR,
-                                  _dstC,
-                                  FFTW_MEASURE);
-
-    TSFFTW_plan_with_nthreads(1);
-
-    TSFFTW_free(_srcR);
-    TSFFTW_free(_dstC);
+    fwPlan = cachedPlan(nCol,
+                        nRow,
+                        nSlc,
+                        true,
+                        omp_get_max_threads(),
+                        true,
+                        createRigour());
 }
 
 void FFT::bwCreatePlanMT(const int nCol,
                          const int nRow)
 {
-    //bwCreatePlanMT(nCol, nRow, 1);
-
-    _srcC = (TSFFTW_COMPLEX*)TSFFTW_malloc((nCol / 2 + 1) * nRow * sizeof(Complex));
-    _dstR = (RFLOAT*)TSFFTW_malloc(nCol * nRow * sizeof(RFLOAT));
- 
-    TSFFTW_plan_with_nthreads(omp_get_max_threads());
-
-    bwPlan = fftw_plan_dft_c2r_2d(nRow,
-                                  nCol,
-                                  _srcC,
-                                  _dstR,
-                                  FFTW_MEASURE);
-
-    TSFFTW_plan_with_nthreads(1);
-
-    TSFFTW_free(_srcC);
-    TSFFTW_free(_dstR);
+    bwPlan = cachedPlan(nCol,
+                        nRow,
+                        1,
+                        false,
+                        omp_get_max_threads(),
+                        true,
+                        createRigour());
 }
 
 void FFT::bwCreatePlanMT(const int nCol,
                          const int nRow,
                          const int nSlc)
 {
-    _srcC = (TSFFTW_COMPLEX*)TSFFTW_malloc((nCol / 2 + 1) * nRow * nSlc * sizeof(Complex));
-    _dstR = (RFLOAT*)TSFFTW_malloc(nCol * nRow * nSlc * sizeof(RFLOAT));
-
-    TSFFTW_plan_with_nthreads(omp_get_max_threads());
-
-    bwPlan = fftw_plan_dft_c2r_3d(nRow,
-                                  nCol,
-                                  nSlc,
-                                  _srcC,
-                                  _dstR,
-                                  FFTW_MEASURE);
-
-    TSFFTW_plan_with_nthreads(1);
-
-    TSFFTW_free(_srcC);
-    TSFFTW_free(_dstR);
+    bwPlan = cachedPlan(nCol,
+                        nRow,
+                        nSlc,
+                        false,
+                        omp_get_max_threads(),
+                        true,
+                        createRigour());
 }
 
 void FFT::fwExecutePlan(Image& img)
 {
     FW_EXTRACT_P(img);
 
-    TSFFTW_execute_dft_r2c(fwPlan, _srcR, _dstC);
+    TSFFTW_PLAN plan = aligned(_srcR, _dstC)
+                     ? fwPlan
+                     : cachedPlan(img.nColRL(),
+                                  img.nRowRL(),
+                                  1,
+                                  true,
+                                  1,
+                                  false,
+                                  createRigour());
+
+    TSFFTW_execute_dft_r2c(plan, _srcR, _dstC);
 
     _srcR = NULL;
     _dstC = NULL;
@@ -413,7 +442,17 @@ void FFT::fwExecutePlan(Volume& vol)
 {
     FW_EXTRACT_P(vol);
 
-    TSFFTW_execute_dft_r2c(fwPlan, _srcR, _dstC);
+    TSFFTW_PLAN plan = aligned(_srcR, _dstC)
+                     ? fwPlan
+                     : cachedPlan(vol.nColRL(),
+                                  vol.nRowRL(),
+                                  vol.nSlcRL(),
+                                  true,
+                                  1,
+                                  false,
+                                  createRigour());
+
+    TSFFTW_execute_dft_r2c(plan, _srcR, _dstC);
 
     _srcR = NULL;
     _dstC = NULL;
@@ -423,7 +462,17 @@ void FFT::bwExecutePlan(Image& img)
 {
     BW_EXTRACT_P(img);
 
-    TSFFTW_execute_dft_c2r(bwPlan, _srcC, _dstR);
+    TSFFTW_PLAN plan = aligned(_dstR, _srcC)
+                     ? bwPlan
+                     : cachedPlan(img.nColRL(),
+                                  img.nRowRL(),
+                                  1,
+                                  false,
+                                  1,
+                                  false,
+                                  createRigour());
+
+    TSFFTW_execute_dft_c2r(plan, _srcC, _dstR);
 
     SCALE_RL(img, 1.0 / img.sizeRL());
 
@@ -437,7 +486,17 @@ void FFT::bwExecutePlan(Volume& vol)
 {
     BW_EXTRACT_P(vol);
 
-    TSFFTW_execute_dft_c2r(bwPlan, _srcC, _dstR);
+    TSFFTW_PLAN plan = aligned(_dstR, _srcC)
+                     ? bwPlan
+                     : cachedPlan(vol.nColRL(),
+                                  vol.nRowRL(),
+                                  vol.nSlcRL(),
+                                  false,
+                                  1,
+                                  false,
+                                  createRigour());
+
+    TSFFTW_execute_dft_c2r(plan, _srcC, _dstR);
 
     SCALE_RL(vol, 1.0 / vol.sizeRL());
 
@@ -451,7 +510,17 @@ void FFT::fwExecutePlanMT(Image& img)
 {
     FW_EXTRACT_P(img);
 
-    TSFFTW_execute_dft_r2c(fwPlan, _srcR, _dstC);
+    TSFFTW_PLAN plan = aligned(_srcR, _dstC)
+                     ? fwPlan
+                     : cachedPlan(img.nColRL(),
+                                  img.nRowRL(),
+                                  1,
+                                  true,
+                                  omp_get_max_threads(),
+                                  false,
+                                  createRigour());
+
+    TSFFTW_execute_dft_r2c(plan, _srcR, _dstC);
 
     _srcR = NULL;
     _dstC = NULL;
@@ -461,7 +530,17 @@ void FFT::fwExecutePlanMT(Volume& vol)
 {
     FW_EXTRACT_P(vol);
 
-    TSFFTW_execute_dft_r2c(fwPlan, _srcR, _dstC);
+    TSFFTW_PLAN plan = aligned(_srcR, _dstC)
+                     ? fwPlan
+                     : cachedPlan(vol.nColRL(),
+                                  vol.nRowRL(),
+                                  vol.nSlcRL(),
+                                  true,
+                                  omp_get_max_threads(),
+                                  false,
+                                  createRigour());
+
+    TSFFTW_execute_dft_r2c(plan, _srcR, _dstC);
 
     _srcR = NULL;
     _dstC = NULL;
@@ -471,7 +550,17 @@ void FFT::bwExecutePlanMT(Image& img)
 {
     BW_EXTRACT_P(img);
 
-    TSFFTW_execute_dft_c2r(bwPlan, _srcC, _dstR);
+    TSFFTW_PLAN plan = aligned(_dstR, _srcC)
+                     ? bwPlan
+                     : cachedPlan(img.nColRL(),
+                                  img.nRowRL(),
+                                  1,
+                                  false,
+                                  omp_get_max_threads(),
+                                  false,
+                                  createRigour());
+
+    TSFFTW_execute_dft_c2r(plan, _srcC, _dstR);
 
     #pragma omp parallel for
     SCALE_RL(img, 1.0 / img.sizeRL());
@@ -486,7 +575,17 @@ void FFT::bwExecutePlanMT(Volume& vol)
 {
     BW_EXTRACT_P(vol);
 
-    TSFFTW_execute_dft_c2r(bwPlan, _srcC, _dstR);
+    TSFFTW_PLAN plan = aligned(_dstR, _srcC)
+                     ? bwPlan
+                     : cachedPlan(vol.nColRL(),
+                                  vol.nRowRL(),
+                                  vol.nSlcRL(),
+                                  false,
+                                  omp_get_max_threads(),
+                                  false,
+                                  createRigour());
+
+    TSFFTW_execute_dft_c2r(plan, _srcC, _dstR);
 
     #pragma omp parallel for
     SCALE_RL(vol, 1.0 / vol.sizeRL());
@@ -497,24 +596,81 @@ void FFT::bwExecutePlanMT(Volume& vol)
     vol.clearFT();
 }
 
+void FFT::bwExecutePlan(Complex* src,
+                        RFLOAT* dst)
+{
+    _srcC = (TSFFTW_COMPLEX*)src;
+    _dstR = dst;
+
+    CHECK_SPACE_VALID(_dstR, _srcC);
+
+    if (!aligned(_dstR, _srcC))
+    {
+        REPORT_ERROR("FFT NEEDS ALIGNED ARRAYS");
+
+        abort();
+    }
+
+    TSFFTW_execute_dft_c2r(bwPlan, _srcC, _dstR);
+
+    _srcC = NULL;
+    _dstR = NULL;
+}
+
 void FFT::fwDestroyPlan()
 {
-    #pragma omp critical
-    TSFFTW_destroy_plan(fwPlan);
+    // the plan is kept in the plan cache, until destroyPlans
 }
 
 void FFT::bwDestroyPlan()
 {
-    #pragma omp critical
-    TSFFTW_destroy_plan(bwPlan);
+    // the plan is kept in the plan cache, until destroyPlans
 }
 
 void FFT::fwDestroyPlanMT()
 {
-    TSFFTW_destroy_plan(fwPlan);
+    // the plan is kept in the plan cache, until destroyPlans
 }
 
 void FFT::bwDestroyPlanMT()
 {
-    TSFFTW_destroy_plan(bwPlan);
+    // the plan is kept in the plan cache, until destroyPlans
+}
+
+void FFT::setPlanRigour(const unsigned rigour)
+{
+    planRigour = rigour;
+}
+
+bool FFT::importWisdom(const char* filename)
+{
+    bool success;
+
+    #pragma omp critical (FFTPlanCache)
+    success = (TSFFTW_import_wisdom_from_filename(filename) != 0);
+
+    return success;
+}
+
+bool FFT::exportWisdom(const char* filename)
+{
+    bool success;
+
+    #pragma omp critical (FFTPlanCache)
+    success = (TSFFTW_export_wisdom_to_filename(filename) != 0);
+
+    return success;
+}
+
+void FFT::destroyPlans()
+{
+    #pragma omp critical (FFTPlanCache)
+    {
+        std::map<FFTPlanKey, TSFFTW_PLAN>::iterator it;
+
+        for (it = planCache().begin(); it != planCache().end(); it++)
+            TSFFTW_destroy_plan(it->second);
+
+        planCache().clear();
+    }
 }
@@ -107,6 +107,32 @@ void ringAverage(vec& dst,
         dst(i) /= counter(i);
 }
 
+void ringAverage(vec& dst,
+                 const RealHalfVolume& src,
+                 const int r)
+{
+    dst.setZero();
+
+    uvec counter = uvec::Zero(dst.size());
+
+    IMAGE_FOR_EACH_PIXEL_FT(src)
+    {
+        if (QUAD(i, j) < TSGSL_pow_2(r))
+        {
+            int u = AROUND(NORM(i, j));
+
+            if (u < r)
+            {
+                dst(u) += src.getFTHalf(i, j);
+                counter(u) += 1;
+            }
+        }
+    }
+
+    for (int i = 0; i < r; i++)
+        dst(i) /= counter(i);
+}
+
 RFLOAT shellAverage(const int resP,
                     const Volume& vol,
                     const function<RFLOAT(const Complex)> func)
@@ -155,6 +181,36 @@ void shellAverage(vec& dst,
         dst(i) /= counter(i);
 }
 
+void shellAverage(vec& dst,
+                  const RealHalfVolume& src,
+                  const int r)
+{
+    dst.setZero();
+
+    uvec counter = uvec::Zero(dst.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    VOLUME_FOR_EACH_PIXEL_FT(src)
+    {
+        if (QUAD_3(i, j, k) < TSGSL_pow_2(r))
+        {
+            int u = AROUND(NORM_3(i, j, k));
+
+            if (u < r)
+            {
+                #pragma omp atomic
+                dst(u) += src.getFTHalf(i, j, k);
+                #pragma omp atomic
+                counter(u) += 1;
+            }
+        }
+    }
+
+    #pragma omp parallel for
+    for (int i = 0; i < r; i++)
+        dst(i) /= counter(i);
+}
+
 void powerSpectrum(vec& dst,
                    const Image& src,
                    const int r)
@@ -0,0 +1,314 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependency:
+ * Test:
+ * Execution:
+ * Description:
+ *
+ * Manual:
+ * ****************************************************************************/
+
+#include "Symmetrizer.h"
+
+static inline void setZero(Complex& v) { v = COMPLEX(0, 0); }
+
+static inline void setZero(RFLOAT& v) { v = 0; }
+
+static inline Complex conjugate(const Complex v) { return CONJUGATE(v); }
+
+static inline RFLOAT conjugate(const RFLOAT v) { return v; }
+
+/**
+ * This function interpolates a volume by a stencil, in the same order of
+ * summation as getByInterpolationFT of SphereVolume and RealHalfVolume.
+ */
+template <typename T>
+static inline T gather(const T* src,
+                       const SymmetryStencil& s)
+{
+    RFLOAT w[2][2][2];
+
+    W_TRI_INTERP_LINEAR(w, s.xd);
+
+    T result;
+
+    setZero(result);
+
+    for (int k = 0; k < 2; k++)
+        for (int j = 0; j < 2; j++)
+        {
+            const T* data = src + s.index[j + 2 * k];
+
+            for (int i = 0; i < 2; i++)
+                if (s.mask & (1 << (i + 2 * j + 4 * k)))
+                    result += data[i] * w[k][j][i];
+        }
+
+    return s.conj ? conjugate(result) : result;
+}
+
+Symmetrizer::Symmetrizer()
+{
+    _sym = NULL;
+
+    _pgGroup = 0;
+    _pgOrder = 0;
+
+    _nSymmetryElement = 0;
+
+    _nCol = 0;
+    _nRow = 0;
+    _nSlc = 0;
+
+    _sphere = 0;
+
+    _r = 0;
+
+    _cached = false;
+}
+
+void Symmetrizer::clear()
+{
+    _sym = NULL;
+
+    _nSymmetryElement = 0;
+
+    _R.clear();
+
+    _nVoxel.clear();
+    _voxelOffset.clear();
+
+    _stencil.clear();
+    _stencil.shrink_to_fit();
+
+    _cached = false;
+}
+
+void Symmetrizer::init(const Symmetry& sym,
+                       const SphereIndex& index,
+                       const int nCol,
+                       const int nRow,
+                       const int nSlc,
+                       const RFLOAT r,
+                       const size_t memory)
+{
+    bool same = (_sym == &sym) &&
+                (_pgGroup == sym.pgGroup()) &&
+                (_pgOrder == sym.pgOrder()) &&
+                (_nCol == nCol) &&
+                (_nRow == nRow) &&
+                (_nSlc == nSlc) &&
+                (_sphere == index.radius()) &&
+                (_r == r);
+
+    size_t nStencil = _nVoxel.empty()
+                    ? 0
+                    : (_voxelOffset.back() + _nVoxel.back()) * _nSymmetryElement;
+
+    // keep the stencils, unless they are not cached but fit in now
+
+    if (same && (_cached || nStencil * sizeof(SymmetryStencil) > memory)) return;
+
+    clear();
+
+    _sym = &sym;
+
+    _pgGroup = sym.pgGroup();
+    _pgOrder = sym.pgOrder();
+
+    _nSymmetryElement = sym.nSymmetryElement();
+
+    mat33 L, R;
+
+    for (int l = 0; l < _nSymmetryElement; l++)
+    {
+        sym.get(L, R, l);
+
+        _R.push_back(R);
+    }
+
+    _nCol = nCol;
+    _nRow = nRow;
+    _nSlc = nSlc;
+
+    _sphere = index.radius();
+
+    _r = r;
+
+    _nVoxel.resize(index.nRowFT());
+    _voxelOffset.resize(index.nRowFT());
+
+    size_t nVoxelTotal = 0;
+
+    for (size_t row = 0; row < index.nRowFT(); row++)
+    {
+        _nVoxel[row] = nVoxel(index, row);
+        _voxelOffset[row] = nVoxelTotal;
+
+        nVoxelTotal += _nVoxel[row];
+    }
+
+    nStencil = nVoxelTotal * _nSymmetryElement;
+
+    _cached = (nStencil * sizeof(SymmetryStencil) <= memory);
+
+    if (!_cached) return;
+
+    _stencil.resize(nStencil);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t row = 0; row < index.nRowFT(); row++)
+    {
+        int j = row % _nRow;
+        int k = row / _nRow;
+
+        if (j >= _nRow / 2) j -= _nRow;
+        if (k >= _nSlc / 2) k -= _nSlc;
+
+        SymmetryStencil* s = _stencil.data() + _voxelOffset[row] * _nSymmetryElement;
+
+        for (int i = 0; i < _nVoxel[row]; i++)
+            for (int l = 0; l < _nSymmetryElement; l++)
+                stencil(*(s++), index, l, i, j, k);
+    }
+}
+
+void Symmetrizer::apply(SphereVolume& dst,
+                        const SphereVolume& src) const
+{
+    SphereVolume result(src.nColRL(), src.nRowRL(), src.nSlcRL(), src.radius());
+
+    symmetrize(&result[0], &src[0], src.index());
+
+    // a volume on a buffer owned by others keeps working on the buffer
+
+    if (dst.own())
+        dst.swap(result);
+    else
+        memcpy(&dst[0], &result[0], result.sizeFT() * sizeof(Complex));
+}
+
+void Symmetrizer::apply(RealHalfVolume& dst,
+                        const RealHalfVolume& src) const
+{
+    RealHalfVolume result(src.nColRL(), src.nRowRL(), src.nSlcRL(), src.radius());
+
+    symmetrize(&result[0], &src[0], src.index());
+
+    // a volume on a buffer owned by others keeps working on the buffer
+
+    if (dst.own())
+        dst.swap(result);
+    else
+        memcpy(&dst[0], &result[0], result.sizeFT() * sizeof(RFLOAT));
+}
+
+void Symmetrizer::stencil(SymmetryStencil& dst,
+                          const SphereIndex& index,
+                          const int l,
+                          const int i,
+                          const int j,
+                          const int k) const
+{
+    vec3 newCor((RFLOAT)i, (RFLOAT)j, (RFLOAT)k);
+    vec3 oldCor = _R[l] * newCor;
+
+    dst.valid = (oldCor.squaredNorm() < gsl_pow_2(_r));
+
+    if (!dst.valid) return;
+
+    RFLOAT x[3] = {oldCor(0), oldCor(1), oldCor(2)};
+
+    dst.conj = conjHalf(x[0], x[1], x[2]);
+
+    int x0[3];
+
+    for (int d = 0; d < 3; d++)
+    {
+        x0[d] = floor(x[d]);
+        dst.xd[d] = x[d] - x0[d];
+    }
+
+    dst.mask = 0;
+
+    for (int kk = 0; kk < 2; kk++)
+        for (int jj = 0; jj < 2; jj++)
+        {
+            size_t row = index.iRowFT(x0[1] + jj, x0[2] + kk);
+
+            int len = index.len(row);
+
+            dst.index[jj + 2 * kk] = index.offset(row) + x0[0];
+
+            for (int ii = 0; ii < 2; ii++)
+                if (x0[0] + ii < len)
+                    dst.mask |= 1 << (ii + 2 * jj + 4 * kk);
+        }
+}
+
+int Symmetrizer::nVoxel(const SphereIndex& index,
+                        const size_t row) const
+{
+    int j = row % _nRow;
+    int k = row / _nRow;
+
+    if (j >= _nRow / 2) j -= _nRow;
+    if (k >= _nSlc / 2) k -= _nSlc;
+
+    // a rotated coordinate is inside the radius only if the voxel is, up to
+    // the rounding error of rotation, thus one more voxel is taken
+
+    RFLOAT q = gsl_pow_2(_r + 1) - QUAD(j, k);
+
+    if (q < 0) return 0;
+
+    return GSL_MIN_INT(index.len(row), (int)sqrt(q) + 1);
+}
+
+template <typename T>
+void Symmetrizer::symmetrize(T* dst,
+                             const T* src,
+                             const SphereIndex& index) const
+{
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t row = 0; row < index.nRowFT(); row++)
+    {
+        int j = row % _nRow;
+        int k = row / _nRow;
+
+        if (j >= _nRow / 2) j -= _nRow;
+        if (k >= _nSlc / 2) k -= _nSlc;
+
+        size_t offset = index.offset(row);
+
+        int len = index.len(row);
+
+        const SymmetryStencil* cache = _cached
+                                     ? _stencil.data() + _voxelOffset[row] * _nSymmetryElement
+                                     : NULL;
+
+        SymmetryStencil s;
+
+        for (int i = 0; i < len; i++)
+        {
+            T v = src[offset + i];
+
+            if (i < _nVoxel[row])
+                for (int l = 0; l < _nSymmetryElement; l++)
+                {
+                    const SymmetryStencil* p = &s;
+
+                    if (_cached)
+                        p = cache++;
+                    else
+                        stencil(s, index, l, i, j, k);
+
+                    if (p->valid) v += gather(src, *p);
+                }
+
+            dst[offset + i] = v;
+        }
+    }
+}
@@ -12,6 +12,133 @@
 
 #include "ImageFunctions.h"
 
+/**
+ * The phase shift of a translation, exp(-2 * pi * i * (iCol * tCol / nCol +
+ * iRow * tRow / nRow)), is the product of a factor depending only on the column
+ * and a factor depending only on the row. Thus, sine and cosine are only
+ * evaluated on the 1-D phase vectors of columns and rows, and the phase shift
+ * of each pixel is assembled by one complex multiplication.
+ */
+class PhaseVectors
+{
+    private:
+
+        int _colMin;
+        int _rowMin;
+
+        vector<RFLOAT> _colRe;
+        vector<RFLOAT> _colIm;
+        vector<RFLOAT> _rowRe;
+        vector<RFLOAT> _rowIm;
+
+        static void phaseVector(vector<RFLOAT>& re,
+                                vector<RFLOAT>& im,
+                                const int min,
+                                const RFLOAT r)
+        {
+            for (size_t k = 0; k < re.size(); k++)
+            {
+                RFLOAT phase = 2 * M_PI * (min + (int)k) * r;
+
+                re[k] = cos(phase);
+                im[k] = -sin(phase);
+            }
+        }
+
+    public:
+
+        /**
+         * covering the columns and rows of the given pixels
+         */
+        PhaseVectors(const int* iCol,
+                     const int* iRow,
+                     const int nPxl)
+        {
+            int colMax = 0;
+            int rowMax = 0;
+
+            _colMin = 0;
+            _rowMin = 0;
+
+            for (int i = 0; i < nPxl; i++)
+            {
+                _colMin = GSL_MIN_INT(_colMin, iCol[i]);
+                colMax = GSL_MAX_INT(colMax, iCol[i]);
+                _rowMin = GSL_MIN_INT(_rowMin, iRow[i]);
+                rowMax = GSL_MAX_INT(rowMax, iRow[i]);
+            }
+
+            _colRe.resize(colMax - _colMin + 1);
+            _colIm.resize(colMax - _colMin + 1);
+            _rowRe.resize(rowMax - _rowMin + 1);
+            _rowIm.resize(rowMax - _rowMin + 1);
+        }
+
+        void set(const RFLOAT nTransCol,
+                 const RFLOAT nTransRow,
+                 const int nCol,
+                 const int nRow)
+        {
+            phaseVector(_colRe, _colIm, _colMin, nTransCol / nCol);
+            phaseVector(_rowRe, _rowIm, _rowMin, nTransRow / nRow);
+        }
+
+        inline void get(RFLOAT& re,
+                        RFLOAT& im,
+                        const int iCol,
+                        const int iRow) const
+        {
+            RFLOAT cRe = _colRe[iCol - _colMin];
+            RFLOAT cIm = _colIm[iCol - _colMin];
+            RFLOAT rRe = _rowRe[iRow - _rowMin];
+            RFLOAT rIm = _rowIm[iRow - _rowMin];
+
+            re = cRe * rRe - cIm * rIm;
+            im = cRe * rIm + cIm * rRe;
+        }
+
+        inline Complex get(const int iCol,
+                           const int iRow) const
+        {
+            RFLOAT re, im;
+
+            get(re, im, iCol, iRow);
+
+            return COMPLEX(re, im);
+        }
+};
+
+template <typename F>
+static void translateSeparable(F* dstRe,
+                               F* dstIm,
+                               const mat2& tra,
+                               const int nCol,
+                               const int nRow,
+                               const int* iCol,
+                               const int* iRow,
+                               const int nPxl)
+{
+    PhaseVectors pv(iCol, iRow, nPxl);
+
+    for (int t = 0; t < tra.rows(); t++)
+    {
+        pv.set(tra(t, 0), tra(t, 1), nCol, nRow);
+
+        F* re = dstRe + (size_t)t * nPxl;
+        F* im = dstIm + (size_t)t * nPxl;
+
+        for (int i = 0; i < nPxl; i++)
+        {
+            RFLOAT r, m;
+
+            pv.get(r, m, iCol[i], iRow[i]);
+
+            re[i] = r;
+            im[i] = m;
+        }
+    }
+}
+
 void mul(Image& dst,
          const Image& a,
          const Image& b,
@@ -112,14 +239,12 @@ void translate(Image& dst,
                const int* iPxl,
                const int nPxl)
 {
-    RFLOAT rCol = nTransCol / dst.nColRL();
-    RFLOAT rRow = nTransRow / dst.nRowRL();
+    PhaseVectors pv(iCol, iRow, nPxl);
+
+    pv.set(nTransCol, nTransRow, dst.nColRL(), dst.nRowRL());
 
     for (int i = 0; i < nPxl; i++)
-    {
-        RFLOAT phase = 2 * M_PI * (iCol[i] * rCol + iRow[i] * rRow);
-        dst[iPxl[i]] = COMPLEX_POLAR(-phase);
-    }
+        dst[iPxl[i]] = pv.get(iCol[i], iRow[i]);
 }
 
 void translateMT(Image& dst,
@@ -150,14 +275,70 @@ void translate(Complex* dst,
                const int* iRow,
                const int nPxl)
 {
-    RFLOAT rCol = nTransCol / nCol;
-    RFLOAT rRow = nTransRow / nRow;
+    PhaseVectors pv(iCol, iRow, nPxl);
+
+    pv.set(nTransCol, nTransRow, nCol, nRow);
 
     for (int i = 0; i < nPxl; i++)
-    {
-        RFLOAT phase = 2 * M_PI * (iCol[i] * rCol + iRow[i] * rRow);
-        dst[i] = COMPLEX_POLAR(-phase);
-    }
+        dst[i] = pv.get(iCol[i], iRow[i]);
+}
+
+void translate(RFLOAT* dstRe,
+               RFLOAT* dstIm,
+               const RFLOAT nTransCol,
+               const RFLOAT nTransRow,
+               const int nCol,
+               const int nRow,
+               const int* iCol,
+               const int* iRow,
+               const int nPxl)
+{
+    mat2 tra(1, 2);
+
+    tra << nTransCol, nTransRow;
+
+    translateSeparable(dstRe, dstIm, tra, nCol, nRow, iCol, iRow, nPxl);
+}
+
+void translate(float* dstRe,
+               float* dstIm,
+               const RFLOAT nTransCol,
+               const RFLOAT nTransRow,
+               const int nCol,
+               const int nRow,
+               const int* iCol,
+               const int* iRow,
+               const int nPxl)
+{
+    mat2 tra(1, 2);
+
+    tra << nTransCol, nTransRow;
+
+    translateSeparable(dstRe, dstIm, tra, nCol, nRow, iCol, iRow, nPxl);
+}
+
+void translate(RFLOAT* dstRe,
+               RFLOAT* dstIm,
+               const mat2& tra,
+               const int nCol,
+               const int nRow,
+               const int* iCol,
+               const int* iRow,
+               const int nPxl)
+{
+    translateSeparable(dstRe, dstIm, tra, nCol, nRow, iCol, iRow, nPxl);
+}
+
+void translate(float* dstRe,
+               float* dstIm,
+               const mat2& tra,
+               const int nCol,
+               const int nRow,
+               const int* iCol,
+               const int* iRow,
+               const int nPxl)
+{
+    translateSeparable(dstRe, dstIm, tra, nCol, nRow, iCol, iRow, nPxl);
 }
 
 void translateMT(Complex* dst,
@@ -255,15 +436,12 @@ void translate(Image& dst,
                const int* iPxl,
                const int nPxl)
 {
-    RFLOAT rCol = nTransCol / src.nColRL();
-    RFLOAT rRow = nTransRow / src.nRowRL();
+    PhaseVectors pv(iCol, iRow, nPxl);
 
-    for (int i = 0; i < nPxl; i++)
-    {
-        RFLOAT phase = 2 * M_PI * (iCol[i] * rCol + iRow[i] * rRow);
+    pv.set(nTransCol, nTransRow, src.nColRL(), src.nRowRL());
 
-        dst[iPxl[i]] = src.iGetFT(iPxl[i]) * COMPLEX_POLAR(-phase);
-    }
+    for (int i = 0; i < nPxl; i++)
+        dst[iPxl[i]] = src.iGetFT(iPxl[i]) * pv.get(iCol[i], iRow[i]);
 }
 
 void translateMT(Image& dst,
@@ -297,15 +475,12 @@ void translate(Complex* dst,
                const int* iRow,
                const int nPxl)
 {
-    RFLOAT rCol = nTransCol / nCol;
-    RFLOAT rRow = nTransRow / nRow;
+    PhaseVectors pv(iCol, iRow, nPxl);
 
-    for (int i = 0; i < nPxl; i++)
-    {
-        RFLOAT phase = 2 * M_PI * (iCol[i] * rCol + iRow[i] * rRow);
+    pv.set(nTransCol, nTransRow, nCol, nRow);
 
-        dst[i] = src[i] * COMPLEX_POLAR(-phase);
-    }
+    for (int i = 0; i < nPxl; i++)
+        dst[i] = src[i] * pv.get(iCol[i], iRow[i]);
 }
 
 void translateMT(Complex* dst,
@@ -0,0 +1,218 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependency:
+ * Test:
+ * Execution:
+ * Description:
+ *
+ * Manual:
+ * ****************************************************************************/
+
+#include "RealHalfVolume.h"
+
+RealHalfVolume::RealHalfVolume()
+{
+    _data = NULL;
+
+    _own = true;
+
+    _nCol = 0;
+    _nRow = 0;
+    _nSlc = 0;
+}
+
+RealHalfVolume::RealHalfVolume(const int nCol,
+                               const int nRow,
+                               const int nSlc,
+                               const int r)
+{
+    _data = NULL;
+
+    _own = true;
+
+    alloc(nCol, nRow, nSlc, r);
+}
+
+RealHalfVolume::~RealHalfVolume()
+{
+    clear();
+}
+
+void RealHalfVolume::swap(RealHalfVolume& that)
+{
+    std::swap(_data, that._data);
+    std::swap(_own, that._own);
+    std::swap(_nCol, that._nCol);
+    std::swap(_nRow, that._nRow);
+    std::swap(_nSlc, that._nSlc);
+
+    _index.swap(that._index);
+}
+
+void RealHalfVolume::alloc(const int nCol,
+                           const int nRow,
+                           const int nSlc,
+                           const int r)
+{
+    clear();
+
+    _nCol = nCol;
+    _nRow = nRow;
+    _nSlc = nSlc;
+
+    _index.alloc(nCol, nRow, nSlc, r);
+
+    _data = (RFLOAT*)TSFFTW_malloc(_index.size() * sizeof(RFLOAT));
+
+    if (_data == NULL)
+    {
+        REPORT_ERROR("FAIL TO ALLOCATE SPACE");
+
+        abort();
+    }
+}
+
+void RealHalfVolume::attach(RFLOAT* data,
+                            const int nCol,
+                            const int nRow,
+                            const int nSlc,
+                            const int r)
+{
+    clear();
+
+    _nCol = nCol;
+    _nRow = nRow;
+    _nSlc = nSlc;
+
+    _index.alloc(nCol, nRow, nSlc, r);
+
+    _data = data;
+
+    _own = false;
+}
+
+void RealHalfVolume::clear()
+{
+    if ((_data != NULL) && _own) TSFFTW_free(_data);
+
+    _data = NULL;
+
+    _own = true;
+
+    _index.clear();
+}
+
+void RealHalfVolume::addFT(const RFLOAT value,
+                           const int iCol,
+                           const int iRow,
+                           const int iSlc)
+{
+    int i = iCol, j = iRow, k = iSlc;
+
+    conjHalf(i, j, k);
+
+    if (!_index.inside(i, j, k)) return;
+
+    #pragma omp atomic
+    _data[_index.index(i, j, k)] += value;
+}
+
+void RealHalfVolume::addFT(const RFLOAT value,
+                           RFLOAT iCol,
+                           RFLOAT iRow,
+                           RFLOAT iSlc)
+{
+    conjHalf(iCol, iRow, iSlc);
+
+    if (_nSlc == 1)
+    {
+        RFLOAT w[2][2];
+        int x0[2];
+        RFLOAT x[2] = {iCol, iRow};
+
+        WG_BI_INTERP_LINEAR(w, x0, x);
+
+        FOR_CELL_DIM_2
+            if (_index.inside(x0[0] + i, x0[1] + j))
+            {
+                #pragma omp atomic
+                _data[_index.index(x0[0] + i, x0[1] + j)] += value * w[j][i];
+            }
+    }
+    else
+    {
+        RFLOAT w[2][2][2];
+        int x0[3];
+        RFLOAT x[3] = {iCol, iRow, iSlc};
+
+        WG_TRI_INTERP_LINEAR(w, x0, x);
+
+        // the two voxels of a cell in the same row are adjacent in the storage
+
+        for (int k = 0; k < 2; k++)
+            for (int j = 0; j < 2; j++)
+            {
+                size_t row = _index.iRowFT(x0[1] + j, x0[2] + k);
+
+                int len = _index.len(row);
+
+                RFLOAT* data = _data + _index.offset(row);
+
+                for (int i = 0; i < 2; i++)
+                    if (x0[0] + i < len)
+                    {
+                        #pragma omp atomic
+                        data[x0[0] + i] += value * w[k][j][i];
+                    }
+            }
+    }
+}
+
+void RealHalfVolume::addFT(const RFLOAT value,
+                           const RFLOAT iCol,
+                           const RFLOAT iRow,
+                           const RFLOAT iSlc,
+                           const RFLOAT a,
+                           const TabFunction& kernel)
+{
+    RFLOAT a2 = TSGSL_pow_2(a);
+
+    VOLUME_SUB_SPHERE_FT(a)
+    {
+        RFLOAT r2 = QUAD_3(iCol - i, iRow - j, iSlc - k);
+        if (r2 < a2) addFT(value * kernel(r2), i, j, k);
+    }
+}
+
+RFLOAT RealHalfVolume::getByInterpolationFT(RFLOAT iCol,
+                                            RFLOAT iRow,
+                                            RFLOAT iSlc) const
+{
+    conjHalf(iCol, iRow, iSlc);
+
+    RFLOAT w[2][2][2];
+    int x0[3];
+    RFLOAT x[3] = {iCol, iRow, iSlc};
+
+    WG_TRI_INTERP_LINEAR(w, x0, x);
+
+    RFLOAT result = 0;
+
+    for (int k = 0; k < 2; k++)
+        for (int j = 0; j < 2; j++)
+        {
+            size_t row = _index.iRowFT(x0[1] + j, x0[2] + k);
+
+            int len = _index.len(row);
+
+            const RFLOAT* data = _data + _index.offset(row);
+
+            for (int i = 0; i < 2; i++)
+                if (x0[0] + i < len)
+                    result += data[x0[0] + i] * w[k][j][i];
+        }
+
+    return result;
+}
@@ -0,0 +1,213 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependency:
+ * Test:
+ * Execution:
+ * Description:
+ *
+ * Manual:
+ * ****************************************************************************/
+
+#include "SphereIndex.h"
+
+SphereIndex::SphereIndex()
+{
+    _nRow = 0;
+    _nSlc = 0;
+    _nColFT = 0;
+
+    _r = -1;
+
+    _offset = NULL;
+    _len = NULL;
+
+    _size = 0;
+
+    _brick = false;
+
+    _nBrickCol = 0;
+    _nBrickRow = 0;
+    _nBrickSlc = 0;
+
+    _brickOffset = NULL;
+
+    _rowBrick = NULL;
+    _rowVoxel = NULL;
+    _slcBrick = NULL;
+    _slcVoxel = NULL;
+}
+
+SphereIndex::~SphereIndex()
+{
+    clear();
+}
+
+void SphereIndex::alloc(const int nCol,
+                        const int nRow,
+                        const int nSlc,
+                        const int r,
+                        const bool brick)
+{
+    clear();
+
+    _nRow = nRow;
+    _nSlc = nSlc;
+    _nColFT = nCol / 2 + 1;
+
+    _r = r;
+
+    _offset = new size_t[nRowFT()];
+    _len = new int[nRowFT()];
+
+    _size = 0;
+
+    for (int kk = 0; kk < nSlc; kk++)
+        for (int jj = 0; jj < nRow; jj++)
+        {
+            // the signed frequency of the row
+
+            int j = (jj <= nRow / 2) ? jj : jj - nRow;
+            int k = (kk <= nSlc / 2) ? kk : kk - nSlc;
+
+            int len = _nColFT;
+
+            if (r >= 0)
+            {
+                long q = (long)r * r - (long)j * j - (long)k * k;
+
+                if (q < 0)
+                    len = 0;
+                else
+                {
+                    // the largest column of which the square is no more than q
+
+                    long i = (long)sqrt((double)q);
+
+                    while (i * i > q) i--;
+                    while ((i + 1) * (i + 1) <= q) i++;
+
+                    len = GSL_MIN_INT(i + 1, _nColFT);
+                }
+            }
+
+            size_t row = iRowFT(jj, kk);
+
+            _offset[row] = _size;
+            _len[row] = len;
+
+            _size += len;
+        }
+
+    _brick = brick;
+
+    if (!_brick) return;
+
+    // the bricks cover one more column than the half spectrum, as the cell
+    // of interpolation at the last column reaches it
+
+    _nBrickCol = _nColFT / SPHERE_INDEX_BRICK_EDGE + 1;
+    _nBrickRow = (nRow + SPHERE_INDEX_BRICK_MASK) / SPHERE_INDEX_BRICK_EDGE;
+    _nBrickSlc = (nSlc + SPHERE_INDEX_BRICK_MASK) / SPHERE_INDEX_BRICK_EDGE;
+
+    size_t nBrick = (size_t)_nBrickCol * _nBrickRow * _nBrickSlc;
+
+    _brickOffset = new size_t[nBrick];
+
+    for (size_t b = 0; b < nBrick; b++)
+        _brickOffset[b] = SPHERE_INDEX_NO_BRICK;
+
+    // the rows and the slices are ordered by frequency, from -N / 2 to
+    // N / 2 - 1, the frequency looked up being signed or wrapped
+
+    _rowBrick = new size_t[2 * nRow + 1];
+    _rowVoxel = new int[2 * nRow + 1];
+
+    for (int j = -nRow; j <= nRow; j++)
+    {
+        int js = ((j + nRow / 2) % nRow + nRow) % nRow;
+
+        _rowBrick[j + nRow] = (size_t)(js >> SPHERE_INDEX_BRICK_SHIFT) * _nBrickCol;
+        _rowVoxel[j + nRow] = (js & SPHERE_INDEX_BRICK_MASK) << SPHERE_INDEX_BRICK_SHIFT;
+    }
+
+    _slcBrick = new size_t[2 * nSlc + 1];
+    _slcVoxel = new int[2 * nSlc + 1];
+
+    for (int k = -nSlc; k <= nSlc; k++)
+    {
+        int ks = ((k + nSlc / 2) % nSlc + nSlc) % nSlc;
+
+        _slcBrick[k + nSlc] = (size_t)(ks >> SPHERE_INDEX_BRICK_SHIFT) * _nBrickCol * _nBrickRow;
+        _slcVoxel[k + nSlc] = (ks & SPHERE_INDEX_BRICK_MASK) << (2 * SPHERE_INDEX_BRICK_SHIFT);
+    }
+
+    // the bricks holding a voxel inside the sphere are stored
+
+    for (int kk = 0; kk < nSlc; kk++)
+        for (int jj = 0; jj < nRow; jj++)
+        {
+            int len = _len[iRowFT(jj, kk)];
+
+            for (int i = 0; i < len; i += SPHERE_INDEX_BRICK_EDGE)
+                _brickOffset[iBrick(i, jj, kk)] = 0;
+        }
+
+    _size = 0;
+
+    for (size_t b = 0; b < nBrick; b++)
+        if (_brickOffset[b] != SPHERE_INDEX_NO_BRICK)
+        {
+            _brickOffset[b] = _size;
+
+            _size += SPHERE_INDEX_BRICK_SIZE;
+        }
+}
+
+void SphereIndex::clear()
+{
+    delete[] _offset;
+    delete[] _len;
+
+    _offset = NULL;
+    _len = NULL;
+
+    _size = 0;
+
+    delete[] _brickOffset;
+
+    delete[] _rowBrick;
+    delete[] _rowVoxel;
+    delete[] _slcBrick;
+    delete[] _slcVoxel;
+
+    _brickOffset = NULL;
+
+    _rowBrick = NULL;
+    _rowVoxel = NULL;
+    _slcBrick = NULL;
+    _slcVoxel = NULL;
+
+    _brick = false;
+}
+
+void SphereIndex::swap(SphereIndex& that)
+{
+    std::swap(_nRow, that._nRow);
+    std::swap(_nSlc, that._nSlc);
+    std::swap(_nColFT, that._nColFT);
+    std::swap(_r, that._r);
+    std::swap(_offset, that._offset);
+    std::swap(_len, that._len);
+    std::swap(_size, that._size);
+    std::swap(_brick, that._brick);
+    std::swap(_nBrickCol, that._nBrickCol);
+    std::swap(_nBrickRow, that._nBrickRow);
+    std::swap(_nBrickSlc, that._nBrickSlc);
+    std::swap(_brickOffset, that._brickOffset);
+    std::swap(_rowBrick, that._rowBrick);
+    std::swap(_rowVoxel, that._rowVoxel);
+    std::swap(_slcBrick, that._slcBrick);
+    std::swap(_slcVoxel, that._slcVoxel);
+}
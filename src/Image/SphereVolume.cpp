@@ -0,0 +1,320 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependency:
+ * Test:
+ * Execution:
+ * Description:
+ *
+ * Manual:
+ * ****************************************************************************/
+
+#include "SphereVolume.h"
+
+SphereVolume::SphereVolume()
+{
+    _data = NULL;
+
+    _own = true;
+
+    _nCol = 0;
+    _nRow = 0;
+    _nSlc = 0;
+}
+
+SphereVolume::SphereVolume(const int nCol,
+                           const int nRow,
+                           const int nSlc,
+                           const int r)
+{
+    _data = NULL;
+
+    _own = true;
+
+    alloc(nCol, nRow, nSlc, r);
+}
+
+SphereVolume::~SphereVolume()
+{
+    clear();
+}
+
+void SphereVolume::swap(SphereVolume& that)
+{
+    std::swap(_data, that._data);
+    std::swap(_own, that._own);
+    std::swap(_nCol, that._nCol);
+    std::swap(_nRow, that._nRow);
+    std::swap(_nSlc, that._nSlc);
+
+    _index.swap(that._index);
+}
+
+void SphereVolume::alloc(const int nCol,
+                         const int nRow,
+                         const int nSlc,
+                         const int r,
+                         const bool brick)
+{
+    clear();
+
+    _nCol = nCol;
+    _nRow = nRow;
+    _nSlc = nSlc;
+
+    _index.alloc(nCol, nRow, nSlc, r, brick);
+
+    _data = (Complex*)TSFFTW_malloc(_index.size() * sizeof(Complex));
+
+    if (_data == NULL)
+    {
+        REPORT_ERROR("FAIL TO ALLOCATE SPACE");
+
+        abort();
+    }
+}
+
+void SphereVolume::attach(Complex* data,
+                          const int nCol,
+                          const int nRow,
+                          const int nSlc,
+                          const int r,
+                          const bool brick)
+{
+    clear();
+
+    _nCol = nCol;
+    _nRow = nRow;
+    _nSlc = nSlc;
+
+    _index.alloc(nCol, nRow, nSlc, r, brick);
+
+    _data = data;
+
+    _own = false;
+}
+
+void SphereVolume::clear()
+{
+    if ((_data != NULL) && _own) TSFFTW_free(_data);
+
+    _data = NULL;
+
+    _own = true;
+
+    _index.clear();
+}
+
+Complex SphereVolume::getFT(int iCol,
+                            int iRow,
+                            int iSlc) const
+{
+    bool conj = conjHalf(iCol, iRow, iSlc);
+
+    Complex result = getFTHalf(iCol, iRow, iSlc);
+
+    return conj ? CONJUGATE(result) : result;
+}
+
+void SphereVolume::addFT(const Complex value,
+                         int iCol,
+                         int iRow,
+                         int iSlc)
+{
+    bool conj = conjHalf(iCol, iRow, iSlc);
+
+    if (!_index.inside(iCol, iRow, iSlc)) return;
+
+    size_t index = _index.index(iCol, iRow, iSlc);
+
+    Complex val = conj ? CONJUGATE(value) : value;
+
+    #pragma omp atomic
+    _data[index].dat[0] += val.dat[0];
+    #pragma omp atomic
+    _data[index].dat[1] += val.dat[1];
+}
+
+void SphereVolume::addFT(const Complex value,
+                         RFLOAT iCol,
+                         RFLOAT iRow,
+                         RFLOAT iSlc)
+{
+    bool conj = conjHalf(iCol, iRow, iSlc);
+
+    Complex val = conj ? CONJUGATE(value) : value;
+
+    RFLOAT w[2][2][2];
+    int x0[3];
+    RFLOAT x[3] = {iCol, iRow, iSlc};
+
+    WG_TRI_INTERP_LINEAR(w, x0, x);
+
+    // the two voxels of a cell in the same row are adjacent in the storage
+
+    for (int k = 0; k < 2; k++)
+        for (int j = 0; j < 2; j++)
+        {
+            size_t row = _index.iRowFT(x0[1] + j, x0[2] + k);
+
+            int len = _index.len(row);
+
+            Complex* data = _data + _index.offset(row);
+
+            for (int i = 0; i < 2; i++)
+                if (x0[0] + i < len)
+                {
+                    #pragma omp atomic
+                    data[x0[0] + i].dat[0] += val.dat[0] * w[k][j][i];
+                    #pragma omp atomic
+                    data[x0[0] + i].dat[1] += val.dat[1] * w[k][j][i];
+                }
+        }
+}
+
+void SphereVolume::addFT(const Complex value,
+                         const RFLOAT iCol,
+                         const RFLOAT iRow,
+                         const RFLOAT iSlc,
+                         const RFLOAT a,
+                         const TabFunction& kernel)
+{
+    RFLOAT a2 = TSGSL_pow_2(a);
+
+    VOLUME_SUB_SPHERE_FT(a)
+    {
+        RFLOAT r2 = QUAD_3(iCol - i, iRow - j, iSlc - k);
+        if (r2 < a2) addFT(value * kernel(r2), i, j, k);
+    }
+}
+
+Complex SphereVolume::getByInterpolationFT(RFLOAT iCol,
+                                           RFLOAT iRow,
+                                           RFLOAT iSlc,
+                                           const int interp) const
+{
+    bool conj = conjHalf(iCol, iRow, iSlc);
+
+    if (interp == NEAREST_INTERP)
+    {
+        Complex result = getFTHalf(AROUND(iCol), AROUND(iRow), AROUND(iSlc));
+
+        return conj ? CONJUGATE(result) : result;
+    }
+
+    RFLOAT w[2][2][2];
+    int x0[3];
+    RFLOAT x[3] = {iCol, iRow, iSlc};
+
+    WG_TRI_INTERP_LINEAR(w, x0, x);
+
+    if (_index.brick())
+    {
+        Complex result = getBrickFT(w, x0);
+
+        return conj ? CONJUGATE(result) : result;
+    }
+
+    Complex result = COMPLEX(0, 0);
+
+    for (int k = 0; k < 2; k++)
+        for (int j = 0; j < 2; j++)
+        {
+            size_t row = _index.iRowFT(x0[1] + j, x0[2] + k);
+
+            int len = _index.len(row);
+
+            const Complex* data = _data + _index.offset(row);
+
+            for (int i = 0; i < 2; i++)
+                if (x0[0] + i < len)
+                    result += data[x0[0] + i] * w[k][j][i];
+        }
+
+    return conj ? CONJUGATE(result) : result;
+}
+
+Complex SphereVolume::getBrickFT(const RFLOAT w[2][2][2],
+                                 const int x0[3]) const
+{
+    size_t b = _index.iBrick(x0[0], x0[1], x0[2]);
+
+    // the cell is in a single brick unless it crosses the border of bricks,
+    // in which the neighbours of a voxel are 1, EDGE and EDGE^2 away
+
+    if (((x0[0] & SPHERE_INDEX_BRICK_MASK) != SPHERE_INDEX_BRICK_MASK) &&
+        (_index.iBrick(x0[0], x0[1] + 1, x0[2] + 1) == b))
+    {
+        size_t offset = _index.brickOffset(b);
+
+        if (offset == SPHERE_INDEX_NO_BRICK) return COMPLEX(0, 0);
+
+        const Complex* data = _data + offset + _index.iInBrick(x0[0], x0[1], x0[2]);
+
+        Complex result = COMPLEX(0, 0);
+
+        for (int k = 0; k < 2; k++)
+            for (int j = 0; j < 2; j++)
+                for (int i = 0; i < 2; i++)
+                    result += data[(k * SPHERE_INDEX_BRICK_EDGE + j) * SPHERE_INDEX_BRICK_EDGE + i]
+                            * w[k][j][i];
+
+        return result;
+    }
+
+    Complex result = COMPLEX(0, 0);
+
+    for (int k = 0; k < 2; k++)
+        for (int j = 0; j < 2; j++)
+        {
+            int len = _index.len(_index.iRowFT(x0[1] + j, x0[2] + k));
+
+            for (int i = 0; i < 2; i++)
+                if (x0[0] + i < len)
+                    result += _data[_index.index(x0[0] + i, x0[1] + j, x0[2] + k)]
+                            * w[k][j][i];
+        }
+
+    return result;
+}
+
+void SphereVolume::fromVolume(const Volume& src,
+                              const int r,
+                              const bool brick)
+{
+    if (_own) alloc(src.nColRL(), src.nRowRL(), src.nSlcRL(), r, brick);
+
+    // the voxels of the bricks outside the sphere are kept 0
+
+    if (_index.brick())
+        memset(_data, 0, _index.size() * sizeof(Complex));
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t row = 0; row < _index.nRowFT(); row++)
+    {
+        int j = row % _nRow;
+        int k = row / _nRow;
+
+        for (int i = 0; i < _index.len(row); i++)
+            _data[_index.index(i, j, k)] = src.getFTHalf(i, j, k);
+    }
+}
+
+void SphereVolume::toVolume(Volume& dst) const
+{
+    dst.alloc(_nCol, _nRow, _nSlc, FT_SPACE);
+
+    #pragma omp parallel for
+    SET_0_FT(dst);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t row = 0; row < _index.nRowFT(); row++)
+    {
+        int j = row % _nRow;
+        int k = row / _nRow;
+
+        for (int i = 0; i < _index.len(row); i++)
+            dst.setFTHalf(_data[_index.index(i, j, k)], i, j, k);
+    }
+}
@@ -14,6 +14,12 @@
 Model::~Model()
 {
     clear();
+
+    int finalized;
+
+    MPI_Finalized(&finalized);
+
+    if ((!finalized) && (_node != MPI_COMM_NULL)) MPI_Comm_free(&_node);
 }
 
 void Model::init(const int mode,
@@ -118,6 +124,8 @@ void Model::initProjReco()
         BLOG(INFO, "LOGGER_INIT") << "Appending Reconstructor of Reference " << l;
 
         _reco.push_back(boost::movelib::unique_ptr<Reconstructor>(new Reconstructor()));
+
+        _proj[l].setNode(_projNodeShared ? _node : MPI_COMM_NULL);
     }
 
 #ifdef VERBOSE_LEVEL_1
@@ -281,6 +289,44 @@ Projector& Model::proj(const int i)
     return _proj[i];
 }
 
+void Model::setProjNodeShared(const bool projNodeShared)
+{
+    _projNodeShared = projNodeShared;
+
+    if (_projNodeShared && (_node == MPI_COMM_NULL))
+    {
+        MPI_Comm_split_type(_hemi, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &_node);
+
+        int nodeSize;
+
+        MPI_Comm_size(_node, &nodeSize);
+
+        ALOG(INFO, "LOGGER_SYS") << "Projectees Shared by "
+                                 << nodeSize
+                                 << " Processes on the Node";
+        BLOG(INFO, "LOGGER_SYS") << "Projectees Shared by "
+                                 << nodeSize
+                                 << " Processes on the Node";
+    }
+
+    for (size_t l = 0; l < _proj.size(); l++)
+        _proj[l].setNode(_projNodeShared ? _node : MPI_COMM_NULL);
+}
+
+void Model::setClassParallel(const bool classParallel)
+{
+    _classParallel = classParallel;
+}
+
+int Model::classOwner(const int l) const
+{
+    int hemiSize;
+
+    MPI_Comm_size(_hemi, &hemiSize);
+
+    return l % hemiSize;
+}
+
 Reconstructor& Model::reco(const int i)
 {
     return *_reco[i];
@@ -912,6 +958,18 @@ void Model::setProjMaxRadius(const int maxRadius)
 
 void Model::refreshProj()
 {
+    ALOG(INFO, "LOGGER_SYS") << "Building Projectors from References of Size "
+                             << projSize();
+    BLOG(INFO, "LOGGER_SYS") << "Building Projectors from References of Size "
+                             << projSize();
+
+    if (_classParallel && (_mode == MODE_3D))
+    {
+        refreshProjByClass();
+
+        return;
+    }
+
     FOR_EACH_CLASS
     {
         _proj[l].setPf(_pf);
@@ -925,16 +983,19 @@ void Model::refreshProj()
         {
             _proj[l].setMode(MODE_2D);
 
-            Image tmp(_size, _size, FT_SPACE);
-            SLC_EXTRACT_FT(tmp, _ref[l], 0);
+            Image tmp;
+            projRef(tmp, l);
 
-            _proj[l].setProjectee(tmp.copyImage());
+            _proj[l].setProjectee(boost::move(tmp));
         }
         else if (_mode == MODE_3D)
         {
             _proj[l].setMode(MODE_3D);
 
-            _proj[l].setProjectee(_ref[l].copyVolume());
+            Volume tmp;
+            projRef(tmp, l);
+
+            _proj[l].setProjectee(boost::move(tmp));
         }
         else
             REPORT_ERROR("INEXISTENT MODE");
@@ -943,6 +1004,72 @@ void Model::refreshProj()
     }
 }
 
+void Model::refreshProjByClass()
+{
+    // the projectees shared on the node are built by the processes of the
+    // node in turn, and the others by the processes of the hemisphere in turn
+
+    MPI_Comm comm = _projNodeShared ? _node : _hemi;
+
+    int rank, size;
+
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    FOR_EACH_CLASS
+    {
+        _proj[l].setPf(_pf);
+
+        if (_searchType == SEARCH_TYPE_GLOBAL)
+            _proj[l].setInterp(INTERP_TYPE_GLOBAL);
+        else
+            _proj[l].setInterp(INTERP_TYPE_LOCAL);
+
+        _proj[l].setMode(MODE_3D);
+
+        if (l % size == rank)
+        {
+            Volume tmp;
+            projRef(tmp, l);
+
+            _proj[l].buildProjectee(boost::move(tmp));
+        }
+    }
+
+    FOR_EACH_CLASS
+    {
+        if (_projNodeShared)
+            _proj[l].shareProjectee(l % size);
+        else
+            _proj[l].bcastProjectee(l % size, comm);
+
+        _proj[l].setMaxRadius(_r);
+    }
+}
+
+int Model::projSize() const
+{
+#ifdef MODEL_PROJECTOR_RESIZE
+    return GSL_MIN_INT(_size, (_r + PROJECTOR_RESIZE_MARGIN) * 2);
+#else
+    return _size;
+#endif
+}
+
+void Model::projRef(Image& dst,
+                    const int l) const
+{
+    dst.alloc(projSize(), projSize(), FT_SPACE);
+
+    SLC_EXTRACT_FT(dst, _ref[l], 0);
+}
+
+void Model::projRef(Volume& dst,
+                    const int l) const
+{
+    VOL_EXTRACT_FT(dst, _ref[l], (RFLOAT)projSize() / _size);
+}
+
 void Model::refreshReco()
 {
     ALOG(INFO, "LOGGER_SYS") << "Refreshing Reconstructor(s) with Frequency Upper Boundary : "
@@ -406,7 +406,21 @@ void Optimiser::init()
         ALOG(INFO, "LOGGER_INIT") << "Setting Up Projectors and Reconstructors of _model";
         BLOG(INFO, "LOGGER_INIT") << "Setting Up Projectors and Reconstructors of _model";
 
+        _model.setProjNodeShared(_para.projNodeShared);
+
+        _model.setClassParallel(_para.classParallel);
+
         _model.initProjReco();
+
+        for (int t = 0; t < _para.k; t++)
+        {
+            _model.reco(t).setWarmStartW(_para.warmStartW);
+            _model.reco(t).setBalanceRelax(_para.balanceRelax);
+            _model.reco(t).setSymmetrizeMode(_para.symmetrizeMode);
+            _model.reco(t).setReduceChunk((size_t)(_para.reduceChunk * MEGABYTE));
+            _model.reco(t).setNodeShared(_para.nodeShared);
+            _model.reco(t).setReconstructAlone(_para.classParallel);
+        }
     }
 
 #ifdef VERBOSE_LEVEL_1
@@ -506,6 +520,11 @@ struct SpWeightComparator
     }
 };
 
+/**
+ * a leader board of poses, with the pose of the lowest log weight on the top
+ */
+typedef std::priority_queue<Sp, vector<Sp>, SpWeightComparator> SpLeaderBoard;
+
 void Optimiser::expectation()
 {
     IF_MASTER return;
@@ -515,7 +534,20 @@ void Optimiser::expectation()
     ALOG(INFO, "LOGGER_ROUND") << "Allocating Space for Pre-calcuation in Expectation";
     BLOG(INFO, "LOGGER_ROUND") << "Allocating Space for Pre-calcuation in Expectation";
 
-    allocPreCalIdx(_r, _rL);
+    // radii of stages of coarse-to-fine global search, the last stage at the
+    // full radius and each stage at half of the radius of the next one
+
+    int nStage = (_searchType == SEARCH_TYPE_GLOBAL)
+               ? GSL_MAX_INT(1, _para.nStageGSearch)
+               : 1;
+
+    vec rStage(nStage);
+
+    for (int s = 0; s < nStage; s++)
+        rStage(s) = GSL_MAX_DBL(GSL_MIN_DBL(_r, _rL + MIN_R_GLOBAL_SEARCH_STAGE),
+                                _r * pow(2, s - (nStage - 1)));
+
+    allocPreCalIdx(rStage(0), _rL);
 
     if (_searchType == SEARCH_TYPE_GLOBAL)
     {
@@ -524,6 +556,10 @@ void Optimiser::expectation()
         else
             allocPreCal(true, true);
 
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+        allocPreCalGEMM();
+#endif
+
         ALOG(INFO, "LOGGER_ROUND") << "Space for Pre-calcuation in Expectation Allocated";
         BLOG(INFO, "LOGGER_ROUND") << "Space for Pre-calcuation in Expectation Allocated";
 
@@ -545,6 +581,30 @@ void Optimiser::expectation()
             abort();
         }
 
+        // the spacing of rotations is in proportion to the reciprocal of the
+        // radius, thus the first stage of coarse-to-fine global search scans a
+        // coarser grid of rotations
+
+        int dimR = (_para.mode == MODE_2D) ? 1 : 3;
+
+        if (nStage > 1)
+        {
+            nR = GSL_MAX_INT(1, AROUND(nR * pow(rStage(0) / _r, dimR)));
+
+            ALOG(INFO, "LOGGER_ROUND") << "Coarse-to-Fine Global Search, Number of Stages: "
+                                       << nStage
+                                       << ", Radius of the First Stage: "
+                                       << rStage(0)
+                                       << ", Number of Rotations Scanned: "
+                                       << nR;
+            BLOG(INFO, "LOGGER_ROUND") << "Coarse-to-Fine Global Search, Number of Stages: "
+                                       << nStage
+                                       << ", Radius of the First Stage: "
+                                       << rStage(0)
+                                       << ", Number of Rotations Scanned: "
+                                       << nR;
+        }
+
         int nT = GSL_MAX_INT(30,
                              AROUND(M_PI
                                   * gsl_pow_2(_para.transS
@@ -586,12 +646,6 @@ void Optimiser::expectation()
 
         par.reset(_para.k, nR, nT, 1);
 
-        FOR_EACH_2D_IMAGE
-        {
-            // the previous top class, translation, rotation remain
-            par.copy(_par[l]);
-        }
-
         mat22 rot2D;
         mat33 rot3D;
         vec2 t;
@@ -604,9 +658,11 @@ void Optimiser::expectation()
         ***/
 
         //Complex* traP = new Complex[nT * _nPxl];
-        Complex* traP = (Complex*)TSFFTW_malloc(nT * _nPxl * sizeof(Complex));
+        EFLOAT* traReP = (EFLOAT*)TSFFTW_malloc(nT * _nPxl * sizeof(EFLOAT));
+        EFLOAT* traImP = (EFLOAT*)TSFFTW_malloc(nT * _nPxl * sizeof(EFLOAT));
+
+        mat2 traT(nT, 2);
 
-        #pragma omp parallel for schedule(dynamic) private(t)
         for (unsigned int m = 0; m < (unsigned int)nT; m++)
         {
             /***
@@ -619,95 +675,145 @@ void Optimiser::expectation()
 
             par.t(t, m);
 
-            translate(traP + m * _nPxl,
-                      t(0),
-                      t(1),
-                      _para.size,
-                      _para.size,
-                      _iCol,
-                      _iRow,
-                      _nPxl);
+            traT.row(m) = t.transpose();
         }
 
-        //vector<std::priority_queue<Sp, vector<Sp>, SpWeightComparator> > leaderBoard(_ID.size());
-        
-        mat wC = mat::Zero(_ID.size(), _para.k);
-        mat wR = mat::Zero(_ID.size(), nR);
-        mat wT = mat::Zero(_ID.size(), nT);
+        // the table is shared by all classes and rotations
 
-        _nR = 0;
+        translate(traReP,
+                  traImP,
+                  traT,
+                  _para.size,
+                  _para.size,
+                  _iCol,
+                  _iRow,
+                  _nPxl);
 
-        omp_lock_t* mtx = new omp_lock_t[_ID.size()];
+        // workspace of translation search by Fourier transform
 
-        RFLOAT* baseLine = new RFLOAT[_ID.size()];
+        Image* poolCC = NULL;
+        Complex* poolCCFT = NULL;
+        FFT* poolFFTCC = NULL;
 
-        #pragma omp parallel for
-        FOR_EACH_2D_IMAGE
+        size_t sizeCCFT = (size_t)(_para.size * _para.transSearchFFTPf / 2 + 1)
+                        * _para.size * _para.transSearchFFTPf;
+
+        if (_para.transSearchFFT)
         {
-            omp_init_lock(&mtx[l]);
-            baseLine[l] = GSL_NAN;
+            ALOG(INFO, "LOGGER_ROUND") << "Translations in Global Search Scored by Fourier Transform, Padding Factor: "
+                                       << _para.transSearchFFTPf;
+
+            poolCC = new Image[omp_get_max_threads()];
+            poolCCFT = (Complex*)TSFFTW_malloc(sizeCCFT * omp_get_max_threads() * sizeof(Complex));
+            poolFFTCC = new FFT[omp_get_max_threads()];
+
+            for (int i = 0; i < omp_get_max_threads(); i++)
+            {
+                poolCC[i].alloc(_para.size * _para.transSearchFFTPf,
+                                _para.size * _para.transSearchFFTPf,
+                                RL_SPACE);
+
+                poolFFTCC[i].bwCreatePlan(_para.size * _para.transSearchFFTPf,
+                                          _para.size * _para.transSearchFFTPf);
+            }
         }
 
+        // only the significant poses of each image are kept, rather than the
+        // weights of all rotations and translations, thus the memory grows as
+        // the number of images times the number of significant poses
+        // the leader board of each image is a heap of at most nSigPose poses,
+        // with the pose of the lowest log weight on the top
+
+        vector<SpLeaderBoard> leaderBoard(_ID.size());
+
+        // the lowest log weight on the leader board of each image when it is
+        // full, poses not above it are rejected without locking
+
+        RFLOAT* leaderBoardThres = new RFLOAT[_ID.size()];
+
+        FOR_EACH_2D_IMAGE
+            leaderBoardThres[l] = -DBL_MAX;
+
+        // the leader boards are guarded by striped locks, and the lock of an
+        // image is taken at most once per rotation
+
+        omp_lock_t mtx[OPTIMISER_LEADER_BOARD_N_LOCK];
+
+        for (int i = 0; i < OPTIMISER_LEADER_BOARD_N_LOCK; i++)
+            omp_init_lock(&mtx[i]);
+
+        _nR = 0;
+
+        // the total weight of each image is accumulated without locking, for
+        // reporting the fraction of it kept by the significant poses
+        // each thread keeps its own baseline of each image, and the total
+        // weight scaled by this baseline
+
+        int nThread = omp_get_max_threads();
+
+        mat baseLineTh = mat::Constant(_ID.size(), nThread, -DBL_MAX);
+
+        mat wTotTh = mat::Zero(_ID.size(), nThread);
+
         // t -> class
         // m -> rotation
         // n -> translation
-        
-        // RFLOAT baseLine = GSL_NAN;
+
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+        // GEMM in Eigen should be initialised before being called by multiple threads
+        Eigen::initParallel();
+#endif
 
         for (unsigned int t = 0; t < (unsigned int)_para.k; t++)
         {
-            Complex* poolPriRotP = (Complex*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(Complex));
-            Complex* poolPriAllP = (Complex*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(Complex));
+            ComplexE* poolPriRotP = (ComplexE*)TSFFTW_malloc((size_t)_nPxl * OPTIMISER_GLOBAL_SEARCH_BATCH * omp_get_max_threads() * sizeof(ComplexE));
 
-            #pragma omp parallel for schedule(dynamic) private(rot2D, rot3D)
-            for (unsigned int m = 0; m < (unsigned int)nR; m++)
-            {
-                /***
-#ifdef FFTW_PTR_THREAD_SAFETY
-                #pragma omp critical
+            EFLOAT* poolPriRotReP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+            EFLOAT* poolPriRotImP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+            EFLOAT* poolPriAllReP = (EFLOAT*)TSFFTW_malloc(_nPxl * nT * omp_get_max_threads() * sizeof(EFLOAT));
+            EFLOAT* poolPriAllImP = (EFLOAT*)TSFFTW_malloc(_nPxl * nT * omp_get_max_threads() * sizeof(EFLOAT));
+#else
+            EFLOAT* poolPriAllReP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+            EFLOAT* poolPriAllImP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
 #endif
-                #pragma omp critical
-                Complex* priRotP = (Complex*)TSFFTW_malloc(_nPxl * sizeof(Complex));
-                ***/
 
-                Complex* priRotP = poolPriRotP + _nPxl * omp_get_thread_num();
+            // the rotations are projected in batches, each by a thread, and
+            // then scored one after another
+            // static scheduling keeps the partition of batches over threads,
+            // thus the accumulated weights, reproducible
 
-                Complex* priAllP = poolPriAllP + _nPxl * omp_get_thread_num();
+            int nBatch = (nR + OPTIMISER_GLOBAL_SEARCH_BATCH - 1) / OPTIMISER_GLOBAL_SEARCH_BATCH;
 
-                /***
-#ifdef FFTW_PTR_THREAD_SAFETY
-                #pragma omp critical
-#endif
-                Complex* priAllP = (Complex*)TSFFTW_malloc(_nPxl * sizeof(Complex));
-                ***/
+            #pragma omp parallel for schedule(static)
+            for (int b = 0; b < nBatch; b++)
+            {
+                int m0 = b * OPTIMISER_GLOBAL_SEARCH_BATCH;
 
-                /***
-                Complex* priRotP = new Complex[_nPxl];
-                Complex* priAllP = new Complex[_nPxl];
-                ***/
+                int nM = GSL_MIN_INT(OPTIMISER_GLOBAL_SEARCH_BATCH, nR - m0);
 
-                /***
-                Image imgRot(size(), size(), FT_SPACE);
-                Image imgAll(size(), size(), FT_SPACE);
-                ***/
+                ComplexE* priBatchP = poolPriRotP + (size_t)_nPxl * OPTIMISER_GLOBAL_SEARCH_BATCH * omp_get_thread_num();
 
                 // perform projection
 
                 if (_para.mode == MODE_2D)
                 {
-                    //par.rot(rot2D, t * nR * nT + m * nT);
-                    par.rot(rot2D, m);
+                    mat22 rot2DBatch[OPTIMISER_GLOBAL_SEARCH_BATCH];
+
+                    for (int m = 0; m < nM; m++)
+                        par.rot(rot2DBatch[m], m0 + m);
 
-                    //_model.proj(t).project(imgRot, rot2D, _iCol, _iRow, _iPxl, _nPxl);
-                    _model.proj(t).project(priRotP, rot2D, _iCol, _iRow, _nPxl);
+                    _model.proj(t).projectBatch(priBatchP, rot2DBatch, nM, _iCol, _iRow, _nPxl);
                 }
                 else if (_para.mode == MODE_3D)
                 {
-                    //par.rot(rot3D, t * nR * nT + m * nT);
-                    par.rot(rot3D, m);
+                    mat33 rot3DBatch[OPTIMISER_GLOBAL_SEARCH_BATCH];
+
+                    for (int m = 0; m < nM; m++)
+                        par.rot(rot3DBatch[m], m0 + m);
 
-                    //_model.proj(t).project(imgRot, rot3D, _iCol, _iRow, _iPxl, _nPxl);
-                    _model.proj(t).project(priRotP, rot3D, _iCol, _iRow, _nPxl);
+                    _model.proj(t).projectBatch(priBatchP, rot3DBatch, nM, _iCol, _iRow, _nPxl);
                 }
                 else
                 {
@@ -716,33 +822,140 @@ void Optimiser::expectation()
                     abort();
                 }
 
-                for (unsigned int n = 0; n < (unsigned int)nT; n++)
+                for (unsigned int m = m0; m < (unsigned int)(m0 + nM); m++)
                 {
                     /***
-                    mul(imgAll, imgRot, trans[n], _iPxl, _nPxl);
+#ifdef FFTW_PTR_THREAD_SAFETY
+                    #pragma omp critical
+#endif
+                    #pragma omp critical
+                    Complex* priRotP = (Complex*)TSFFTW_malloc(_nPxl * sizeof(Complex));
+                    ***/
 
-                    Complex* priP = new Complex[_nPxl];
+                    ComplexE* priRotP = priBatchP + (size_t)_nPxl * (m - m0);
 
-                    for (int i = 0; i < _nPxl; i++)
-                        priP[i] = imgAll.iGetFT(_iPxl[i]);
+                    EFLOAT* priRotReP = poolPriRotReP + _nPxl * omp_get_thread_num();
+                    EFLOAT* priRotImP = poolPriRotImP + _nPxl * omp_get_thread_num();
+
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+                    EFLOAT* priAllReP = poolPriAllReP + _nPxl * nT * omp_get_thread_num();
+                    EFLOAT* priAllImP = poolPriAllImP + _nPxl * nT * omp_get_thread_num();
+#else
+                    EFLOAT* priAllReP = poolPriAllReP + _nPxl * omp_get_thread_num();
+                    EFLOAT* priAllImP = poolPriAllImP + _nPxl * omp_get_thread_num();
+#endif
+
+                    /***
+#ifdef FFTW_PTR_THREAD_SAFETY
+                    #pragma omp critical
+#endif
+                    Complex* priAllP = (Complex*)TSFFTW_malloc(_nPxl * sizeof(Complex));
+                    ***/
+
+                    /***
+                    Complex* priRotP = new Complex[_nPxl];
+                    Complex* priAllP = new Complex[_nPxl];
+                    ***/
+
+                    /***
+                    Image imgRot(size(), size(), FT_SPACE);
+                    Image imgAll(size(), size(), FT_SPACE);
                     ***/
 
+                    // split real and imaginary part for vectorisation
+
                     for (int i = 0; i < _nPxl; i++)
-                        priAllP[i] = traP[_nPxl * n + i] * priRotP[i];
+                    {
+                        priRotReP[i] = REAL(priRotP[i]);
+                        priRotImP[i] = IMAG(priRotP[i]);
+                    }
 
+                    // scores of all images under all translations of this rotation
                     // higher logDataVSPrior, higher prabibility
 
-                    vec dvp = logDataVSPrior(_datP,
-                                             priAllP,
-                                             _ctfP,
-                                             _sigRcpP,
-                                             (int)_ID.size(),
-                                             _nPxl);
+                    mat dvpT(_ID.size(), nT);
+
+                    if (_para.transSearchFFT)
+                    {
+                        vec dvp(nT);
+
+                        FOR_EACH_2D_IMAGE
+                        {
+                            logDataVSPrior(dvp,
+                                           poolCC[omp_get_thread_num()],
+                                           poolCCFT + sizeCCFT * omp_get_thread_num(),
+                                           poolFFTCC[omp_get_thread_num()],
+                                           _datReP + l,
+                                           _datImP + l,
+                                           priRotReP,
+                                           priRotImP,
+                                           _ctfP + l,
+                                           _sigRcpP + l,
+                                           _iCol,
+                                           _iRow,
+                                           traT,
+                                           _para.transSearchFFTPf,
+                                           _nPxl,
+                                           _ID.size());
+
+                            dvpT.row(l) = dvp.transpose();
+                        }
+                    }
+                    else
+                    {
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+                        logDataVSPrior(dvpT,
+                                       _datCrossReP,
+                                       _datCrossImP,
+                                       _ctf2SigRcpP,
+                                       _datNormP,
+                                       priRotReP,
+                                       priRotImP,
+                                       traReP,
+                                       traImP,
+                                       priAllReP,
+                                       priAllImP,
+                                       nT,
+                                       (int)_ID.size(),
+                                       _nPxl);
+#else
+                        for (unsigned int n = 0; n < (unsigned int)nT; n++)
+                        {
+                            /***
+                            mul(imgAll, imgRot, trans[n], _iPxl, _nPxl);
+
+                            Complex* priP = new Complex[_nPxl];
+
+                            for (int i = 0; i < _nPxl; i++)
+                                priP[i] = imgAll.iGetFT(_iPxl[i]);
+                            ***/
+
+                            const EFLOAT* traRe = traReP + _nPxl * n;
+                            const EFLOAT* traIm = traImP + _nPxl * n;
+
+                            #pragma omp simd
+                            for (int i = 0; i < _nPxl; i++)
+                            {
+                                priAllReP[i] = traRe[i] * priRotReP[i] - traIm[i] * priRotImP[i];
+                                priAllImP[i] = traRe[i] * priRotImP[i] + traIm[i] * priRotReP[i];
+                            }
+
+                            dvpT.col(n) = logDataVSPrior(_datReP,
+                                                         _datImP,
+                                                         priAllReP,
+                                                         priAllImP,
+                                                         _ctfP,
+                                                         _sigRcpP,
+                                                         (int)_ID.size(),
+                                                         _nPxl);
+                        }
+#endif
+                    }
 
 #ifndef NAN_NO_CHECK
 
                     FOR_EACH_2D_IMAGE
-                        if (TSGSL_isnan(dvp(l)))
+                        if (TSGSL_isnan(dvpT.row(l).sum()))
                         {
                             REPORT_ERROR("DVP CONTAINS NAN");
 
@@ -751,212 +964,438 @@ void Optimiser::expectation()
 
 #endif
 
-                    //delete[] priP;
+                    int th = omp_get_thread_num();
+
+                    vec dvpMax = dvpT.rowwise().maxCoeff();
 
                     FOR_EACH_2D_IMAGE
                     {
-                        omp_set_lock(&mtx[l]);
+                        RFLOAT& baseLine = baseLineTh(l, th);
 
-                        if (TSGSL_isnan(baseLine[l]))
-                            baseLine[l] = dvp(l);
-                        else
+                        if (dvpMax(l) > baseLine)
                         {
-                            if (dvp(l) > baseLine[l])
-                            {
-                                RFLOAT offset = dvp(l) - baseLine[l];
+                            wTotTh(l, th) *= exp(baseLine - dvpMax(l));
 
-                                RFLOAT nf = exp(offset);
+                            baseLine = dvpMax(l);
+                        }
 
-                                if (TSGSL_isinf(nf))
-                                {
-                                    wC.row(l) = vec::Zero(_para.k).transpose();
-                                    wR.row(l) = vec::Zero(nR).transpose();
-                                    wT.row(l) = vec::Zero(nT).transpose();
-                                }
-                                else
-                                {
-                                    wC.row(l) /= nf;
-                                    wR.row(l) /= nf;
-                                    wT.row(l) /= nf;
-                                }
+                        wTotTh(l, th) += (dvpT.row(l).array() - baseLine).exp().sum();
+
+                        RFLOAT thres;
 
-                                baseLine[l] += offset;
+                        #pragma omp atomic read
+                        thres = leaderBoardThres[l];
+
+                        if (dvpMax(l) <= thres) continue;
+
+                        omp_set_lock(&mtx[l % OPTIMISER_LEADER_BOARD_N_LOCK]);
+
+                        for (int n = 0; n < nT; n++)
+                        {
+                            RFLOAT w = dvpT(l, n);
+
+                            if (w <= leaderBoardThres[l]) continue;
+
+                            leaderBoard[l].push(Sp(w, t, m, n));
+
+                            if ((int)leaderBoard[l].size() > _para.nSigPose)
+                                leaderBoard[l].pop();
+
+                            if ((int)leaderBoard[l].size() == _para.nSigPose)
+                            {
+                                #pragma omp atomic write
+                                leaderBoardThres[l] = leaderBoard[l].top()._w;
                             }
                         }
 
-                        RFLOAT w = exp(dvp(l) - baseLine[l]);
+                        omp_unset_lock(&mtx[l % OPTIMISER_LEADER_BOARD_N_LOCK]);
+                    }
 
-                        wC(l, t) += w;
+                    #pragma omp atomic
+                    _nR += 1;
 
-                        wR(l, m) += w;
+                    #pragma omp critical
+                    if (_nR > (int)(nR * _para.k / 10))
+                    {
+                        _nR = 0;
 
-                        wT(l, n) += w;
+                        nPer += 1;
 
-                        omp_unset_lock(&mtx[l]);
+                        ALOG(INFO, "LOGGER_ROUND") << nPer * 10
+                                                   << "\% Initial Phase of Global Search Performed";
+                        BLOG(INFO, "LOGGER_ROUND") << nPer * 10
+                                                   << "\% Initial Phase of Global Search Performed";
                     }
 
+
                     /***
-                    FOR_EACH_2D_IMAGE
+#ifdef FFTW_PTR_THREAD_SAFETY
+                    #pragma omp critical
+#endif
+                    TSFFTW_free(priRotP);
+
+#ifdef FFTW_PTR_THREAD_SAFETY
+                    #pragma omp critical
+#endif
+                    TSFFTW_free(priAllP);
+                    ***/
+
+                    /***
+                    delete[] priRotP;
+                    delete[] priAllP;
+                    ***/
+                }
+            }
+
+            TSFFTW_free(poolPriRotP);
+
+            TSFFTW_free(poolPriRotReP);
+            TSFFTW_free(poolPriRotImP);
+
+            TSFFTW_free(poolPriAllReP);
+            TSFFTW_free(poolPriAllImP);
+        }
+
+        // the rotations and translations of all poses, as the particle filter
+        // of each image only keeps those of its significant poses
+
+        mat4 rAll = par.r();
+        mat2 tAll = par.t();
+
+        vec wRAll = par.wR();
+        vec wTAll = par.wT();
+
+        // rotations of the significant poses of each image refined by later
+        // stages of coarse-to-fine global search
+
+        vector<mat4> rImg(_ID.size());
+
+        if (nStage > 1)
+        {
+            // later stages score the orientations of each image individually,
+            // thus the pre-calculated data are re-arranged image by image, at
+            // the full radius
+
+            freePreCal(false);
+            freePreCalIdx();
+
+            allocPreCalIdx(_r, _rL);
+            allocPreCal(false, false);
+
+            TSFFTW_free(traReP);
+            TSFFTW_free(traImP);
+
+            traReP = (EFLOAT*)TSFFTW_malloc(nT * _nPxl * sizeof(EFLOAT));
+            traImP = (EFLOAT*)TSFFTW_malloc(nT * _nPxl * sizeof(EFLOAT));
+
+            translate(traReP,
+                      traImP,
+                      traT,
+                      _para.size,
+                      _para.size,
+                      _iCol,
+                      _iRow,
+                      _nPxl);
+
+            ComplexE* poolPriRotP = (ComplexE*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(ComplexE));
+
+            EFLOAT* poolPriRotReP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+            EFLOAT* poolPriRotImP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+
+            EFLOAT* poolPriAllReP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+            EFLOAT* poolPriAllImP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+
+            // number of orientations of each image scored by the previous stage
+
+            vector<int> nOri(_ID.size(), _para.k * nR);
+
+            for (int s = 1; s < nStage; s++)
+            {
+                // pixels are ordered by shell, thus the pixels of this stage
+                // are the leading ones
+
+                int m = _shlEnd[GSL_MIN_INT(CEIL(rStage(s)), _nShl) - 1];
+
+                // each kept orientation is refined by the orientations around
+                // it, on the grid of this stage
+
+                int nChild = GSL_MAX_INT(1, AROUND(pow(rStage(s) / rStage(s - 1), dimR)));
+
+                RFLOAT k = TSGSL_pow_2(scanMinStdR * _r / rStage(s));
+
+                size_t nOriStage = 0;
+
+                #pragma omp parallel for schedule(dynamic) reduction(+:nOriStage)
+                FOR_EACH_2D_IMAGE
+                {
+                    ComplexE* priRotP = poolPriRotP + _nPxl * omp_get_thread_num();
+
+                    EFLOAT* priRotReP = poolPriRotReP + _nPxl * omp_get_thread_num();
+                    EFLOAT* priRotImP = poolPriRotImP + _nPxl * omp_get_thread_num();
+
+                    EFLOAT* priAllReP = poolPriAllReP + _nPxl * omp_get_thread_num();
+                    EFLOAT* priAllImP = poolPriAllImP + _nPxl * omp_get_thread_num();
+
+                    // poses of the previous stage, in the descending order of
+                    // log weight
+
+                    vector<Sp> sp;
+
+                    sp.reserve(leaderBoard[l].size());
+
+                    while (!leaderBoard[l].empty())
+                    {
+                        sp.push_back(leaderBoard[l].top());
+
+                        leaderBoard[l].pop();
+                    }
+
+                    std::reverse(sp.begin(), sp.end());
+
+                    // the orientations (class and rotation) of the highest
+                    // weights
+
+                    int nKeep = GSL_MAX_INT(1, CEIL(_para.keepFracGSearch * nOri[l]));
+
+                    vector<Sp> ori;
+
+                    std::set<std::pair<unsigned int, unsigned int> > oriSet;
+
+                    for (size_t i = 0; (i < sp.size()) && ((int)ori.size() < nKeep); i++)
+                        if (oriSet.insert(std::make_pair(sp[i]._k, sp[i]._iR)).second)
+                            ori.push_back(sp[i]);
+
+                    const mat4& rPrev = (s == 1) ? rAll : rImg[l];
+
+                    mat4 r(ori.size() * nChild, 4);
+
+                    vector<unsigned int> c(ori.size() * nChild);
+
+                    mat4 d(nChild, 4);
+
+                    for (size_t j = 0; j < ori.size(); j++)
                     {
+                        if (_para.mode == MODE_2D)
+                            sampleVMS(d, vec4(1, 0, 0, 0), k, nChild);
+                        else
+                            sampleACG(d, k, k, k, nChild);
+
+                        vec4 quat = rPrev.row(ori[j]._iR).transpose();
+
+                        // the kept orientation itself remains
+
+                        r.row(j * nChild) = quat.transpose();
+
+                        for (int i = 1; i < nChild; i++)
                         {
-                            RFLOAT w = exp(dvp(l) - baseLine);
-                        
-                            #pragma omp atomic
-                            wC(l, t) += w;
+                            vec4 pert;
 
-                            wR(l, m) += w;
+                            quaternion_mul(pert, d.row(i).transpose(), quat);
 
-                            #pragma omp atomic
-                            wT(l, n) += w;
+                            r.row(j * nChild + i) = pert.transpose();
                         }
+
+                        for (int i = 0; i < nChild; i++)
+                            c[j * nChild + i] = ori[j]._k;
                     }
-                    ***/
 
-                    /***
-                    FOR_EACH_2D_IMAGE
+                    RFLOAT baseLine = -DBL_MAX;
+                    RFLOAT wTot = 0;
+
+                    for (int iR = 0; iR < r.rows(); iR++)
                     {
-                        omp_set_lock(&mtx[l]);
+                        if (_para.mode == MODE_2D)
+                        {
+                            mat22 rot2D;
+
+                            rotate2D(rot2D, vec2(r(iR, 0), r(iR, 1)));
 
-                        if ((int)leaderBoard[l].size() < nSampleMax)
-                            leaderBoard[l].push(Sp(dvp(l), t, m, n));
-                        else if (leaderBoard[l].top()._w < dvp(l))
+                            _model.proj(c[iR]).project(priRotP, rot2D, _iCol, _iRow, m);
+                        }
+                        else
                         {
-                            leaderBoard[l].pop();
+                            mat33 rot3D;
 
-                            leaderBoard[l].push(Sp(dvp(l), t, m, n));
+                            rotate3D(rot3D, r.row(iR).transpose());
+
+                            _model.proj(c[iR]).project(priRotP, rot3D, _iCol, _iRow, m);
                         }
 
-                        omp_unset_lock(&mtx[l]);
-                    }
-                    ***/
-                }
+                        for (int i = 0; i < m; i++)
+                        {
+                            priRotReP[i] = REAL(priRotP[i]);
+                            priRotImP[i] = IMAG(priRotP[i]);
+                        }
 
-                #pragma omp atomic
-                _nR += 1;
+                        for (int iT = 0; iT < nT; iT++)
+                        {
+                            const EFLOAT* traRe = traReP + _nPxl * iT;
+                            const EFLOAT* traIm = traImP + _nPxl * iT;
 
-                #pragma omp critical
-                if (_nR > (int)(nR * _para.k / 10))
-                {
-                    _nR = 0;
+                            #pragma omp simd
+                            for (int i = 0; i < m; i++)
+                            {
+                                priAllReP[i] = traRe[i] * priRotReP[i] - traIm[i] * priRotImP[i];
+                                priAllImP[i] = traRe[i] * priRotImP[i] + traIm[i] * priRotReP[i];
+                            }
 
-                    nPer += 1;
+                            RFLOAT w = logDataVSPrior(_datReP + l * _nPxl,
+                                                      _datImP + l * _nPxl,
+                                                      priAllReP,
+                                                      priAllImP,
+                                                      _ctfP + l * _nPxl,
+                                                      _sigRcpP + l * _nPxl,
+                                                      m);
 
-                    ALOG(INFO, "LOGGER_ROUND") << nPer * 10
-                                               << "\% Initial Phase of Global Search Performed";
-                    BLOG(INFO, "LOGGER_ROUND") << nPer * 10
-                                               << "\% Initial Phase of Global Search Performed";
-                }
+                            if (w > baseLine)
+                            {
+                                wTot *= exp(baseLine - w);
 
+                                baseLine = w;
+                            }
 
-                /***
-#ifdef FFTW_PTR_THREAD_SAFETY
-                #pragma omp critical
-#endif
-                TSFFTW_free(priRotP);
+                            wTot += exp(w - baseLine);
 
-#ifdef FFTW_PTR_THREAD_SAFETY
-                #pragma omp critical
-#endif
-                TSFFTW_free(priAllP);
-                ***/
+                            if (((int)leaderBoard[l].size() < _para.nSigPose)
+                             || (w > leaderBoard[l].top()._w))
+                            {
+                                leaderBoard[l].push(Sp(w, c[iR], iR, iT));
 
-                /***
-                delete[] priRotP;
-                delete[] priAllP;
-                ***/
+                                if ((int)leaderBoard[l].size() > _para.nSigPose)
+                                    leaderBoard[l].pop();
+                            }
+                        }
+                    }
+
+                    rImg[l] = r;
+
+                    nOri[l] = r.rows();
+
+                    nOriStage += r.rows();
+
+                    // the total weight of this stage replaces the one of the
+                    // previous stage
+
+                    baseLineTh.row(l).setConstant(-DBL_MAX);
+                    wTotTh.row(l).setZero();
+
+                    baseLineTh(l, 0) = baseLine;
+                    wTotTh(l, 0) = wTot;
+                }
+
+                ALOG(INFO, "LOGGER_ROUND") << "Stage " << s + 1
+                                           << " of Coarse-to-Fine Global Search Performed, Radius: "
+                                           << rStage(s)
+                                           << ", Mean Number of Orientations per Image: "
+                                           << (RFLOAT)nOriStage / _ID.size();
+                BLOG(INFO, "LOGGER_ROUND") << "Stage " << s + 1
+                                           << " of Coarse-to-Fine Global Search Performed, Radius: "
+                                           << rStage(s)
+                                           << ", Mean Number of Orientations per Image: "
+                                           << (RFLOAT)nOriStage / _ID.size();
             }
 
             TSFFTW_free(poolPriRotP);
-            TSFFTW_free(poolPriAllP);
+
+            TSFFTW_free(poolPriRotReP);
+            TSFFTW_free(poolPriRotImP);
+
+            TSFFTW_free(poolPriAllReP);
+            TSFFTW_free(poolPriAllImP);
         }
 
-        delete[] mtx;
-        delete[] baseLine;
-        
-        /***
-        mat topW(nSampleMax, _ID.size());
+        RFLOAT wSig = 0;
 
-        umat iTopC(nSampleMax, _ID.size());
-        umat iTopR(nSampleMax, _ID.size());
-        umat iTopT(nSampleMax, _ID.size());
+        // reduce weights of classes, rotations and translations from the
+        // significant poses, and reset weights of particle filter
 
-        #pragma omp parallel for
-        for (int j = 0; j < (int)_ID.size(); j++)
+        #pragma omp parallel for reduction(+:wSig)
+        FOR_EACH_2D_IMAGE
         {
-            int leaderBoardSize = leaderBoard[j].size();
+            // poses in the ascending order of log weight
+
+            vector<Sp> sp;
 
-            for (int i = 0; i < leaderBoardSize; i++)
+            sp.reserve(leaderBoard[l].size());
+
+            while (!leaderBoard[l].empty())
             {
-                topW(i, j) = leaderBoard[j].top()._w;
+                sp.push_back(leaderBoard[l].top());
 
-                iTopC(i, j) = leaderBoard[j].top()._k;
-                iTopR(i, j) = leaderBoard[j].top()._iR;
-                iTopT(i, j) = leaderBoard[j].top()._iT;
+                leaderBoard[l].pop();
+            }
 
-                leaderBoard[j].pop();
+            if (sp.empty())
+            {
+                REPORT_ERROR("NO SIGNIFICANT POSE");
+
+                abort();
             }
-        }
 
-        #pragma omp parallel for
-        FOR_EACH_2D_IMAGE
-        {
-            vec v = topW.col(l);
+            RFLOAT wMax = sp.back()._w;
 
-#ifdef OPTIMISER_EXPECTATION_REMOVE_TAIL
-            RFLOAT s = 0;
-            for (int i = 0; i < v.size(); i++)
-                s += exp(v(i));
+            // the rotations and translations of significant poses
 
-            RFLOAT c = 0;
-            for (int i = v.size() - 1; i >= 0; i--)
+            vector<unsigned int> iR(sp.size());
+            vector<unsigned int> iT(sp.size());
+
+            for (size_t i = 0; i < sp.size(); i++)
             {
-                if (c < s * 0.9999)
-                {
-                    c += exp(v(i));
-                }
-                else
-                    v(i) = -GSL_DBL_MAX;
+                iR[i] = sp[i]._iR;
+                iT[i] = sp[i]._iT;
+            }
+
+            std::sort(iR.begin(), iR.end());
+            iR.erase(std::unique(iR.begin(), iR.end()), iR.end());
+
+            std::sort(iT.begin(), iT.end());
+            iT.erase(std::unique(iT.begin(), iT.end()), iT.end());
+
+            vec wC = vec::Zero(_para.k);
+            vec wR = vec::Zero(iR.size());
+            vec wT = vec::Zero(iT.size());
+
+            RFLOAT wSum = 0;
+
+            for (size_t i = 0; i < sp.size(); i++)
+            {
+                RFLOAT w = exp(sp[i]._w - wMax);
+
+                wC(sp[i]._k) += w;
+                wR(std::lower_bound(iR.begin(), iR.end(), sp[i]._iR) - iR.begin()) += w;
+                wT(std::lower_bound(iT.begin(), iT.end(), sp[i]._iT) - iT.begin()) += w;
+
+                wSum += w;
             }
-#endif
 
-#ifdef OPTIMISER_EXPECTATION_REMOVE_AUXILIARY_CLASS
-            unsigned int cls = iTopC(v.size() - 1, l);
-            
-            for (int i = 0; i < v.size(); i++)
-                if (iTopC(i, l) != cls)
-                    v(i) = -GSL_DBL_MAX;
-#endif
+            // fraction of the total weight kept by the significant poses
 
-            //PROCESS_LOGW_SOFT(v);
-            PROCESS_LOGW_HARD(v);
+            RFLOAT baseLine = baseLineTh.row(l).maxCoeff();
 
-            topW.col(l) = v;
-        }
-        ***/
+            RFLOAT wTot = 0;
 
-        // reset weights of particle filter
+            for (int th = 0; th < nThread; th++)
+                wTot += wTotTh(l, th) * exp(baseLineTh(l, th) - baseLine);
 
-        #pragma omp parallel for
-        FOR_EACH_2D_IMAGE
-        {
+            wSig += wSum * exp(wMax - baseLine) / wTot;
 
 #ifndef NAN_NO_CHECK
 
-            if ((wC.row(l).sum() == 0) || (TSGSL_isnan(wC.row(l).sum())))
+            if ((wC.sum() == 0) || (TSGSL_isnan(wC.sum())))
             {
                 REPORT_ERROR("WC, NAN DETECTED");
 
                 abort();
             }
 
-            if ((wR.row(l).sum() == 0) || (TSGSL_isnan(wR.row(l).sum())))
+            if ((wR.sum() == 0) || (TSGSL_isnan(wR.sum())))
             {
                 REPORT_ERROR("WR, NAN DETECTED");
 
                 abort();
             }
 
-            if ((wT.row(l).sum() == 0) || (TSGSL_isnan(wT.row(l).sum())))
+            if ((wT.sum() == 0) || (TSGSL_isnan(wT.sum())))
             {
                 REPORT_ERROR("WT, NAN DETECTED");
 
@@ -965,12 +1404,46 @@ void Optimiser::expectation()
 
 #endif
 
-            for (int iC = 0; iC < _para.k; iC++)
-                _par[l].setUC(wC(l, iC), iC);
-            for (int iR = 0; iR < nR; iR++)
-                _par[l].setUR(wR(l, iR), iR);
-            for (int iT = 0; iT < nT; iT++)
-                _par[l].setUT(wT(l, iT), iT);
+            // the previous top class, translation, rotation remain
+            par.copy(_par[l]);
+
+            mat4 r(iR.size(), 4);
+            vec wRPar(iR.size());
+
+            for (size_t i = 0; i < iR.size(); i++)
+            {
+                if (nStage > 1)
+                {
+                    r.row(i) = rImg[l].row(iR[i]);
+                    wRPar(i) = 1.0 / iR.size();
+                }
+                else
+                {
+                    r.row(i) = rAll.row(iR[i]);
+                    wRPar(i) = wRAll(iR[i]);
+                }
+            }
+
+            mat2 t(iT.size(), 2);
+            vec wTPar(iT.size());
+
+            for (size_t i = 0; i < iT.size(); i++)
+            {
+                t.row(i) = tAll.row(iT[i]);
+                wTPar(i) = wTAll(iT[i]);
+            }
+
+            _par[l].setNR(iR.size());
+            _par[l].setR(r);
+            _par[l].setWR(wRPar);
+
+            _par[l].setNT(iT.size());
+            _par[l].setT(t);
+            _par[l].setWT(wTPar);
+
+            _par[l].setUC(wC);
+            _par[l].setUR(wR);
+            _par[l].setUT(wT);
 
             //_par[l].normW();
 
@@ -1107,6 +1580,16 @@ void Optimiser::expectation()
 #endif
         }
 
+        delete[] leaderBoardThres;
+
+        for (int i = 0; i < OPTIMISER_LEADER_BOARD_N_LOCK; i++)
+            omp_destroy_lock(&mtx[i]);
+
+        ALOG(INFO, "LOGGER_ROUND") << "Mean Fraction of Weight Kept by Significant Poses in Global Search: "
+                                   << wSig / _ID.size();
+        BLOG(INFO, "LOGGER_ROUND") << "Mean Fraction of Weight Kept by Significant Poses in Global Search: "
+                                   << wSig / _ID.size();
+
         ALOG(INFO, "LOGGER_ROUND") << "Initial Phase of Global Search Performed.";
         BLOG(INFO, "LOGGER_ROUND") << "Initial Phase of Global Search Performed.";
 
@@ -1117,9 +1600,24 @@ void Optimiser::expectation()
         BLOG(INFO, "LOGGER_ROUND") << "Initial Phase of Global Search in Hemisphere B Performed";
 #endif
 
-        TSFFTW_free(traP);
+        TSFFTW_free(traReP);
+        TSFFTW_free(traImP);
         //delete[] traP;
 
+        if (_para.transSearchFFT)
+        {
+            for (int i = 0; i < omp_get_max_threads(); i++)
+                poolFFTCC[i].bwDestroyPlan();
+
+            delete[] poolCC;
+            TSFFTW_free(poolCCFT);
+            delete[] poolFFTCC;
+        }
+
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+        freePreCalGEMM();
+#endif
+
         if (_searchType != SEARCH_TYPE_CTF)
             freePreCal(false);
         else
@@ -1140,23 +1638,63 @@ void Optimiser::expectation()
 
     nPer = 0;
 
-    Complex* poolPriRotP = (Complex*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(Complex));
-    Complex* poolPriAllP = (Complex*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(Complex));
+    ComplexE* poolPriRotP = (ComplexE*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(ComplexE));
 
-    Complex* poolTraP = (Complex*)TSFFTW_malloc(_para.mLT * _nPxl * omp_get_max_threads() * sizeof(Complex));
+    EFLOAT* poolPriRotReP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+    EFLOAT* poolPriRotImP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
 
-    RFLOAT* poolCtfP;
+    EFLOAT* poolPriAllReP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+    EFLOAT* poolPriAllImP = (EFLOAT*)TSFFTW_malloc(_nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+
+    EFLOAT* poolTraReP = (EFLOAT*)TSFFTW_malloc(_para.mLT * _nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+    EFLOAT* poolTraImP = (EFLOAT*)TSFFTW_malloc(_para.mLT * _nPxl * omp_get_max_threads() * sizeof(EFLOAT));
+
+    EFLOAT* poolCtfP;
 
     if (_searchType == SEARCH_TYPE_CTF)
-        poolCtfP = (RFLOAT*)TSFFTW_malloc(_para.mLD * _nPxl * omp_get_max_threads() * sizeof(RFLOAT));
+        poolCtfP = (EFLOAT*)TSFFTW_malloc(_para.mLD * _nPxl * omp_get_max_threads() * sizeof(EFLOAT));
 
-    #pragma omp parallel for schedule(dynamic)
+    RFLOAT logEps = (_para.earlyAbandonEps > 0)
+                  ? log(_para.earlyAbandonEps)
+                  : -DBL_MAX;
+
+    // the translations of the table of each thread
+
+    vector<mat2> poolTraPrev(omp_get_max_threads());
+
+    // projections shared by images of similar orientations, only valid for
+    // the projectors of this iteration
+
+    ProjectionCache* projCache = NULL;
+
+    if (_para.projCacheSize > 0)
+    {
+        projCache = new ProjectionCache(_para.projCacheSize,
+                                        _nPxl,
+                                        _para.projCacheStep,
+                                        _para.mode == MODE_3D);
+
+        ALOG(INFO, "LOGGER_ROUND") << "Capacity of Projection Cache in Local Search: "
+                                   << projCache->capacity();
+        BLOG(INFO, "LOGGER_ROUND") << "Capacity of Projection Cache in Local Search: "
+                                   << projCache->capacity();
+    }
+
+    size_t nAbandon = 0;
+    size_t nTraReuse = 0;
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:nAbandon, nTraReuse)
     FOR_EACH_2D_IMAGE
     {
         RFLOAT baseLine = GSL_NAN;
 
-        Complex* priRotP = poolPriRotP + _nPxl * omp_get_thread_num();
-        Complex* priAllP = poolPriAllP + _nPxl * omp_get_thread_num();
+        ComplexE* priRotP = poolPriRotP + _nPxl * omp_get_thread_num();
+
+        EFLOAT* priRotReP = poolPriRotReP + _nPxl * omp_get_thread_num();
+        EFLOAT* priRotImP = poolPriRotImP + _nPxl * omp_get_thread_num();
+
+        EFLOAT* priAllReP = poolPriAllReP + _nPxl * omp_get_thread_num();
+        EFLOAT* priAllImP = poolPriAllImP + _nPxl * omp_get_thread_num();
 
         int nPhaseWithNoVariDecrease = 0;
 
@@ -1225,131 +1763,189 @@ void Optimiser::expectation()
             vec wT = vec::Zero(_para.mLT);
             vec wD = vec::Zero(_para.mLD);
 
+            // the best score in this phase, for abandoning candidates early
+
+            RFLOAT wMax = -DBL_MAX;
+
             unsigned int c;
             mat22 rot2D;
             mat33 rot3D;
             RFLOAT d;
             vec2 t;
 
-            //FOR_EACH_PAR(_par[l])
-            FOR_EACH_C(_par[l])
+            // translations and defoci do not depend on the class, thus their
+            // tables are built once per phase rather than once per class, and
+            // the table of translations is kept when translations are unchanged
+
+            EFLOAT* traReP = poolTraReP + _para.mLT * _nPxl * omp_get_thread_num();
+            EFLOAT* traImP = poolTraImP + _para.mLT * _nPxl * omp_get_thread_num();
+
+            mat2& traPrev = poolTraPrev[omp_get_thread_num()];
+
+            mat2 traL(_par[l].nT(), 2);
+
+            FOR_EACH_T(_par[l])
             {
-                _par[l].c(c, iC);
-                //_par[l].c(c, 0);
+                _par[l].t(t, iT);
 
-                Complex* traP = poolTraP + _par[l].nT() * _nPxl * omp_get_thread_num();
+                traL.row(iT) = t.transpose();
+            }
 
+            if ((traPrev.rows() == traL.rows()) && (traPrev == traL))
+                nTraReuse++;
+            else
+            {
                 // Complex* traP = new Complex[_par[l].nT() * _nPxl];
 
-                FOR_EACH_T(_par[l])
+                translate(traReP,
+                          traImP,
+                          traL,
+                          _para.size,
+                          _para.size,
+                          _iCol,
+                          _iRow,
+                          _nPxl);
+
+                traPrev = traL;
+            }
+
+            EFLOAT* ctfP;
+
+            if (_searchType == SEARCH_TYPE_CTF)
+            {
+                /***
+                ctfP = (RFLOAT*)TSFFTW_malloc(_par[l].nD() * _nPxl * sizeof(RFLOAT));
+
+                ctfP = new RFLOAT[_par[l].nD() * _nPxl];
+                ***/
+
+                ctfP = poolCtfP + _par[l].nD() * _nPxl * omp_get_thread_num();
+
+                FOR_EACH_D(_par[l])
                 {
-                    _par[l].t(t, iT);
-
-                    translate(traP + iT * _nPxl,
-                              t(0),
-                              t(1),
-                              _para.size,
-                              _para.size,
-                              _iCol,
-                              _iRow,
-                              _nPxl);
+                    _par[l].d(d, iD);
+
+                    for (int i = 0; i < _nPxl; i++)
+                    {
+                        RFLOAT ki = _K1[l]
+                                  * _defocusP[l * _nPxl + i]
+                                  * d
+                                  * TSGSL_pow_2(_frequency[i])
+                                  + _K2[l]
+                                  * TSGSL_pow_4(_frequency[i]);
+
+                        /***
+                        RFLOAT ki = K1 * defocus[i] * df * TSGSL_pow_2(frequency[i])
+                                  + K2 * TSGSL_pow_4(frequency[i]);
+                        ***/
+
+                        ctfP[_nPxl * iD + i] = -w1 * sin(ki) + w2 * cos(ki);
+
+                        // RFLOAT ctf = -w1 * sin(ki) + w2 * cos(ki);
+                    }
                 }
+            }
 
-                RFLOAT* ctfP;
+            //FOR_EACH_PAR(_par[l])
+            FOR_EACH_C(_par[l])
+            {
+                _par[l].c(c, iC);
+                //_par[l].c(c, 0);
 
-                if (_searchType == SEARCH_TYPE_CTF)
+                FOR_EACH_R(_par[l])
                 {
-                    /***
-                    ctfP = (RFLOAT*)TSFFTW_malloc(_par[l].nD() * _nPxl * sizeof(RFLOAT));
+                    vec4 quat;
 
-                    ctfP = new RFLOAT[_par[l].nD() * _nPxl];
-                    ***/
+                    _par[l].quaternion(quat, iR);
 
-                    ctfP = poolCtfP + _par[l].nD() * _nPxl * omp_get_thread_num();
+                    bool hit = (projCache != NULL)
+                            && projCache->get(priRotReP, priRotImP, c, quat);
 
-                    FOR_EACH_D(_par[l])
+                    if (!hit)
                     {
-                        _par[l].d(d, iD);
+                        // on miss, the projection is evaluated at the centre of
+                        // the bin of the cache
 
-                        for (int i = 0; i < _nPxl; i++)
+                        vec4 quatQ = quat;
+
+                        if (projCache != NULL)
+                            projCache->quantise(quatQ, quat);
+
+                        if (_para.mode == MODE_2D)
+                        {
+                            rotate2D(rot2D, vec2(quatQ(0), quatQ(1)));
+                        }
+                        else if (_para.mode == MODE_3D)
                         {
-                            RFLOAT ki = _K1[l]
-                                      * _defocusP[l * _nPxl + i]
-                                      * d
-                                      * TSGSL_pow_2(_frequency[i])
-                                      + _K2[l]
-                                      * TSGSL_pow_4(_frequency[i]);
+                            rotate3D(rot3D, quatQ);
+                        }
+                        else
+                        {
+                            REPORT_ERROR("INEXISTENT MODE");
+
+                            abort();
+                        }
 
+                        if (_para.mode == MODE_2D)
+                        {
+                            _model.proj(c).project(priRotP,
+                                                   rot2D,
+                                                   _iCol,
+                                                   _iRow,
+                                                   _nPxl);
                             /***
-                            RFLOAT ki = K1 * defocus[i] * df * TSGSL_pow_2(frequency[i])
-                                      + K2 * TSGSL_pow_4(frequency[i]);
+                            _model.proj(c).project(priP,
+                                                   rot2D,
+                                                   t,
+                                                   _para.size,
+                                                   _para.size,
+                                                   _iCol,
+                                                   _iRow,
+                                                   _nPxl);
+                            ***/
+                        }
+                        else if (_para.mode == MODE_3D)
+                        {
+                            _model.proj(c).project(priRotP,
+                                                   rot3D,
+                                                   _iCol,
+                                                   _iRow,
+                                                   _nPxl);
+                            /***
+                            _model.proj(c).project(priP,
+                                                   rot3D,
+                                                   t,
+                                                   _para.size,
+                                                   _para.size,
+                                                   _iCol,
+                                                   _iRow,
+                                                   _nPxl);
                             ***/
-
-                            ctfP[_nPxl * iD + i] = -w1 * sin(ki) + w2 * cos(ki);
-
-                            // RFLOAT ctf = -w1 * sin(ki) + w2 * cos(ki);
                         }
-                    }
-                }
 
-                FOR_EACH_R(_par[l])
-                {
-                    if (_para.mode == MODE_2D)
-                    {
-                        _par[l].rot(rot2D, iR);
-                    }
-                    else if (_para.mode == MODE_3D)
-                    {
-                        _par[l].rot(rot3D, iR);
-                    }
-                    else
-                    {
-                        REPORT_ERROR("INEXISTENT MODE");
+                        // split real and imaginary part for vectorisation
 
-                        abort();
-                    }
+                        for (int i = 0; i < _nPxl; i++)
+                        {
+                            priRotReP[i] = REAL(priRotP[i]);
+                            priRotImP[i] = IMAG(priRotP[i]);
+                        }
 
-                    if (_para.mode == MODE_2D)
-                    {
-                        _model.proj(c).project(priRotP,
-                                               rot2D,
-                                               _iCol,
-                                               _iRow,
-                                               _nPxl);
-                        /***
-                        _model.proj(c).project(priP,
-                                               rot2D,
-                                               t,
-                                               _para.size,
-                                               _para.size,
-                                               _iCol,
-                                               _iRow,
-                                               _nPxl);
-                        ***/
-                    }
-                    else if (_para.mode == MODE_3D)
-                    {
-                        _model.proj(c).project(priRotP,
-                                               rot3D,
-                                               _iCol,
-                                               _iRow,
-                                               _nPxl);
-                        /***
-                        _model.proj(c).project(priP,
-                                               rot3D,
-                                               t,
-                                               _para.size,
-                                               _para.size,
-                                               _iCol,
-                                               _iRow,
-                                               _nPxl);
-                        ***/
+                        if (projCache != NULL)
+                            projCache->put(priRotReP, priRotImP, c, quat);
                     }
 
                     FOR_EACH_T(_par[l])
                     {
+                        const EFLOAT* traRe = traReP + _nPxl * iT;
+                        const EFLOAT* traIm = traImP + _nPxl * iT;
+
+                        #pragma omp simd
                         for (int i = 0; i < _nPxl; i++)
-                            priAllP[i] = traP[_nPxl * iT + i] * priRotP[i];
+                        {
+                            priAllReP[i] = traRe[i] * priRotReP[i] - traIm[i] * priRotImP[i];
+                            priAllImP[i] = traRe[i] * priRotImP[i] + traIm[i] * priRotReP[i];
+                        }
 
                         /***
                         _par[l].t(t, iT);
@@ -1371,16 +1967,46 @@ void Optimiser::expectation()
 
                             RFLOAT w;
 
-                            if (_searchType != SEARCH_TYPE_CTF)
-                                w = logDataVSPrior(_datP + l * _nPxl,
-                                                   priAllP,
+                            if (_para.earlyAbandonEps > 0)
+                            {
+                                // stop as soon as the weight of this candidate
+                                // can not be above epsilon of the best one
+
+                                w = logDataVSPrior(_datReP + l * _nPxl,
+                                                   _datImP + l * _nPxl,
+                                                   priAllReP,
+                                                   priAllImP,
+                                                   (_searchType != SEARCH_TYPE_CTF)
+                                                 ? _ctfP + l * _nPxl
+                                                 : ctfP + iD * _nPxl,
+                                                   _sigRcpP + l * _nPxl,
+                                                   _shlEnd,
+                                                   _nShl,
+                                                   wMax + logEps);
+
+                                if (w < wMax + logEps)
+                                {
+                                    nAbandon++;
+
+                                    continue;
+                                }
+
+                                wMax = GSL_MAX_DBL(wMax, w);
+                            }
+                            else if (_searchType != SEARCH_TYPE_CTF)
+                                w = logDataVSPrior(_datReP + l * _nPxl,
+                                                   _datImP + l * _nPxl,
+                                                   priAllReP,
+                                                   priAllImP,
                                                    _ctfP + l * _nPxl,
                                                    _sigRcpP + l * _nPxl,
                                                    _nPxl);
                             else
                             {
-                                w = logDataVSPrior(_datP + l * _nPxl,
-                                                   priAllP,
+                                w = logDataVSPrior(_datReP + l * _nPxl,
+                                                   _datImP + l * _nPxl,
+                                                   priAllReP,
+                                                   priAllImP,
                                                    ctfP + iD * _nPxl,
                                                    _sigRcpP + l * _nPxl,
                                                    _nPxl);
@@ -1617,13 +2243,46 @@ void Optimiser::expectation()
     }
 
     TSFFTW_free(poolPriRotP);
-    TSFFTW_free(poolPriAllP);
 
-    TSFFTW_free(poolTraP);
+    TSFFTW_free(poolPriRotReP);
+    TSFFTW_free(poolPriRotImP);
+
+    TSFFTW_free(poolPriAllReP);
+    TSFFTW_free(poolPriAllImP);
+
+    TSFFTW_free(poolTraReP);
+    TSFFTW_free(poolTraImP);
 
     if (_searchType == SEARCH_TYPE_CTF)
         TSFFTW_free(poolCtfP);
 
+    ALOG(INFO, "LOGGER_ROUND") << "Number of Tables of Translations Reused in Local Search: "
+                               << nTraReuse;
+    BLOG(INFO, "LOGGER_ROUND") << "Number of Tables of Translations Reused in Local Search: "
+                               << nTraReuse;
+
+    if (_para.earlyAbandonEps > 0)
+    {
+        ALOG(INFO, "LOGGER_ROUND") << "Number of Candidates Abandoned Early in Local Search: "
+                                   << nAbandon;
+        BLOG(INFO, "LOGGER_ROUND") << "Number of Candidates Abandoned Early in Local Search: "
+                                   << nAbandon;
+    }
+
+    if (projCache != NULL)
+    {
+        size_t nLookUp = projCache->nHit() + projCache->nMiss();
+
+        ALOG(INFO, "LOGGER_ROUND") << "Hit Rate of Projection Cache in Local Search: "
+                                   << (RFLOAT)projCache->nHit() / GSL_MAX_DBL(1, nLookUp)
+                                   << " (" << projCache->nHit() << " / " << nLookUp << ")";
+        BLOG(INFO, "LOGGER_ROUND") << "Hit Rate of Projection Cache in Local Search: "
+                                   << (RFLOAT)projCache->nHit() / GSL_MAX_DBL(1, nLookUp)
+                                   << " (" << projCache->nHit() << " / " << nLookUp << ")";
+
+        delete projCache;
+    }
+
     ALOG(INFO, "LOGGER_ROUND") << "Freeing Space for Pre-calcuation in Expectation";
     BLOG(INFO, "LOGGER_ROUND") << "Freeing Space for Pre-calcuation in Expectation";
 
@@ -3962,6 +4621,16 @@ void Optimiser::reconstructRef(const bool fscFlag,
     
     allocPreCalIdx(_model.rU(), 0);
 
+    MPI_Comm node;
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, _commRank, MPI_INFO_NULL, &node);
+
+    int nProcNode;
+
+    MPI_Comm_size(node, &nProcNode);
+
+    MPI_Comm_free(&node);
+
     NT_MASTER
     {
         if ((_para.parGra) && (_para.k != 1))
@@ -3976,157 +4645,185 @@ void Optimiser::reconstructRef(const bool fscFlag,
         for (int t = 0; t < _para.k; t++)
             _model.reco(t).setPreCal(_nPxl, _iCol, _iRow, _iPxl, _iSig);
 
+        // the memory of the node is shared by the processes on it and the
+        // reconstructors of all classes
+
+        size_t memory = availableMemory() * INSERT_MEMORY_FRACTION / nProcNode / _para.k;
+
+        // the images are inserted into the reconstructors of all classes
+
+        size_t nInsert = _ID.size() * _para.mReco / _para.k;
+
+        int nImgBatch = INT_MAX;
+
+        for (int t = 0; t < _para.k; t++)
+        {
+            _model.reco(t).allocInsert(memory, nInsert);
+
+            nImgBatch = GSL_MIN_INT(nImgBatch, _model.reco(t).insertBatch() / _para.mReco);
+        }
+
+        nImgBatch = GSL_MAX_INT(1, nImgBatch);
+
         bool cSearch = ((_searchType == SEARCH_TYPE_CTF) ||
                         ((_para.cSearch) &&
                         (_searchType == SEARCH_TYPE_STOP)));
 
-        #pragma omp parallel for
-        FOR_EACH_2D_IMAGE
+        for (size_t lBatch = 0; lBatch < _ID.size(); lBatch += nImgBatch)
         {
-            Image ctf(_para.size, _para.size, FT_SPACE);
+            ptrdiff_t lEnd = GSL_MIN(lBatch + nImgBatch, _ID.size());
 
-            RFLOAT w;
+            #pragma omp parallel for
+            for (ptrdiff_t l = lBatch; l < lEnd; l++)
+            {
+                Image ctf(_para.size, _para.size, FT_SPACE);
 
-            if ((_para.parGra) && (_para.k == 1))
-                w = _par[l].compress();
-            else
-                w = 1;
+                RFLOAT w;
 
-            w /= _para.mReco;
+                if ((_para.parGra) && (_para.k == 1))
+                    w = _par[l].compress();
+                else
+                    w = 1;
 
-            Image transImg(_para.size, _para.size, FT_SPACE);
+                w /= _para.mReco;
 
-            for (int m = 0; m < _para.mReco; m++)
-            {
-                unsigned int cls;
-                vec4 quat;
-                vec2 tran;
-                RFLOAT d;
+                Image transImg(_para.size, _para.size, FT_SPACE);
 
-                if (_para.mode == MODE_2D)
+                for (int m = 0; m < _para.mReco; m++)
                 {
-                    _par[l].rand(cls, quat, tran, d);
+                    unsigned int cls;
+                    vec4 quat;
+                    vec2 tran;
+                    RFLOAT d;
+
+                    if (_para.mode == MODE_2D)
+                    {
+                        _par[l].rand(cls, quat, tran, d);
 
-                    mat22 rot2D;
+                        mat22 rot2D;
 
-                    rotate2D(rot2D, vec2(quat(0), quat(1)));
+                        rotate2D(rot2D, vec2(quat(0), quat(1)));
 
 #ifdef OPTIMISER_RECONSTRUCT_WITH_UNMASK_IMAGE
-                    translate(transImg,
-                              _imgOri[l],
-                              -(tran - _offset[l])(0),
-                              -(tran - _offset[l])(1),
-                              _iCol,
-                              _iRow,
-                              _iPxl,
-                              _nPxl);
+                        translate(transImg,
+                                  _imgOri[l],
+                                  -(tran - _offset[l])(0),
+                                  -(tran - _offset[l])(1),
+                                  _iCol,
+                                  _iRow,
+                                  _iPxl,
+                                  _nPxl);
 #else
-                    translate(transImg,
-                              _img[l],
-                              -tran(0),
-                              -tran(1),
-                              _iCol,
-                              _iRow,
-                              _iPxl,
-                              _nPxl);
-#endif
-
-                    if (cSearch)
-                        CTF(ctf,
-                            _para.pixelSize,
-                            _ctfAttr[l].voltage,
-                            _ctfAttr[l].defocusU * d,
-                            _ctfAttr[l].defocusV * d,
-                            _ctfAttr[l].defocusTheta,
-                            _ctfAttr[l].Cs);
+                        translate(transImg,
+                                  _img[l],
+                                  -tran(0),
+                                  -tran(1),
+                                  _iCol,
+                                  _iRow,
+                                  _iPxl,
+                                  _nPxl);
+#endif
+
+                        if (cSearch)
+                            CTF(ctf,
+                                _para.pixelSize,
+                                _ctfAttr[l].voltage,
+                                _ctfAttr[l].defocusU * d,
+                                _ctfAttr[l].defocusV * d,
+                                _ctfAttr[l].defocusTheta,
+                                _ctfAttr[l].Cs);
 
 #ifdef OPTIMISER_RECONSTRUCT_SIGMA_REGULARISE
-                    vec sig = _sig.row(_groupID[l] - 1).transpose();
+                        vec sig = _sig.row(_groupID[l] - 1).transpose();
 
-                    _model.reco(cls).insertP(transImg,
-                                             cSearch ? ctf : _ctf[l],
-                                             rot2D,
-                                             w,
-                                             &sig);
+                        _model.reco(cls).insertP(transImg,
+                                                 cSearch ? ctf : _ctf[l],
+                                                 rot2D,
+                                                 w,
+                                                 &sig);
 #else
-                    _model.reco(cls).insertP(transImg,
-                                             cSearch ? ctf : _ctf[l],
-                                             rot2D,
-                                             w);
+                        _model.reco(cls).insertP(transImg,
+                                                 cSearch ? ctf : _ctf[l],
+                                                 rot2D,
+                                                 w);
 #endif
-                }
-                else if (_para.mode == MODE_3D)
-                {
-                    _par[l].rand(cls, quat, tran, d);
+                    }
+                    else if (_para.mode == MODE_3D)
+                    {
+                        _par[l].rand(cls, quat, tran, d);
 
-                    mat33 rot3D;
+                        mat33 rot3D;
 
-                    rotate3D(rot3D, quat);
+                        rotate3D(rot3D, quat);
                 
 #ifdef OPTIMISER_RECONSTRUCT_WITH_UNMASK_IMAGE
-                    translate(transImg,
-                              _imgOri[l],
-                              -(tran - _offset[l])(0),
-                              -(tran - _offset[l])(1),
-                              _iCol,
-                              _iRow,
-                              _iPxl,
-                              _nPxl);
+                        translate(transImg,
+                                  _imgOri[l],
+                                  -(tran - _offset[l])(0),
+                                  -(tran - _offset[l])(1),
+                                  _iCol,
+                                  _iRow,
+                                  _iPxl,
+                                  _nPxl);
 #else
-                    translate(transImg,
-                              _img[l],
-                              -tran(0),
-                              -tran(1),
-                              _iCol,
-                              _iRow,
-                              _iPxl,
-                              _nPxl);
+                        translate(transImg,
+                                  _img[l],
+                                  -tran(0),
+                                  -tran(1),
+                                  _iCol,
+                                  _iRow,
+                                  _iPxl,
+                                  _nPxl);
 #endif
 
-                    /***
+                        /***
 #ifdef OPTIMISER_RECONSTRUCT_SIGMA_REGULARISE
 
-                    IMAGE_FOR_EACH_PIXEL_FT(transImg)
-                        if (QUAD(i, j) < TSGSL_pow_2(_model.reco(cls).maxRadius()))
-                            transImg.setFTHalf(transImg.getFTHalf(i, j)
-                                             / _sig(_groupID[l] - 1, AROUND(NORM(i, j))),
-                                               i,
-                                               j);
+                        IMAGE_FOR_EACH_PIXEL_FT(transImg)
+                            if (QUAD(i, j) < TSGSL_pow_2(_model.reco(cls).maxRadius()))
+                                transImg.setFTHalf(transImg.getFTHalf(i, j)
+                                                 / _sig(_groupID[l] - 1, AROUND(NORM(i, j))),
+                                                   i,
+                                                   j);
                                          
 #endif
-                    **/
+                        **/
 
-                    if (cSearch)
-                        CTF(ctf,
-                            _para.pixelSize,
-                            _ctfAttr[l].voltage,
-                            _ctfAttr[l].defocusU * d,
-                            _ctfAttr[l].defocusV * d,
-                            _ctfAttr[l].defocusTheta,
-                            _ctfAttr[l].Cs);
+                        if (cSearch)
+                            CTF(ctf,
+                                _para.pixelSize,
+                                _ctfAttr[l].voltage,
+                                _ctfAttr[l].defocusU * d,
+                                _ctfAttr[l].defocusV * d,
+                                _ctfAttr[l].defocusTheta,
+                                _ctfAttr[l].Cs);
 
 #ifdef OPTIMISER_RECONSTRUCT_SIGMA_REGULARISE
-                    vec sig = _sig.row(_groupID[l] - 1).transpose();
+                        vec sig = _sig.row(_groupID[l] - 1).transpose();
 
-                    _model.reco(cls).insertP(transImg,
-                                             cSearch ? ctf : _ctf[l],
-                                             rot3D,
-                                             w,
-                                             &sig);
+                        _model.reco(cls).insertP(transImg,
+                                                 cSearch ? ctf : _ctf[l],
+                                                 rot3D,
+                                                 w,
+                                                 &sig);
 #else
-                    _model.reco(cls).insertP(transImg,
-                                             cSearch ? ctf : _ctf[l],
-                                             rot3D,
-                                             w);
+                        _model.reco(cls).insertP(transImg,
+                                                 cSearch ? ctf : _ctf[l],
+                                                 rot3D,
+                                                 w);
 #endif
-                }
-                else
-                {
-                    REPORT_ERROR("INEXISTENT MODE");
+                    }
+                    else
+                    {
+                        REPORT_ERROR("INEXISTENT MODE");
 
-                    abort();
+                        abort();
+                    }
                 }
             }
+
+            for (int t = 0; t < _para.k; t++)
+                _model.reco(t).flushInsert();
         }
 
 #ifdef VERBOSE_LEVEL_2
@@ -4135,6 +4832,9 @@ void Optimiser::reconstructRef(const bool fscFlag,
 
         MPI_Barrier(_hemi);
 
+        // the reconstructor of a class is all-reduced while the insertion into
+        // the reconstructors of the following classes is being finished
+
         for (int t = 0; t < _para.k; t++)
         {
             ALOG(INFO, "LOGGER_ROUND") << "Preparing Content in Reconstructor of Reference "
@@ -4142,8 +4842,11 @@ void Optimiser::reconstructRef(const bool fscFlag,
             BLOG(INFO, "LOGGER_ROUND") << "Preparing Content in Reconstructor of Reference "
                                        << t;
 
-            _model.reco(t).prepareTF();
+            _model.reco(t).beginPrepareTF();
         }
+
+        for (int t = 0; t < _para.k; t++)
+            _model.reco(t).endPrepareTF();
     }
 
     MPI_Barrier(MPI_COMM_WORLD);
@@ -4152,8 +4855,17 @@ void Optimiser::reconstructRef(const bool fscFlag,
     {
         NT_MASTER
         {
+            // with the classes spread across the processes of the hemisphere,
+            // each process reconstructs the references of its own classes
+
+            int hemiRank;
+
+            MPI_Comm_rank(_hemi, &hemiRank);
+
             for (int t = 0; t < _para.k; t++)
             {
+                if (_para.classParallel && (_model.classOwner(t) != hemiRank)) continue;
+
                 _model.reco(t).setMAP(false);
 
                 ALOG(INFO, "LOGGER_ROUND") << "Reconstructing Reference "
@@ -4184,6 +4896,8 @@ void Optimiser::reconstructRef(const bool fscFlag,
                 BLOG(INFO, "LOGGER_ROUND") << "Reference " << t << "Fourier Transformed";
 #endif
             }
+
+            if (_para.classParallel) bcastClassRef();
         }
 
         if (fscSave)
@@ -4232,8 +4946,17 @@ void Optimiser::reconstructRef(const bool fscFlag,
     {
         NT_MASTER
         {
+            // with the classes spread across the processes of the hemisphere,
+            // each process reconstructs the references of its own classes
+
+            int hemiRank;
+
+            MPI_Comm_rank(_hemi, &hemiRank);
+
             for (int t = 0; t < _para.k; t++)
             {
+                if (_para.classParallel && (_model.classOwner(t) != hemiRank)) continue;
+
                 _model.reco(t).setMAP(true);
 
                 ALOG(INFO, "LOGGER_ROUND") << "Reconstructing Reference "
@@ -4264,6 +4987,8 @@ void Optimiser::reconstructRef(const bool fscFlag,
                 BLOG(INFO, "LOGGER_ROUND") << "Reference " << t << "Fourier Transformed";
 #endif
             }
+
+            if (_para.classParallel) bcastClassRef();
         }
 
         if (avgSave)
@@ -4320,6 +5045,19 @@ void Optimiser::reconstructRef(const bool fscFlag,
     BLOG(INFO, "LOGGER_ROUND") << "Reference(s) Reconstructed";
 }
 
+void Optimiser::bcastClassRef()
+{
+    ALOG(INFO, "LOGGER_ROUND") << "Broadcasting Reference(s) Reconstructed by Each Process";
+    BLOG(INFO, "LOGGER_ROUND") << "Broadcasting Reference(s) Reconstructed by Each Process";
+
+    for (int t = 0; t < _para.k; t++)
+        MPI_Bcast_Large(&_model.ref(t)[0],
+                        _model.ref(t).sizeFT(),
+                        MPI_DOUBLE_COMPLEX,
+                        _model.classOwner(t),
+                        _hemi);
+}
+
 void Optimiser::solventFlatten(const bool mask)
 {
     IF_MASTER return;
@@ -4528,7 +5266,41 @@ void Optimiser::allocPreCalIdx(const RFLOAT rU,
     RFLOAT rU2 = TSGSL_pow_2(rU);
     RFLOAT rL2 = TSGSL_pow_2(rL);
 
-    _nPxl = 0;
+    // pixels are ordered by shell, from low frequency to high frequency
+
+    int nShl = CEIL(rU) + 1;
+
+    _shlEnd = new int[nShl];
+
+    for (int v = 0; v < nShl; v++)
+        _shlEnd[v] = 0;
+
+    IMAGE_FOR_PIXEL_R_FT(rU + 1)
+    {
+        RFLOAT u = QUAD(i, j);
+
+        if ((u < rU2) && (u >= rL2))
+        {
+            int v = AROUND(NORM(i, j));
+
+            if ((v < rU) && (v >= rL))
+                _shlEnd[v]++;
+        }
+    }
+
+    for (int v = 1; v < nShl; v++)
+        _shlEnd[v] += _shlEnd[v - 1];
+
+    _nPxl = _shlEnd[nShl - 1];
+
+    _nShl = nShl;
+
+    int* cur = new int[nShl];
+
+    cur[0] = 0;
+
+    for (int v = 1; v < nShl; v++)
+        cur[v] = _shlEnd[v - 1];
 
     IMAGE_FOR_PIXEL_R_FT(rU + 1)
     {
@@ -4540,18 +5312,20 @@ void Optimiser::allocPreCalIdx(const RFLOAT rU,
 
             if ((v < rU) && (v >= rL))
             {
-                _iPxl[_nPxl] = _img[0].iFTHalf(i, j);
+                int p = cur[v]++;
 
-                _iCol[_nPxl] = i;
+                _iPxl[p] = _img[0].iFTHalf(i, j);
 
-                _iRow[_nPxl] = j;
+                _iCol[p] = i;
 
-                _iSig[_nPxl] = v;
+                _iRow[p] = j;
 
-                _nPxl++;
+                _iSig[p] = v;
             }
         }
     }
+
+    delete[] cur;
 }
 
 void Optimiser::allocPreCal(const bool pixelMajor,
@@ -4559,28 +5333,32 @@ void Optimiser::allocPreCal(const bool pixelMajor,
 {
     IF_MASTER return;
 
-    _datP = (Complex*)TSFFTW_malloc(_ID.size() * _nPxl * sizeof(Complex));
+    _datReP = (EFLOAT*)TSFFTW_malloc(_ID.size() * _nPxl * sizeof(EFLOAT));
 
-    _ctfP = (RFLOAT*)TSFFTW_malloc(_ID.size() * _nPxl * sizeof(RFLOAT));
+    _datImP = (EFLOAT*)TSFFTW_malloc(_ID.size() * _nPxl * sizeof(EFLOAT));
 
-    _sigRcpP = (RFLOAT*)TSFFTW_malloc(_ID.size() * _nPxl * sizeof(RFLOAT));
+    _ctfP = (EFLOAT*)TSFFTW_malloc(_ID.size() * _nPxl * sizeof(EFLOAT));
+
+    _sigRcpP = (EFLOAT*)TSFFTW_malloc(_ID.size() * _nPxl * sizeof(EFLOAT));
 
     #pragma omp parallel for
     FOR_EACH_2D_IMAGE
     {
         for (int i = 0; i < _nPxl; i++)
         {
-            _datP[pixelMajor
-                ? (i * _ID.size() + l)
-                : (_nPxl * l + i)] = _img[l].iGetFT(_iPxl[i]);
+            size_t idx = pixelMajor
+                       ? (i * _ID.size() + l)
+                       : (_nPxl * l + i);
+
+            Complex dat = _img[l].iGetFT(_iPxl[i]);
+
+            _datReP[idx] = REAL(dat);
+
+            _datImP[idx] = IMAG(dat);
 
-            _ctfP[pixelMajor
-                ? (i * _ID.size() + l)
-                : (_nPxl * l + i)] = REAL(_ctf[l].iGetFT(_iPxl[i]));
+            _ctfP[idx] = REAL(_ctf[l].iGetFT(_iPxl[i]));
 
-            _sigRcpP[pixelMajor
-                   ? (i * _ID.size() + l)
-                   : (_nPxl * l + i)] = _sigRcp(_groupID[l] - 1, _iSig[i]);
+            _sigRcpP[idx] = _sigRcp(_groupID[l] - 1, _iSig[i]);
         }
     }
 
@@ -4629,6 +5407,63 @@ void Optimiser::allocPreCal(const bool pixelMajor,
     }
 }
 
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+void Optimiser::allocPreCalGEMM()
+{
+    IF_MASTER return;
+
+    _datCrossReP = (EFLOAT*)TSFFTW_malloc(_ID.size() * _nPxl * sizeof(EFLOAT));
+
+    _datCrossImP = (EFLOAT*)TSFFTW_malloc(_ID.size() * _nPxl * sizeof(EFLOAT));
+
+    _ctf2SigRcpP = (EFLOAT*)TSFFTW_malloc(_ID.size() * _nPxl * sizeof(EFLOAT));
+
+    _datNormP = (RFLOAT*)TSFFTW_malloc(_ID.size() * sizeof(RFLOAT));
+
+    #pragma omp parallel for
+    FOR_EACH_2D_IMAGE
+    {
+        RFLOAT norm = 0;
+
+        for (int i = 0; i < _nPxl; i++)
+        {
+            size_t idx = i * _ID.size() + l;
+
+            // evaluated from the images directly, thus in double precision
+            // even if the pre-calculated data are stored in single precision
+
+            Complex dat = _img[l].iGetFT(_iPxl[i]);
+
+            RFLOAT ctf = REAL(_ctf[l].iGetFT(_iPxl[i]));
+
+            RFLOAT sigRcp = _sigRcp(_groupID[l] - 1, _iSig[i]);
+
+            Complex datCross = CONJUGATE(dat) * (ctf * sigRcp);
+
+            _datCrossReP[idx] = REAL(datCross);
+
+            _datCrossImP[idx] = IMAG(datCross);
+
+            _ctf2SigRcpP[idx] = TSGSL_pow_2(ctf) * sigRcp;
+
+            norm += ABS2(dat) * sigRcp;
+        }
+
+        _datNormP[l] = norm;
+    }
+}
+
+void Optimiser::freePreCalGEMM()
+{
+    IF_MASTER return;
+
+    TSFFTW_free(_datCrossReP);
+    TSFFTW_free(_datCrossImP);
+    TSFFTW_free(_ctf2SigRcpP);
+    TSFFTW_free(_datNormP);
+}
+#endif
+
 void Optimiser::freePreCalIdx()
 {
     IF_MASTER return;
@@ -4637,13 +5472,16 @@ void Optimiser::freePreCalIdx()
     delete[] _iCol;
     delete[] _iRow;
     delete[] _iSig;
+
+    delete[] _shlEnd;
 }
 
 void Optimiser::freePreCal(const bool ctf)
 {
     IF_MASTER return;
 
-    TSFFTW_free(_datP);
+    TSFFTW_free(_datReP);
+    TSFFTW_free(_datImP);
     TSFFTW_free(_ctfP);
     TSFFTW_free(_sigRcpP);
 
@@ -4755,36 +5593,102 @@ void Optimiser::saveBestProjections()
     Image diff(_para.size, _para.size, FT_SPACE);
     char filename[FILE_NAME_LENGTH];
 
-    unsigned int cls;
-    mat22 rot2D;
-    mat33 rot3D;
-    vec2 tran;
-    RFLOAT d;
+    // the images to be saved, with the best pose of each
+
+    vector<int> iImg;
 
     FOR_EACH_2D_IMAGE
+        if (_ID[l] < N_SAVE_IMG) iImg.push_back(l);
+
+    int nImg = iImg.size();
+
+    if (nImg == 0) return;
+
+    unsigned int* cls = new unsigned int[nImg];
+    mat22* rot2D = new mat22[nImg];
+    mat33* rot3D = new mat33[nImg];
+    vec2* tran = new vec2[nImg];
+    RFLOAT d;
+
+    for (int m = 0; m < nImg; m++)
     {
-        if (_ID[l] < N_SAVE_IMG)
+        if (_para.mode == MODE_2D)
+            _par[iImg[m]].rank1st(cls[m], rot2D[m], tran[m], d);
+        else if (_para.mode == MODE_3D)
+            _par[iImg[m]].rank1st(cls[m], rot3D[m], tran[m], d);
+        else
+            REPORT_ERROR("INEXISTENT MODE");
+    }
+
+    // the images of a class are projected as a batch
+
+    for (int t = 0; t < _para.k; t++)
+    {
+        vector<int> iBatch;
+
+        for (int m = 0; m < nImg; m++)
+            if ((int)cls[m] == t) iBatch.push_back(m);
+
+        int nBatch = iBatch.size();
+
+        if (nBatch == 0) continue;
+
+        int maxRadius = _model.proj(t).maxRadius();
+
+        vector<int> iCol, iRow, iPxl;
+
+        IMAGE_FOR_PIXEL_R_FT(maxRadius)
+            if (QUAD(i, j) < TSGSL_pow_2(maxRadius))
+            {
+                iCol.push_back(i);
+                iRow.push_back(j);
+                iPxl.push_back(result.iFTHalf(i, j));
+            }
+
+        int nPxl = iCol.size();
+
+        Complex* priBatchP = new Complex[(size_t)nPxl * nBatch];
+
+        if (_para.mode == MODE_2D)
+        {
+            mat22* rot = new mat22[nBatch];
+
+            for (int m = 0; m < nBatch; m++)
+                rot[m] = rot2D[iBatch[m]];
+
+            _model.proj(t).projectBatchMT(priBatchP, rot, nBatch, &iCol[0], &iRow[0], nPxl);
+
+            delete[] rot;
+        }
+        else if (_para.mode == MODE_3D)
+        {
+            mat33* rot = new mat33[nBatch];
+
+            for (int m = 0; m < nBatch; m++)
+                rot[m] = rot3D[iBatch[m]];
+
+            _model.proj(t).projectBatchMT(priBatchP, rot, nBatch, &iCol[0], &iRow[0], nPxl);
+
+            delete[] rot;
+        }
+
+        for (int m = 0; m < nBatch; m++)
         {
+            int l = iImg[iBatch[m]];
+
             #pragma omp parallel for
             SET_0_FT(result);
 
             #pragma omp parallel for
             SET_0_FT(diff);
 
-            if (_para.mode == MODE_2D)
-            {
-                _par[l].rank1st(cls, rot2D, tran, d);
+            const Complex* priP = priBatchP + (size_t)nPxl * m;
 
-                _model.proj(cls).projectMT(result, rot2D, tran);
-            }
-            else if (_para.mode == MODE_3D)
-            {
-                _par[l].rank1st(cls, rot3D, tran, d);
+            #pragma omp parallel for
+            for (int i = 0; i < nPxl; i++)
+                result[iPxl[i]] = priP[i];
 
-                _model.proj(cls).projectMT(result, rot3D, tran);
-            }
-            else
-                REPORT_ERROR("INEXISTENT MODE");
+            translateMT(result, result, maxRadius, tran[iBatch[m]](0), tran[iBatch[m]](1));
 
             #pragma omp parallel for
             FOR_EACH_PIXEL_FT(diff)
@@ -4801,7 +5705,14 @@ void Optimiser::saveBestProjections()
             diff.saveRLToBMP(filename);
             fft.fw(diff);
         }
+
+        delete[] priBatchP;
     }
+
+    delete[] cls;
+    delete[] rot2D;
+    delete[] rot3D;
+    delete[] tran;
 }
 
 void Optimiser::saveImages()
@@ -5254,6 +6165,114 @@ RFLOAT logDataVSPrior(const Complex* dat,
     return result;
 }
 
+// the split real and imaginary part based scoring functions are shared by
+// double and single precision, in which each term is evaluated in the precision
+// of the arrays while the sum is always accumulated in RFLOAT
+
+template <typename F>
+static RFLOAT logDataVSPriorT(const F* datRe,
+                              const F* datIm,
+                              const F* priRe,
+                              const F* priIm,
+                              const F* ctf,
+                              const F* sigRcp,
+                              const int begin,
+                              const int end)
+{
+    RFLOAT result = 0;
+
+    #pragma omp simd reduction(+:result)
+    for (int i = begin; i < end; i++)
+    {
+        F re = datRe[i] - ctf[i] * priRe[i];
+        F im = datIm[i] - ctf[i] * priIm[i];
+
+        result += (re * re + im * im) * sigRcp[i];
+    }
+
+    return result;
+}
+
+RFLOAT logDataVSPrior(const RFLOAT* datRe,
+                      const RFLOAT* datIm,
+                      const RFLOAT* priRe,
+                      const RFLOAT* priIm,
+                      const RFLOAT* ctf,
+                      const RFLOAT* sigRcp,
+                      const int m)
+{
+    return logDataVSPriorT(datRe, datIm, priRe, priIm, ctf, sigRcp, 0, m);
+}
+
+RFLOAT logDataVSPrior(const float* datRe,
+                      const float* datIm,
+                      const float* priRe,
+                      const float* priIm,
+                      const float* ctf,
+                      const float* sigRcp,
+                      const int m)
+{
+    return logDataVSPriorT(datRe, datIm, priRe, priIm, ctf, sigRcp, 0, m);
+}
+
+template <typename F>
+static RFLOAT logDataVSPriorT(const F* datRe,
+                              const F* datIm,
+                              const F* priRe,
+                              const F* priIm,
+                              const F* ctf,
+                              const F* sigRcp,
+                              const int* shlEnd,
+                              const int nShl,
+                              const RFLOAT thres)
+{
+    RFLOAT result = 0;
+
+    for (int v = 0; v < nShl; v++)
+    {
+        result += logDataVSPriorT(datRe,
+                                  datIm,
+                                  priRe,
+                                  priIm,
+                                  ctf,
+                                  sigRcp,
+                                  (v == 0) ? 0 : shlEnd[v - 1],
+                                  shlEnd[v]);
+
+        // each term is non-positive, thus the result can only decrease
+
+        if (result < thres) break;
+    }
+
+    return result;
+}
+
+RFLOAT logDataVSPrior(const RFLOAT* datRe,
+                      const RFLOAT* datIm,
+                      const RFLOAT* priRe,
+                      const RFLOAT* priIm,
+                      const RFLOAT* ctf,
+                      const RFLOAT* sigRcp,
+                      const int* shlEnd,
+                      const int nShl,
+                      const RFLOAT thres)
+{
+    return logDataVSPriorT(datRe, datIm, priRe, priIm, ctf, sigRcp, shlEnd, nShl, thres);
+}
+
+RFLOAT logDataVSPrior(const float* datRe,
+                      const float* datIm,
+                      const float* priRe,
+                      const float* priIm,
+                      const float* ctf,
+                      const float* sigRcp,
+                      const int* shlEnd,
+                      const int nShl,
+                      const RFLOAT thres)
+{
+    return logDataVSPriorT(datRe, datIm, priRe, priIm, ctf, sigRcp, shlEnd, nShl, thres);
+}
+
 RFLOAT logDataVSPrior(const Complex* dat,
                       const Complex* pri,
                       const RFLOAT* frequency,
@@ -5473,6 +6492,325 @@ vec logDataVSPrior(const Complex* dat,
     return result;
 }
 
+template <typename F>
+static vec logDataVSPriorPixelMajorT(const F* datRe,
+                                     const F* datIm,
+                                     const F* priRe,
+                                     const F* priIm,
+                                     const F* ctf,
+                                     const F* sigRcp,
+                                     const int n,
+                                     const int m)
+{
+    vec result = vec::Zero(n);
+
+    RFLOAT* r = result.data();
+
+    // pixelMajor, the loop over images is contiguous
+
+    for (int i = 0; i < m; i++)
+    {
+        const F* dRe = datRe + (size_t)i * n;
+        const F* dIm = datIm + (size_t)i * n;
+        const F* c = ctf + (size_t)i * n;
+        const F* s = sigRcp + (size_t)i * n;
+
+        F pRe = priRe[i];
+        F pIm = priIm[i];
+
+        #pragma omp simd
+        for (int j = 0; j < n; j++)
+        {
+            F re = dRe[j] - c[j] * pRe;
+            F im = dIm[j] - c[j] * pIm;
+
+            r[j] += (re * re + im * im) * s[j];
+        }
+    }
+
+    return result;
+}
+
+vec logDataVSPrior(const RFLOAT* datRe,
+                   const RFLOAT* datIm,
+                   const RFLOAT* priRe,
+                   const RFLOAT* priIm,
+                   const RFLOAT* ctf,
+                   const RFLOAT* sigRcp,
+                   const int n,
+                   const int m)
+{
+    return logDataVSPriorPixelMajorT(datRe, datIm, priRe, priIm, ctf, sigRcp, n, m);
+}
+
+vec logDataVSPrior(const float* datRe,
+                   const float* datIm,
+                   const float* priRe,
+                   const float* priIm,
+                   const float* ctf,
+                   const float* sigRcp,
+                   const int n,
+                   const int m)
+{
+    return logDataVSPriorPixelMajorT(datRe, datIm, priRe, priIm, ctf, sigRcp, n, m);
+}
+
+template <typename F>
+static void logDataVSPriorT(vec& result,
+                            Image& cc,
+                            Complex* ccFT,
+                            FFT& fft,
+                            const F* datRe,
+                            const F* datIm,
+                            const F* priRe,
+                            const F* priIm,
+                            const F* ctf,
+                            const F* sigRcp,
+                            const int* iCol,
+                            const int* iRow,
+                            const mat2& tra,
+                            const int pf,
+                            const int m,
+                            const size_t stride)
+{
+    // |X - CPT|^2 = |X|^2 + C^2 * |P|^2 - 2 * Re(X * C * conj(P) * conj(T))
+    // conj(T) = exp(2 * pi * i * k * t / N), thus the sum of cross terms over
+    // k is an inverse Fourier transform evaluated at t
+
+    // the workspaces stay allocated through calls, and the half spectrum is
+    // only cleared
+
+    memset(ccFT, 0, (size_t)(cc.nColRL() / 2 + 1) * cc.nRowRL() * sizeof(Complex));
+
+    RFLOAT norm = 0;
+
+    for (int i = 0; i < m; i++)
+    {
+        size_t idx = i * stride;
+
+        Complex d = COMPLEX(datRe[idx], datIm[idx]);
+        Complex p = COMPLEX(priRe[i], priIm[i]);
+
+        norm += (ABS2(d) + TSGSL_pow_2(ctf[idx]) * ABS2(p))
+              * sigRcp[idx];
+
+        // except the column of zero frequency, each pixel will be counted
+        // twice by its conjugate in the inverse Fourier transform
+
+        ccFT[cc.iFTHalf(iCol[i], iRow[i])] = d
+                                            * CONJUGATE(p)
+                                            * ((RFLOAT)ctf[idx] * sigRcp[idx] * ((iCol[i] == 0) ? 1 : 0.5));
+    }
+
+    // make the column of zero frequency hermitian without changing the real
+    // part of the sum
+
+    for (int j = 1; j < cc.nRowRL() / 2; j++)
+    {
+        Complex& a = ccFT[cc.iFTHalf(0, j)];
+        Complex& b = ccFT[cc.iFTHalf(0, -j)];
+
+        Complex v = (a + CONJUGATE(b)) / 2;
+
+        a = v;
+        b = CONJUGATE(v);
+    }
+
+    ccFT[0] = COMPLEX(REAL(ccFT[0]), 0);
+
+    // the map is not normalised by the number of pixels
+
+    fft.bwExecutePlan(ccFT, &cc(0));
+
+    RFLOAT scale = 2;
+
+    RFLOAT w[2][2];
+    int x0[2];
+    RFLOAT x[2];
+
+    for (int n = 0; n < tra.rows(); n++)
+    {
+        x[0] = tra(n, 0) * pf;
+        x[1] = tra(n, 1) * pf;
+
+        WG_BI_INTERP_LINEAR(w, x0, x);
+
+        RFLOAT c = 0;
+
+        FOR_CELL_DIM_2 c += w[j][i] * cc.getRL(x0[0] + i, x0[1] + j);
+
+        result(n) = norm - scale * c;
+    }
+}
+
+void logDataVSPrior(vec& result,
+                    Image& cc,
+                    Complex* ccFT,
+                    FFT& fft,
+                    const RFLOAT* datRe,
+                    const RFLOAT* datIm,
+                    const RFLOAT* priRe,
+                    const RFLOAT* priIm,
+                    const RFLOAT* ctf,
+                    const RFLOAT* sigRcp,
+                    const int* iCol,
+                    const int* iRow,
+                    const mat2& tra,
+                    const int pf,
+                    const int m,
+                    const size_t stride)
+{
+    logDataVSPriorT(result, cc, ccFT, fft, datRe, datIm, priRe, priIm, ctf, sigRcp, iCol, iRow, tra, pf, m, stride);
+}
+
+void logDataVSPrior(vec& result,
+                    Image& cc,
+                    Complex* ccFT,
+                    FFT& fft,
+                    const float* datRe,
+                    const float* datIm,
+                    const float* priRe,
+                    const float* priIm,
+                    const float* ctf,
+                    const float* sigRcp,
+                    const int* iCol,
+                    const int* iRow,
+                    const mat2& tra,
+                    const int pf,
+                    const int m,
+                    const size_t stride)
+{
+    logDataVSPriorT(result, cc, ccFT, fft, datRe, datIm, priRe, priIm, ctf, sigRcp, iCol, iRow, tra, pf, m, stride);
+}
+
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+template <typename F>
+static void logDataVSPriorT(mat& result,
+                            const F* datCrossRe,
+                            const F* datCrossIm,
+                            const F* ctf2SigRcp,
+                            const RFLOAT* datNorm,
+                            const F* priRe,
+                            const F* priIm,
+                            const F* traRe,
+                            const F* traIm,
+                            F* workRe,
+                            F* workIm,
+                            const int nT,
+                            const int n,
+                            const int m)
+{
+    typedef Matrix<F, Dynamic, Dynamic> FMat;
+    typedef Matrix<F, Dynamic, 1> FVec;
+
+    // |X - CP|^2 = |X|^2 - 2 * Re(conj(X) * C * P) + C^2 * |P|^2
+    // as |T| = 1, the prior norm is independent of translation
+
+    FVec priNorm(m);
+
+    for (int i = 0; i < m; i++)
+        priNorm(i) = priRe[i] * priRe[i] + priIm[i] * priIm[i];
+
+    for (int t = 0; t < nT; t++)
+    {
+        const F* tRe = traRe + (size_t)t * m;
+        const F* tIm = traIm + (size_t)t * m;
+
+        F* wRe = workRe + (size_t)t * m;
+        F* wIm = workIm + (size_t)t * m;
+
+        #pragma omp simd
+        for (int i = 0; i < m; i++)
+        {
+            wRe[i] = tRe[i] * priRe[i] - tIm[i] * priIm[i];
+            wIm[i] = tRe[i] * priIm[i] + tIm[i] * priRe[i];
+        }
+    }
+
+    Map<const FMat> Ar(datCrossRe, n, m);
+    Map<const FMat> Ai(datCrossIm, n, m);
+    Map<const FMat> B(ctf2SigRcp, n, m);
+    Map<const vec> N(datNorm, n);
+
+    Map<const FMat> Qr(workRe, m, nT);
+    Map<const FMat> Qi(workIm, m, nT);
+
+    vec base = N + (B * priNorm).template cast<RFLOAT>();
+
+    // Re(A * Q) = Ar * Qr - Ai * Qi
+
+    FMat cross = Ar * Qr;
+
+    cross.noalias() -= Ai * Qi;
+
+    result = (-2 * cross).template cast<RFLOAT>();
+
+    result.colwise() += base;
+}
+
+void logDataVSPrior(mat& result,
+                    const RFLOAT* datCrossRe,
+                    const RFLOAT* datCrossIm,
+                    const RFLOAT* ctf2SigRcp,
+                    const RFLOAT* datNorm,
+                    const RFLOAT* priRe,
+                    const RFLOAT* priIm,
+                    const RFLOAT* traRe,
+                    const RFLOAT* traIm,
+                    RFLOAT* workRe,
+                    RFLOAT* workIm,
+                    const int nT,
+                    const int n,
+                    const int m)
+{
+    logDataVSPriorT(result,
+                    datCrossRe,
+                    datCrossIm,
+                    ctf2SigRcp,
+                    datNorm,
+                    priRe,
+                    priIm,
+                    traRe,
+                    traIm,
+                    workRe,
+                    workIm,
+                    nT,
+                    n,
+                    m);
+}
+
+void logDataVSPrior(mat& result,
+                    const float* datCrossRe,
+                    const float* datCrossIm,
+                    const float* ctf2SigRcp,
+                    const RFLOAT* datNorm,
+                    const float* priRe,
+                    const float* priIm,
+                    const float* traRe,
+                    const float* traIm,
+                    float* workRe,
+                    float* workIm,
+                    const int nT,
+                    const int n,
+                    const int m)
+{
+    logDataVSPriorT(result,
+                    datCrossRe,
+                    datCrossIm,
+                    ctf2SigRcp,
+                    datNorm,
+                    priRe,
+                    priIm,
+                    traRe,
+                    traIm,
+                    workRe,
+                    workIm,
+                    nT,
+                    n,
+                    m);
+}
+#endif
+
 RFLOAT dataVSPrior(const Image& dat,
                    const Image& pri,
                    const Image& ctf,
@@ -10,6 +10,7 @@
 
 #include "Parallel.h"
 
+#include <algorithm>
 #include <exception>
 
 Parallel::Parallel() {}
@@ -321,3 +322,70 @@ void MPI_Allreduce_Large(void* buf,
         ptr += MPI_MAX_BUF;
     }
 }
+
+void MPI_Iallreduce_Large(void* buf,
+                          size_t count,
+                          MPI_Datatype datatype,
+                          MPI_Op op,
+                          MPI_Comm comm,
+                          MPI_Request_Large& request,
+                          size_t chunk)
+{
+    int dataTypeSize;
+    MPI_Type_size(datatype, &dataTypeSize);
+
+    // the number of data in a chunk, which is no more than MPI_MAX_BUF bytes
+
+    size_t chunkCount = std::max(std::min(chunk, (size_t)MPI_MAX_BUF) / dataTypeSize,
+                                 (size_t)1);
+
+    size_t nChunk = (count + chunkCount - 1) / chunkCount;
+
+    request.request.resize(nChunk);
+
+    char* ptr = static_cast<char*>(buf);
+
+    for (size_t i = 0; i < nChunk; i++)
+    {
+        int chunkSize = (i != nChunk - 1)
+                      ? chunkCount
+                      : count - chunkCount * (nChunk - 1);
+
+        MPI_Iallreduce(MPI_IN_PLACE,
+                       ptr,
+                       chunkSize,
+                       datatype,
+                       op,
+                       comm,
+                       &request.request[i]);
+
+        ptr += chunkCount * dataTypeSize;
+    }
+}
+
+bool MPI_Test_Large(MPI_Request_Large& request)
+{
+    if (request.request.empty()) return true;
+
+    int flag;
+
+    MPI_Testall(request.request.size(),
+                &request.request[0],
+                &flag,
+                MPI_STATUSES_IGNORE);
+
+    if (flag) request.request.clear();
+
+    return flag;
+}
+
+void MPI_Wait_Large(MPI_Request_Large& request)
+{
+    if (request.request.empty()) return;
+
+    MPI_Waitall(request.request.size(),
+                &request.request[0],
+                MPI_STATUSES_IGNORE);
+
+    request.request.clear();
+}
@@ -0,0 +1,294 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependency:
+ * Test:
+ * Execution:
+ * Description:
+ *
+ * Manual:
+ * ****************************************************************************/
+
+#include <cstring>
+
+#include "ProjectionCache.h"
+
+ProjectionCache::ProjectionCache()
+{
+    _nPxl = 0;
+    _step = 1;
+    _antipodal = true;
+    _nShard = 0;
+    _nSlot = 0;
+
+    _re = NULL;
+    _im = NULL;
+}
+
+ProjectionCache::ProjectionCache(const RFLOAT size,
+                                 const int nPxl,
+                                 const RFLOAT step,
+                                 const bool antipodal)
+{
+    _re = NULL;
+    _im = NULL;
+
+    init(size, nPxl, step, antipodal);
+}
+
+ProjectionCache::~ProjectionCache()
+{
+    clear();
+}
+
+void ProjectionCache::clear()
+{
+    for (size_t i = 0; i < _shard.size(); i++)
+        omp_destroy_lock(&_shard[i].lock);
+
+    _shard.clear();
+
+    _nShard = 0;
+    _nSlot = 0;
+
+    delete[] _re;
+    delete[] _im;
+
+    _re = NULL;
+    _im = NULL;
+}
+
+void ProjectionCache::init(const RFLOAT size,
+                           const int nPxl,
+                           const RFLOAT step,
+                           const bool antipodal)
+{
+    clear();
+
+    _nPxl = nPxl;
+    _step = step;
+    _antipodal = antipodal;
+
+    size_t nByte = 2 * (size_t)nPxl * sizeof(EFLOAT);
+
+    // the number of shards is clamped to the number of projections fitting in
+    // the memory, thus the slots of all shards fit in it as well
+
+    int nProj = GSL_MAX_INT(1, (int)(size * 1024 * 1024 / nByte));
+
+    _nShard = GSL_MIN_INT(PROJECTION_CACHE_N_SHARD, nProj);
+
+    _nSlot = nProj / _nShard;
+
+    _shard.resize(_nShard);
+
+    for (int i = 0; i < _nShard; i++)
+    {
+        Shard& s = _shard[i];
+
+        omp_init_lock(&s.lock);
+
+        s.key.resize(_nSlot);
+        s.valid.assign(_nSlot, false);
+        s.ref.assign(_nSlot, false);
+
+        s.hand = 0;
+
+        s.nHit = 0;
+        s.nMiss = 0;
+    }
+
+    _re = new EFLOAT[(size_t)_nShard * _nSlot * _nPxl];
+    _im = new EFLOAT[(size_t)_nShard * _nSlot * _nPxl];
+}
+
+void ProjectionCache::key(ProjectionCacheKey& dst,
+                          const unsigned int cls,
+                          const vec4& quat) const
+{
+    // q and -q are the same rotation in 3D, the one with the first non-zero
+    // component being positive is taken
+
+    RFLOAT sign = 1;
+
+    if (_antipodal)
+        for (int i = 0; i < 4; i++)
+            if (quat(i) != 0)
+            {
+                sign = (quat(i) > 0) ? 1 : -1;
+
+                break;
+            }
+
+    dst.cls = cls;
+
+    for (int i = 0; i < 4; i++)
+        dst.q[i] = AROUND(sign * quat(i) / _step);
+}
+
+int ProjectionCache::shard(const ProjectionCacheKey& key) const
+{
+    size_t h = key.cls;
+
+    for (int i = 0; i < 4; i++)
+        h = h * 1000003 + (unsigned int)key.q[i];
+
+    return h % _nShard;
+}
+
+void ProjectionCache::quantise(vec4& dst,
+                               const vec4& quat) const
+{
+    ProjectionCacheKey k;
+
+    key(k, 0, quat);
+
+    for (int i = 0; i < 4; i++)
+        dst(i) = k.q[i] * _step;
+
+    // a quaternion shorter than half a step falls into the bin of zero, of
+    // which the identity is taken as the centre
+
+    RFLOAT norm = dst.norm();
+
+    if (norm == 0)
+        dst = vec4(1, 0, 0, 0);
+    else
+        dst /= norm;
+}
+
+bool ProjectionCache::get(EFLOAT* dstRe,
+                          EFLOAT* dstIm,
+                          const unsigned int cls,
+                          const vec4& quat)
+{
+    if (_nShard == 0)
+    {
+        REPORT_ERROR("PROJECTION CACHE NOT INITIALISED");
+
+        abort();
+    }
+
+    ProjectionCacheKey k;
+
+    key(k, cls, quat);
+
+    int iShard = shard(k);
+
+    Shard& s = _shard[iShard];
+
+    omp_set_lock(&s.lock);
+
+    std::map<ProjectionCacheKey, int>::const_iterator it = s.index.find(k);
+
+    bool hit = (it != s.index.end());
+
+    if (hit)
+    {
+        int iSlot = it->second;
+
+        s.ref[iSlot] = true;
+
+        size_t offset = ((size_t)iShard * _nSlot + iSlot) * _nPxl;
+
+        memcpy(dstRe, _re + offset, _nPxl * sizeof(EFLOAT));
+        memcpy(dstIm, _im + offset, _nPxl * sizeof(EFLOAT));
+
+        s.nHit++;
+    }
+    else
+        s.nMiss++;
+
+    omp_unset_lock(&s.lock);
+
+    return hit;
+}
+
+void ProjectionCache::put(const EFLOAT* srcRe,
+                          const EFLOAT* srcIm,
+                          const unsigned int cls,
+                          const vec4& quat)
+{
+    if (_nShard == 0)
+    {
+        REPORT_ERROR("PROJECTION CACHE NOT INITIALISED");
+
+        abort();
+    }
+
+    ProjectionCacheKey k;
+
+    key(k, cls, quat);
+
+    int iShard = shard(k);
+
+    Shard& s = _shard[iShard];
+
+    omp_set_lock(&s.lock);
+
+    // another thread may have stored it after the look-up of this thread
+
+    if (s.index.find(k) == s.index.end())
+    {
+        // clock eviction, a referenced slot is given a second chance
+
+        int iSlot;
+
+        while (true)
+        {
+            iSlot = s.hand;
+
+            s.hand = (s.hand + 1) % _nSlot;
+
+            if (!s.valid[iSlot]) break;
+
+            if (s.ref[iSlot])
+                s.ref[iSlot] = false;
+            else
+            {
+                s.index.erase(s.key[iSlot]);
+
+                break;
+            }
+        }
+
+        size_t offset = ((size_t)iShard * _nSlot + iSlot) * _nPxl;
+
+        memcpy(_re + offset, srcRe, _nPxl * sizeof(EFLOAT));
+        memcpy(_im + offset, srcIm, _nPxl * sizeof(EFLOAT));
+
+        s.key[iSlot] = k;
+        s.valid[iSlot] = true;
+        s.ref[iSlot] = true;
+
+        s.index[k] = iSlot;
+    }
+
+    omp_unset_lock(&s.lock);
+}
+
+size_t ProjectionCache::nHit() const
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _shard.size(); i++)
+        n += _shard[i].nHit;
+
+    return n;
+}
+
+size_t ProjectionCache::nMiss() const
+{
+    size_t n = 0;
+
+    for (size_t i = 0; i < _shard.size(); i++)
+        n += _shard[i].nMiss;
+
+    return n;
+}
+
+int ProjectionCache::capacity() const
+{
+    return _nSlot * _nShard;
+}
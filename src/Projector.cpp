@@ -12,6 +12,8 @@
 
 #include "Projector.h"
 
+#include <algorithm>
+
 Projector::Projector()
 {
     _mode = MODE_3D;
@@ -21,9 +23,29 @@ Projector::Projector()
     _interp = LINEAR_INTERP;
 
     _pf = 2;
+
+    _node = MPI_COMM_NULL;
+
+    _win = MPI_WIN_NULL;
+
+#ifdef PROJECTOR_BRICK
+    _brick = true;
+#else
+    _brick = false;
+#endif
 }
 
-Projector::~Projector() {}
+Projector::~Projector()
+{
+    // the memory shared on the node is freed with the other processes, unless
+    // MPI is finalised already
+
+    int finalized;
+
+    MPI_Finalized(&finalized);
+
+    if (!finalized) freeShared();
+}
 
 void Projector::swap(Projector& that)
 {
@@ -31,7 +53,10 @@ void Projector::swap(Projector& that)
     std::swap(_maxRadius, that._maxRadius);
     std::swap(_interp, that._interp);
     std::swap(_pf, that._pf);
-    
+    std::swap(_node, that._node);
+    std::swap(_win, that._win);
+    std::swap(_brick, that._brick);
+
     _projectee2D.swap(that._projectee2D);
     _projectee3D.swap(that._projectee3D);
 }
@@ -86,12 +111,27 @@ void Projector::setPf(const int pf)
     _pf = pf;
 }
 
+bool Projector::brick() const
+{
+    return _brick;
+}
+
+void Projector::setBrick(const bool brick)
+{
+    _brick = brick;
+}
+
+void Projector::setNode(MPI_Comm node)
+{
+    _node = node;
+}
+
 const Image& Projector::projectee2D() const
 {
     return _projectee2D;
 }
 
-const Volume& Projector::projectee3D() const
+const SphereVolume& Projector::projectee3D() const
 {
     return _projectee3D;
 }
@@ -114,7 +154,7 @@ void Projector::setProjectee(Image src)
 
 #ifdef PROJECTOR_CORRECT_CONVOLUTION_KERNEL
 
-    gridCorrection();
+    gridCorrection(_projectee2D);
 
 #endif
 
@@ -124,16 +164,45 @@ void Projector::setProjectee(Image src)
 
 void Projector::setProjectee(Volume src)
 {
+    if (_node == MPI_COMM_NULL)
+    {
+        buildProjectee(boost::move(src));
+
+        return;
+    }
+
+    // the projectee shared on the node is built by the process of rank 0
+
+    int nodeRank;
+
+    MPI_Comm_rank(_node, &nodeRank);
+
+    if (nodeRank == 0) buildProjectee(boost::move(src));
+
+    shareProjectee(0);
+}
+
+void Projector::buildProjectee(Volume src)
+{
+    // a projectee in the memory shared on the node is only detached here, as
+    // freeing it is collective in the node
+
+    _projectee3D.clear();
+
+    int padSize = _pf * MIN_3(src.nColRL(),
+                              src.nRowRL(),
+                              src.nSlcRL());
+
+    _maxRadius = floor(padSize / _pf / 2 - 1);
+
     FFT fft;
     fft.bwMT(src);
 
-    VOL_PAD_RL(_projectee3D, src, _pf);
+    Volume padSrc;
 
-    if (_projectee3D.isEmptyRL()) REPORT_ERROR("RL SPACE EMPTY");
+    VOL_PAD_RL(padSrc, src, _pf);
 
-    _maxRadius = floor(MIN_3(_projectee3D.nColRL(),
-                             _projectee3D.nRowRL(),
-                             _projectee3D.nSlcRL()) / _pf / 2 - 1);
+    if (padSrc.isEmptyRL()) REPORT_ERROR("RL SPACE EMPTY");
 
 #ifdef VERBOSE_LEVEL_3
     CLOG(INFO, "LOGGER_SYS") << "Performing Grid Correction";
@@ -141,12 +210,406 @@ void Projector::setProjectee(Volume src)
 
 #ifdef PROJECTOR_CORRECT_CONVOLUTION_KERNEL
 
-    gridCorrection();
+    gridCorrection(padSrc);
 
 #endif
 
-    fft.fwMT(_projectee3D);
-    _projectee3D.clearRL();
+    fft.fwMT(padSrc);
+    padSrc.clearRL();
+
+    // only the sphere inscribed in the padded cube is kept, which covers the
+    // max radius and the cell of interpolation
+
+    _projectee3D.fromVolume(padSrc, padSize / 2, _brick);
+}
+
+void Projector::shareProjectee(const int root)
+{
+    int nodeRank;
+
+    MPI_Comm_rank(_node, &nodeRank);
+
+    int shape[6];
+
+    bcastShape(shape, root, _node);
+
+    // the projectee built by the root is moved out of the way, and the
+    // memory shared before is freed
+
+    SphereVolume built;
+
+    if (nodeRank == root)
+        built.swap(_projectee3D);
+    else
+        _projectee3D.clear();
+
+    if (_win != MPI_WIN_NULL) MPI_Win_free(&_win);
+
+    SphereIndex index;
+
+    index.alloc(shape[0], shape[1], shape[2], shape[3], shape[5]);
+
+    // the root allocates the memory, and the others query it after it is
+    // filled
+
+    Complex* base;
+
+    MPI_Win_allocate_shared((nodeRank == root) ? index.size() * sizeof(Complex) : 0,
+                            sizeof(Complex),
+                            MPI_INFO_NULL,
+                            _node,
+                            &base,
+                            &_win);
+
+    if (nodeRank != root)
+    {
+        MPI_Aint size;
+        int dispUnit;
+
+        MPI_Win_shared_query(_win, root, &size, &dispUnit, &base);
+    }
+
+    _projectee3D.attach(base, shape[0], shape[1], shape[2], shape[3], shape[5]);
+
+    if (nodeRank == root)
+        memcpy(&_projectee3D[0], &built[0], built.sizeFT() * sizeof(Complex));
+
+    MPI_Barrier(_node);
+}
+
+void Projector::bcastProjectee(const int root,
+                               MPI_Comm comm)
+{
+    int rank;
+
+    MPI_Comm_rank(comm, &rank);
+
+    int shape[6];
+
+    bcastShape(shape, root, comm);
+
+    if (rank != root)
+        _projectee3D.alloc(shape[0], shape[1], shape[2], shape[3], shape[5]);
+
+    MPI_Bcast_Large(&_projectee3D[0],
+                    _projectee3D.sizeFT(),
+                    MPI_DOUBLE_COMPLEX,
+                    root,
+                    comm);
+}
+
+void Projector::bcastShape(int* shape,
+                           const int root,
+                           MPI_Comm comm)
+{
+    shape[0] = _projectee3D.nColRL();
+    shape[1] = _projectee3D.nRowRL();
+    shape[2] = _projectee3D.nSlcRL();
+    shape[3] = _projectee3D.radius();
+    shape[4] = _maxRadius;
+    shape[5] = _projectee3D.brick();
+
+    MPI_Bcast(shape, 6, MPI_INT, root, comm);
+
+    _maxRadius = shape[4];
+}
+
+void Projector::freeShared()
+{
+    if (_win == MPI_WIN_NULL) return;
+
+    _projectee3D.clear();
+
+    MPI_Win_free(&_win);
+}
+
+static inline void setProjection(Complex& dst,
+                                 const Complex value)
+{
+    dst = value;
+}
+
+static inline void setProjection(ComplexF& dst,
+                                 const Complex value)
+{
+    dst = complexF(value);
+}
+
+template <typename T>
+void Projector::projectKernel(T* dst,
+                              const mat22& mat,
+                              const int* iCol,
+                              const int* iRow,
+                              const int* iPxl,
+                              const int nPxl,
+                              const bool mt) const
+{
+    RFLOAT c[2][2];
+
+    for (int d = 0; d < 2; d++)
+    {
+        c[0][d] = mat(d, 0) * _pf;
+        c[1][d] = mat(d, 1) * _pf;
+    }
+
+    bool linear = (_interp == LINEAR_INTERP);
+
+    const Complex* data = &_projectee2D.iGetFT();
+
+    int nColFT = _projectee2D.nColRL() / 2 + 1;
+    int nRow = _projectee2D.nRowRL();
+
+    #pragma omp parallel for schedule(dynamic) if(mt)
+    for (int b = 0; b < nPxl; b += PROJECTOR_KERNEL_BLOCK)
+    {
+        int n = GSL_MIN_INT(PROJECTOR_KERNEL_BLOCK, nPxl - b);
+
+        RFLOAT sign[PROJECTOR_KERNEL_BLOCK];
+        RFLOAT x[2][PROJECTOR_KERNEL_BLOCK];
+        RFLOAT xd[2][PROJECTOR_KERNEL_BLOCK];
+        int x0[2][PROJECTOR_KERNEL_BLOCK];
+
+        #pragma omp simd
+        for (int p = 0; p < n; p++)
+        {
+            RFLOAT u = iCol[b + p];
+            RFLOAT v = iRow[b + p];
+
+            RFLOAT cx = u * c[0][0] + v * c[1][0];
+            RFLOAT cy = u * c[0][1] + v * c[1][1];
+
+            // a pixel in the other half is taken from the conjugate
+
+            sign[p] = (cx < 0) ? -1 : 1;
+
+            x[0][p] = cx * sign[p];
+            x[1][p] = cy * sign[p];
+
+            for (int d = 0; d < 2; d++)
+            {
+                x0[d][p] = floor(x[d][p]);
+                xd[d][p] = x[d][p] - x0[d][p];
+            }
+        }
+
+        for (int p = 0; p < n; p++)
+        {
+            Complex result = COMPLEX(0, 0);
+
+            if (linear)
+            {
+                RFLOAT v0[2] = {1 - xd[0][p], xd[0][p]};
+                RFLOAT v1[2] = {1 - xd[1][p], xd[1][p]};
+
+                for (int j = 0; j < 2; j++)
+                {
+                    int y = x0[1][p] + j;
+
+                    const Complex* row = data + (size_t)(y >= 0 ? y : y + nRow) * nColFT;
+
+                    for (int i = 0; i < 2; i++)
+                        result += row[x0[0][p] + i] * (v0[i] * v1[j]);
+                }
+            }
+            else
+                result = _projectee2D.getByInterpolationFT(x[0][p], x[1][p], _interp);
+
+            result.dat[1] *= sign[p];
+
+            setProjection(dst[iPxl ? iPxl[b + p] : b + p], result);
+        }
+    }
+}
+
+template <typename T>
+void Projector::projectKernel(T* dst,
+                              const mat33& mat,
+                              const int* iCol,
+                              const int* iRow,
+                              const int* iPxl,
+                              const int nPxl,
+                              const bool mt) const
+{
+    RFLOAT c[2][3];
+
+    for (int d = 0; d < 3; d++)
+    {
+        c[0][d] = mat(d, 0) * _pf;
+        c[1][d] = mat(d, 1) * _pf;
+    }
+
+    // a projectee in bricks is read through its own interpolation
+
+    bool linear = (_interp == LINEAR_INTERP) && !_projectee3D.brick();
+
+    const Complex* data = &_projectee3D[0];
+
+    const SphereIndex& index = _projectee3D.index();
+
+    #pragma omp parallel for schedule(dynamic) if(mt)
+    for (int b = 0; b < nPxl; b += PROJECTOR_KERNEL_BLOCK)
+    {
+        int n = GSL_MIN_INT(PROJECTOR_KERNEL_BLOCK, nPxl - b);
+
+        RFLOAT sign[PROJECTOR_KERNEL_BLOCK];
+        RFLOAT x[3][PROJECTOR_KERNEL_BLOCK];
+        RFLOAT xd[3][PROJECTOR_KERNEL_BLOCK];
+        int x0[3][PROJECTOR_KERNEL_BLOCK];
+
+        #pragma omp simd
+        for (int p = 0; p < n; p++)
+        {
+            RFLOAT u = iCol[b + p];
+            RFLOAT v = iRow[b + p];
+
+            RFLOAT cx = u * c[0][0] + v * c[1][0];
+            RFLOAT cy = u * c[0][1] + v * c[1][1];
+            RFLOAT cz = u * c[0][2] + v * c[1][2];
+
+            // a voxel in the other half is taken from the conjugate
+
+            sign[p] = (cx < 0) ? -1 : 1;
+
+            x[0][p] = cx * sign[p];
+            x[1][p] = cy * sign[p];
+            x[2][p] = cz * sign[p];
+
+            for (int d = 0; d < 3; d++)
+            {
+                x0[d][p] = floor(x[d][p]);
+                xd[d][p] = x[d][p] - x0[d][p];
+            }
+        }
+
+        for (int p = 0; p < n; p++)
+        {
+            Complex result = COMPLEX(0, 0);
+
+            if (linear)
+            {
+                RFLOAT v0[2] = {1 - xd[0][p], xd[0][p]};
+                RFLOAT v1[2] = {1 - xd[1][p], xd[1][p]};
+                RFLOAT v2[2] = {1 - xd[2][p], xd[2][p]};
+
+                // the two voxels of a cell in the same row are adjacent in
+                // the storage
+
+                for (int k = 0; k < 2; k++)
+                    for (int j = 0; j < 2; j++)
+                    {
+                        size_t row = index.iRowFT(x0[1][p] + j, x0[2][p] + k);
+
+                        int len = index.len(row);
+
+                        const Complex* cell = data + index.offset(row);
+
+                        for (int i = 0; i < 2; i++)
+                            if (x0[0][p] + i < len)
+                                result += cell[x0[0][p] + i] * (v0[i] * v1[j] * v2[k]);
+                    }
+            }
+            else
+                result = _projectee3D.getByInterpolationFT(x[0][p], x[1][p], x[2][p], _interp);
+
+            result.dat[1] *= sign[p];
+
+            setProjection(dst[iPxl ? iPxl[b + p] : b + p], result);
+        }
+    }
+}
+
+/**
+ * This function gives the index of a point of [-1, 1] x [-1, 1] along the
+ * Hilbert curve filling the grid of 2^PROJECTOR_HILBERT_ORDER cells per
+ * dimension.
+ */
+static unsigned int hilbertIndex(const RFLOAT u,
+                                 const RFLOAT v)
+{
+    unsigned int n = 1U << PROJECTOR_HILBERT_ORDER;
+
+    unsigned int x = GSL_MIN_INT(n - 1, (int)((u + 1) / 2 * n));
+    unsigned int y = GSL_MIN_INT(n - 1, (int)((v + 1) / 2 * n));
+
+    unsigned int d = 0;
+
+    for (unsigned int s = n / 2; s > 0; s /= 2)
+    {
+        unsigned int rx = (x & s) ? 1 : 0;
+        unsigned int ry = (y & s) ? 1 : 0;
+
+        d += s * s * ((3 * rx) ^ ry);
+
+        // rotate the quadrant, so that the curve is continuous
+
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+
+            std::swap(x, y);
+        }
+    }
+
+    return d;
+}
+
+/**
+ * In 2D, every rotation reads the whole projectee. The slices are ordered by
+ * their angles, up to the Friedel symmetry.
+ */
+static unsigned int hilbertIndex(const mat22& rot)
+{
+    RFLOAT phi = atan2(rot(1, 0), rot(0, 0));
+
+    if (phi < 0) phi += M_PI;
+
+    return (unsigned int)(phi / M_PI * ((1U << (2 * PROJECTOR_HILBERT_ORDER)) - 1));
+}
+
+/**
+ * In 3D, the slice of a rotation is the plane normal to its third column. The
+ * normal is brought to the upper hemisphere, as the opposite one gives the
+ * same plane, and mapped to the plane by the Lambert azimuthal equal-area
+ * projection, where the Hilbert curve keeps close slices close.
+ */
+static unsigned int hilbertIndex(const mat33& rot)
+{
+    vec3 n = rot.col(2);
+
+    if (n(2) < 0) n = -n;
+
+    RFLOAT k = sqrt(1 / (1 + n(2)));
+
+    return hilbertIndex(k * n(0), k * n(1));
+}
+
+template <typename T, typename M>
+void Projector::projectBatchKernel(T* dst,
+                                   const M* rot,
+                                   const int nRot,
+                                   const int* iCol,
+                                   const int* iRow,
+                                   const int nPxl,
+                                   const bool mt) const
+{
+    vector<std::pair<unsigned int, int> > order(nRot);
+
+    for (int m = 0; m < nRot; m++)
+        order[m] = std::make_pair(hilbertIndex(rot[m]), m);
+
+    std::sort(order.begin(), order.end());
+
+    #pragma omp parallel for schedule(static) if(mt)
+    for (int m = 0; m < nRot; m++)
+    {
+        int r = order[m].second;
+
+        projectKernel(dst + (size_t)nPxl * r, rot[r], iCol, iRow, NULL, nPxl, false);
+    }
 }
 
 void Projector::project(Image& dst,
@@ -191,15 +654,7 @@ void Projector::project(Image& dst,
                         const int* iPxl,
                         const int nPxl) const
 {
-    for (int i = 0; i < nPxl; i++)
-    {
-        vec2 newCor((RFLOAT)(iCol[i] * _pf), (RFLOAT)(iRow[i] * _pf));
-        vec2 oldCor = mat * newCor;
-
-        dst[iPxl[i]] = _projectee2D.getByInterpolationFT(oldCor(0),
-                                                         oldCor(1),
-                                                         _interp);
-    }
+    projectKernel(&dst[0], mat, iCol, iRow, iPxl, nPxl, false);
 }
 
 void Projector::project(Image& dst,
@@ -209,16 +664,7 @@ void Projector::project(Image& dst,
                         const int* iPxl,
                         const int nPxl) const
 {
-    for (int i = 0; i < nPxl; i++)
-    {
-        vec3 newCor((RFLOAT)(iCol[i] * _pf), (RFLOAT)(iRow[i] * _pf), 0);
-        vec3 oldCor = mat * newCor;
-
-        dst[iPxl[i]] = _projectee3D.getByInterpolationFT(oldCor(0),
-                                                         oldCor(1),
-                                                         oldCor(2),
-                                                         _interp);
-    }
+    projectKernel(&dst[0], mat, iCol, iRow, iPxl, nPxl, false);
 }
 
 void Projector::project(Complex* dst,
@@ -227,15 +673,7 @@ void Projector::project(Complex* dst,
                         const int* iRow,
                         const int nPxl) const
 {
-    for (int i = 0; i < nPxl; i++)
-    {
-        vec2 newCor((RFLOAT)(iCol[i] * _pf), (RFLOAT)(iRow[i] * _pf));
-        vec2 oldCor = mat * newCor;
-
-        dst[i] = _projectee2D.getByInterpolationFT(oldCor(0),
-                                                   oldCor(1),
-                                                   _interp);
-    }
+    projectKernel(dst, mat, iCol, iRow, NULL, nPxl, false);
 }
 
 void Projector::project(Complex* dst,
@@ -244,16 +682,25 @@ void Projector::project(Complex* dst,
                         const int* iRow,
                         const int nPxl) const
 {
-    for (int i = 0; i < nPxl; i++)
-    {
-        vec3 newCor((RFLOAT)(iCol[i] * _pf), (RFLOAT)(iRow[i] * _pf), 0);
-        vec3 oldCor = mat * newCor;
+    projectKernel(dst, mat, iCol, iRow, NULL, nPxl, false);
+}
 
-        dst[i] = _projectee3D.getByInterpolationFT(oldCor(0),
-                                                   oldCor(1),
-                                                   oldCor(2),
-                                                   _interp);
-    }
+void Projector::project(ComplexF* dst,
+                        const mat22& mat,
+                        const int* iCol,
+                        const int* iRow,
+                        const int nPxl) const
+{
+    projectKernel(dst, mat, iCol, iRow, NULL, nPxl, false);
+}
+
+void Projector::project(ComplexF* dst,
+                        const mat33& mat,
+                        const int* iCol,
+                        const int* iRow,
+                        const int nPxl) const
+{
+    projectKernel(dst, mat, iCol, iRow, NULL, nPxl, false);
 }
 
 void Projector::projectMT(Image& dst,
@@ -300,16 +747,7 @@ void Projector::projectMT(Image& dst,
                           const int* iPxl,
                           const int nPxl) const
 {
-    #pragma omp parallel for
-    for (int i = 0; i < nPxl; i++)
-    {
-        vec2 newCor((RFLOAT)(iCol[i] * _pf), (RFLOAT)(iRow[i] * _pf));
-        vec2 oldCor = mat * newCor;
-
-        dst[iPxl[i]] = _projectee2D.getByInterpolationFT(oldCor(0),
-                                                         oldCor(1),
-                                                         _interp);
-    }
+    projectKernel(&dst[0], mat, iCol, iRow, iPxl, nPxl, true);
 }
 
 void Projector::projectMT(Image& dst,
@@ -319,17 +757,7 @@ void Projector::projectMT(Image& dst,
                           const int* iPxl,
                           const int nPxl) const
 {
-    #pragma omp parallel for
-    for (int i = 0; i < nPxl; i++)
-    {
-        vec3 newCor((RFLOAT)(iCol[i] * _pf), (RFLOAT)(iRow[i] * _pf), 0);
-        vec3 oldCor = mat * newCor;
-
-        dst[iPxl[i]] = _projectee3D.getByInterpolationFT(oldCor(0),
-                                                         oldCor(1),
-                                                         oldCor(2),
-                                                         _interp);
-    }
+    projectKernel(&dst[0], mat, iCol, iRow, iPxl, nPxl, true);
 }
 
 void Projector::projectMT(Complex* dst,
@@ -338,16 +766,7 @@ void Projector::projectMT(Complex* dst,
                           const int* iRow,
                           const int nPxl) const
 {
-    #pragma omp parallel for
-    for (int i = 0; i < nPxl; i++)
-    {
-        vec2 newCor((RFLOAT)(iCol[i] * _pf), (RFLOAT)(iRow[i] * _pf));
-        vec2 oldCor = mat * newCor;
-
-        dst[i] = _projectee2D.getByInterpolationFT(oldCor(0),
-                                                   oldCor(1),
-                                                   _interp);
-    }
+    projectKernel(dst, mat, iCol, iRow, NULL, nPxl, true);
 }
 
 void Projector::projectMT(Complex* dst,
@@ -356,17 +775,67 @@ void Projector::projectMT(Complex* dst,
                           const int* iRow,
                           const int nPxl) const
 {
-    #pragma omp parallel for
-    for (int i = 0; i < nPxl; i++)
-    {
-        vec3 newCor((RFLOAT)(iCol[i] * _pf), (RFLOAT)(iRow[i] * _pf), 0);
-        vec3 oldCor = mat * newCor;
+    projectKernel(dst, mat, iCol, iRow, NULL, nPxl, true);
+}
 
-        dst[i] = _projectee3D.getByInterpolationFT(oldCor(0),
-                                                   oldCor(1),
-                                                   oldCor(2),
-                                                   _interp);
-    }
+void Projector::projectBatch(Complex* dst,
+                             const mat22* rot,
+                             const int nRot,
+                             const int* iCol,
+                             const int* iRow,
+                             const int nPxl) const
+{
+    projectBatchKernel(dst, rot, nRot, iCol, iRow, nPxl, false);
+}
+
+void Projector::projectBatch(Complex* dst,
+                             const mat33* rot,
+                             const int nRot,
+                             const int* iCol,
+                             const int* iRow,
+                             const int nPxl) const
+{
+    projectBatchKernel(dst, rot, nRot, iCol, iRow, nPxl, false);
+}
+
+void Projector::projectBatch(ComplexF* dst,
+                             const mat22* rot,
+                             const int nRot,
+                             const int* iCol,
+                             const int* iRow,
+                             const int nPxl) const
+{
+    projectBatchKernel(dst, rot, nRot, iCol, iRow, nPxl, false);
+}
+
+void Projector::projectBatch(ComplexF* dst,
+                             const mat33* rot,
+                             const int nRot,
+                             const int* iCol,
+                             const int* iRow,
+                             const int nPxl) const
+{
+    projectBatchKernel(dst, rot, nRot, iCol, iRow, nPxl, false);
+}
+
+void Projector::projectBatchMT(Complex* dst,
+                               const mat22* rot,
+                               const int nRot,
+                               const int* iCol,
+                               const int* iRow,
+                               const int nPxl) const
+{
+    projectBatchKernel(dst, rot, nRot, iCol, iRow, nPxl, true);
+}
+
+void Projector::projectBatchMT(Complex* dst,
+                               const mat33* rot,
+                               const int nRot,
+                               const int* iCol,
+                               const int* iRow,
+                               const int nPxl) const
+{
+    projectBatchKernel(dst, rot, nRot, iCol, iRow, nPxl, true);
 }
 
 void Projector::project(Image& dst,
@@ -511,86 +980,78 @@ void Projector::projectMT(Complex* dst,
     translateMT(dst, dst, t(0), t(1), nCol, nRow, iCol, iRow, nPxl);
 }
 
-void Projector::gridCorrection()
+void Projector::gridCorrection(Image& projectee) const
 {
-        if (_mode == MODE_2D)
-        {
 #ifdef VERBOSE_LEVEL_3
-            CLOG(INFO, "LOGGER_SYS") << "Inverse Fourier Transform in Grid Correction";
+    CLOG(INFO, "LOGGER_SYS") << "Inverse Fourier Transform in Grid Correction";
 #endif
 
 #ifdef PROJECTOR_REMOVE_NEG
-            #pragma omp parallel for
-            REMOVE_NEG(_projectee2D);
+    #pragma omp parallel for
+    REMOVE_NEG(projectee);
 #endif
 
-        if (_interp == LINEAR_INTERP)
-        {
-            #pragma omp parallel for schedule(dynamic)
-            IMAGE_FOR_EACH_PIXEL_RL(_projectee2D)
-                _projectee2D.setRL(_projectee2D.getRL(i, j)
-                                 / TIK_RL(NORM(i, j)
-                                        / _projectee2D.nColRL()),
-                                   i,
-                                   j);
-        }
-        else if (_interp == NEAREST_INTERP)
-        {
-            #pragma omp parallel for schedule(dynamic)
-            IMAGE_FOR_EACH_PIXEL_RL(_projectee2D)
-                _projectee2D.setRL(_projectee2D.getRL(i, j)
-                                 / NIK_RL(NORM(i, j)
-                                        / _projectee2D.nColRL()),
-                                   i,
-                                   j);
-        }
+    if (_interp == LINEAR_INTERP)
+    {
+        #pragma omp parallel for schedule(dynamic)
+        IMAGE_FOR_EACH_PIXEL_RL(projectee)
+            projectee.setRL(projectee.getRL(i, j)
+                          / TIK_RL(NORM(i, j)
+                                 / projectee.nColRL()),
+                            i,
+                            j);
+    }
+    else if (_interp == NEAREST_INTERP)
+    {
+        #pragma omp parallel for schedule(dynamic)
+        IMAGE_FOR_EACH_PIXEL_RL(projectee)
+            projectee.setRL(projectee.getRL(i, j)
+                          / NIK_RL(NORM(i, j)
+                                 / projectee.nColRL()),
+                            i,
+                            j);
+    }
 
 #ifdef VERBOSE_LEVEL_3
-            CLOG(INFO, "LOGGER_SYS") << "Fourier Transform in Grid Correction";
+    CLOG(INFO, "LOGGER_SYS") << "Fourier Transform in Grid Correction";
 #endif
-        }
-        else if (_mode == MODE_3D)
-        {
+}
+
+void Projector::gridCorrection(Volume& projectee) const
+{
 #ifdef VERBOSE_LEVEL_3
-            CLOG(INFO, "LOGGER_SYS") << "Inverse Fourier Transform in Grid Correction";
+    CLOG(INFO, "LOGGER_SYS") << "Inverse Fourier Transform in Grid Correction";
 #endif
 
 #ifdef PROJECTOR_REMOVE_NEG
-            #pragma omp parallel for
-            REMOVE_NEG(_projectee3D);
+    #pragma omp parallel for
+    REMOVE_NEG(projectee);
 #endif
 
-        if (_interp == LINEAR_INTERP)
-        {
-            #pragma omp parallel for schedule(dynamic)
-            VOLUME_FOR_EACH_PIXEL_RL(_projectee3D)
-                _projectee3D.setRL(_projectee3D.getRL(i, j, k)
-                                 / TIK_RL(NORM_3(i, j, k)
-                                        / _projectee3D.nColRL()),
-                                   i,
-                                   j,
-                                   k);
-        }
-        else if (_interp == NEAREST_INTERP)
-        {
-            #pragma omp parallel for schedule(dynamic)
-            VOLUME_FOR_EACH_PIXEL_RL(_projectee3D)
-                _projectee3D.setRL(_projectee3D.getRL(i, j, k)
-                                 / NIK_RL(NORM_3(i, j, k)
-                                        / _projectee3D.nColRL()),
-                                   i,
-                                   j,
-                                   k);
-        }
+    if (_interp == LINEAR_INTERP)
+    {
+        #pragma omp parallel for schedule(dynamic)
+        VOLUME_FOR_EACH_PIXEL_RL(projectee)
+            projectee.setRL(projectee.getRL(i, j, k)
+                          / TIK_RL(NORM_3(i, j, k)
+                                 / projectee.nColRL()),
+                            i,
+                            j,
+                            k);
+    }
+    else if (_interp == NEAREST_INTERP)
+    {
+        #pragma omp parallel for schedule(dynamic)
+        VOLUME_FOR_EACH_PIXEL_RL(projectee)
+            projectee.setRL(projectee.getRL(i, j, k)
+                          / NIK_RL(NORM_3(i, j, k)
+                                 / projectee.nColRL()),
+                            i,
+                            j,
+                            k);
+    }
 
 #ifdef VERBOSE_LEVEL_3
-            CLOG(INFO, "LOGGER_SYS") << "Fourier Transform in Grid Correction";
+    CLOG(INFO, "LOGGER_SYS") << "Fourier Transform in Grid Correction";
 #endif
-        }
-        else
-        {
-            REPORT_ERROR("INEXISTENT_MODE");
-
-            abort();
-        }
 }
@@ -10,6 +10,20 @@
 
 #include "Reconstructor.h"
 
+/**
+ * These functions hold and release a lock in memory shared by processes.
+ */
+static inline void lockShared(volatile int* lock)
+{
+    while (__sync_lock_test_and_set(lock, 1))
+        while (*lock);
+}
+
+static inline void unlockShared(volatile int* lock)
+{
+    __sync_lock_release(lock);
+}
+
 Reconstructor::Reconstructor()
 {
     defaultInit();
@@ -30,6 +44,25 @@ Reconstructor::Reconstructor(const int mode,
 
 Reconstructor::~Reconstructor()
 {
+    delete[] _partF;
+    delete[] _partT;
+    delete[] _tile;
+
+    // the memory shared on the node is freed with the other processes, unless
+    // MPI is finalised already
+
+    int finalized;
+
+    MPI_Finalized(&finalized);
+
+    if (!finalized)
+    {
+        freeNodeShared();
+
+        if (_node != MPI_COMM_NULL) MPI_Comm_free(&_node);
+        if (_nodeLeader != MPI_COMM_NULL) MPI_Comm_free(&_nodeLeader);
+    }
+
     _fft.fwDestroyPlanMT();
     _fft.bwDestroyPlanMT();
 }
@@ -82,6 +115,8 @@ void Reconstructor::init(const int mode,
 
     _maxRadius = (_size / 2 - CEIL(a));
 
+    _validW = false;
+
     allocSpace();
 
     reset();
@@ -104,9 +139,9 @@ void Reconstructor::allocSpace()
         BLOG(INFO, "LOGGER_RECO") << "Allocating Spaces";
 
         _F2D.alloc(PAD_SIZE, PAD_SIZE, FT_SPACE);
-        _W2D.alloc(PAD_SIZE, PAD_SIZE, FT_SPACE);
-        _C2D.alloc(PAD_SIZE, PAD_SIZE, FT_SPACE);
-        _T2D.alloc(PAD_SIZE, PAD_SIZE, FT_SPACE);
+        _W2D.alloc(PAD_SIZE, PAD_SIZE, 1);
+        _C2D.alloc(PAD_SIZE, PAD_SIZE, 1);
+        _T2D.alloc(PAD_SIZE, PAD_SIZE, 1);
     }
     else if (_mode == MODE_3D)
     {
@@ -122,11 +157,18 @@ void Reconstructor::allocSpace()
         ALOG(INFO, "LOGGER_RECO") << "Allocating Spaces";
         BLOG(INFO, "LOGGER_RECO") << "Allocating Spaces";
 
-        _F3D.alloc(PAD_SIZE, PAD_SIZE, PAD_SIZE, FT_SPACE);
-        _W3D.alloc(PAD_SIZE, PAD_SIZE, PAD_SIZE, FT_SPACE);
-        _C3D.alloc(PAD_SIZE, PAD_SIZE, PAD_SIZE, FT_SPACE);
-        _T3D.alloc(PAD_SIZE, PAD_SIZE, PAD_SIZE, FT_SPACE);
+        if (_nodeShared)
+            allocNodeShared();
+        else
+        {
+            freeNodeShared();
+
+            _F3D.alloc(PAD_SIZE, PAD_SIZE, PAD_SIZE, PAD_SPHERE_RADIUS);
+            _T3D.alloc(PAD_SIZE, PAD_SIZE, PAD_SIZE, PAD_SPHERE_RADIUS);
+        }
 
+        _W3D.alloc(PAD_SIZE, PAD_SIZE, PAD_SIZE, PAD_SPHERE_RADIUS);
+        _C3D.alloc(PAD_SIZE, PAD_SIZE, PAD_SIZE, PAD_SPHERE_RADIUS);
     }
     else 
     {
@@ -138,6 +180,14 @@ void Reconstructor::allocSpace()
 
 void Reconstructor::resizeSpace(const int size)
 {
+    // W is indexed by the frequency in the padded space, which does not depend
+    // on the size, thus it is kept for warm start
+
+    RealHalfVolume prevW;
+
+    if (_warmStartW && _validW)
+        prevW.swap((_mode == MODE_2D) ? _W2D : _W3D);
+
     _fft.fwDestroyPlanMT();
     _fft.bwDestroyPlanMT();
 
@@ -146,6 +196,22 @@ void Reconstructor::resizeSpace(const int size)
     allocSpace();
 
     reset();
+
+    if (prevW.isEmptyFT()) return;
+
+    RealHalfVolume& W = (_mode == MODE_2D) ? _W2D : _W3D;
+
+    // the frequencies beyond the previous space are marked by 0, and start
+    // from 1 in reconstruction
+
+    #pragma omp parallel for schedule(dynamic)
+    VOLUME_FOR_EACH_PIXEL_FT(W)
+        if ((i <= prevW.nColRL() / 2) &&
+            (abs(j) < prevW.nRowRL() / 2) &&
+            (abs(k) < GSL_MAX_INT(prevW.nSlcRL() / 2, 1)))
+            W.setFTHalf(prevW.getFTHalf(i, j, k), i, j, k);
+        else
+            W.setFTHalf(0, i, j, k);
 }
 
 void Reconstructor::reset()
@@ -159,33 +225,48 @@ void Reconstructor::reset()
 
     _MAP = true;
 
+    // the balanced weights of the previous reconstruction are kept for warm
+    // start
+
+    bool keepW = _warmStartW && _validW;
+
     if (_mode == MODE_2D)
     {
         #pragma omp parallel for
         SET_0_FT(_F2D);
 
         #pragma omp parallel for
-        SET_1_FT(_W2D);
-
-        #pragma omp parallel for
-        SET_0_FT(_C2D);
-
-        #pragma omp parallel for
-        SET_0_FT(_T2D);
+        FOR_EACH_PIXEL_FT(_W2D)
+        {
+            if (!keepW) _W2D[i] = 1;
+            _C2D[i] = 0;
+            _T2D[i] = 0;
+        }
     }
     else if (_mode == MODE_3D)
     {
-        #pragma omp parallel for
-        SET_0_FT(_F3D);
+        // F and T shared on the node are set to 0 by the leader, after the
+        // other processes finish working on them
 
-        #pragma omp parallel for
-        SET_1_FT(_W3D);
+        bool resetTF = nodeLeaderTF();
 
-        #pragma omp parallel for
-        SET_0_FT(_C3D);
+        if (nodeSharedTF()) MPI_Barrier(_node);
+
+        if (resetTF)
+        {
+            #pragma omp parallel for
+            SET_0_FT(_F3D);
+        }
 
         #pragma omp parallel for
-        SET_0_FT(_T3D);
+        FOR_EACH_PIXEL_FT(_W3D)
+        {
+            if (!keepW) _W3D[i] = 1;
+            _C3D[i] = 0;
+            if (resetTF) _T3D[i] = 0;
+        }
+
+        if (nodeSharedTF()) MPI_Barrier(_node);
     }
     else
     {
@@ -225,11 +306,67 @@ void Reconstructor::setJoinHalf(const bool joinHalf)
     _joinHalf = joinHalf;
 }
 
+void Reconstructor::setWarmStartW(const bool warmStartW)
+{
+    _warmStartW = warmStartW;
+}
+
+void Reconstructor::setBalanceRelax(const RFLOAT balanceRelax)
+{
+    _balanceRelax = balanceRelax;
+}
+
 void Reconstructor::setSymmetry(const Symmetry* sym)
 {
     _sym = sym;
 }
 
+void Reconstructor::setSymmetrizeMode(const int symmetrizeMode)
+{
+    _symmetrizeMode = symmetrizeMode;
+}
+
+bool Reconstructor::symmetrizeByInsert() const
+{
+    return _insertSym;
+}
+
+void Reconstructor::setReduceChunk(const size_t reduceChunk)
+{
+    _reduceChunk = reduceChunk;
+}
+
+void Reconstructor::setNodeShared(const bool nodeShared)
+{
+    if ((_hemi == MPI_COMM_NULL) || (nodeShared == _nodeShared)) return;
+
+    _nodeShared = nodeShared;
+
+    if (_nodeShared && (_node == MPI_COMM_NULL))
+    {
+        MPI_Comm_split_type(_hemi, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &_node);
+
+        MPI_Comm_rank(_node, &_nodeRank);
+        MPI_Comm_size(_node, &_nodeSize);
+
+        MPI_Comm_split(_hemi, (_nodeRank == 0) ? 0 : MPI_UNDEFINED, 0, &_nodeLeader);
+
+        ALOG(INFO, "LOGGER_RECO") << "F and T Shared by "
+                                  << _nodeSize
+                                  << " Processes on the Node";
+        BLOG(INFO, "LOGGER_RECO") << "F and T Shared by "
+                                  << _nodeSize
+                                  << " Processes on the Node";
+    }
+
+    if (!_F3D.isEmptyFT()) resizeSpace(_size);
+}
+
+void Reconstructor::setReconstructAlone(const bool reconstructAlone)
+{
+    _reconstructAlone = reconstructAlone;
+}
+
 void Reconstructor::setFSC(const vec& FSC)
 {
     _FSC = FSC;
@@ -457,20 +594,8 @@ void Reconstructor::insertP(const Image& src,
                        oldCor(1), 
                        _pf * _a, 
                        _kernelFT);
-#endif
-
-#ifdef RECONSTRUCTOR_TRILINEAR_KERNEL
-            _F2D.addFT(src.iGetFT(_iPxl[i])
-                     * REAL(ctf.iGetFT(_iPxl[i]))
-                     * (sig == NULL ? 1 : (*sig)(_iSig[i]))
-                     * w,
-                       oldCor(0), 
-                       oldCor(1));
-#endif
 
 #ifdef RECONSTRUCTOR_ADD_T_DURING_INSERT
-
-#ifdef RECONSTRUCTOR_MKB_KERNEL
             _T2D.addFT(TSGSL_pow_2(REAL(ctf.iGetFT(_iPxl[i])))
                      * (sig == NULL ? 1 : (*sig)(_iSig[i]))
                      * w,
@@ -480,14 +605,19 @@ void Reconstructor::insertP(const Image& src,
                        _kernelFT);
 #endif
 
-#ifdef RECONSTRUCTOR_TRILINEAR_KERNEL
-            _T2D.addFT(TSGSL_pow_2(REAL(ctf.iGetFT(_iPxl[i])))
-                     * (sig == NULL ? 1 : (*sig)(_iSig[i]))
-                     * w,
-                       oldCor(0), 
-                       oldCor(1));
 #endif
 
+#ifdef RECONSTRUCTOR_TRILINEAR_KERNEL
+            insertLinear(src.iGetFT(_iPxl[i])
+                       * REAL(ctf.iGetFT(_iPxl[i]))
+                       * (sig == NULL ? 1 : (*sig)(_iSig[i]))
+                       * w,
+                         TSGSL_pow_2(REAL(ctf.iGetFT(_iPxl[i])))
+                       * (sig == NULL ? 1 : (*sig)(_iSig[i]))
+                       * w,
+                         oldCor(0),
+                         oldCor(1),
+                         0);
 #endif
         }
 }
@@ -508,10 +638,22 @@ void Reconstructor::insertP(const Image& src,
         REPORT_ERROR("WRONG PRE(POST) CALCULATION MODE IN RECONSTRUCTOR");
 #endif
 
+    // the orientations related by symmetry are inserted one after another, as
+    // the pixels of an orientation are inserted close to each other
+
+    for (size_t s = 0; s <= _symRot.size(); s++)
+    {
+        mat33 rotCopy;
+
+        if (s == 0)
+            rotCopy = rot;
+        else
+            rotCopy = _symRot[s - 1] * rot;
+
         for (int i = 0; i < _nPxl; i++)
         {
             vec3 newCor((RFLOAT)(_iCol[i] * _pf), (RFLOAT)(_iRow[i] * _pf), 0);
-            vec3 oldCor = rot * newCor;
+            vec3 oldCor = rotCopy * newCor;
 
 #ifdef RECONSTRUCTOR_MKB_KERNEL
             _F3D.addFT(src.iGetFT(_iPxl[i])
@@ -523,21 +665,8 @@ void Reconstructor::insertP(const Image& src,
                        oldCor(2), 
                        _pf * _a, 
                        _kernelFT);
-#endif
-
-#ifdef RECONSTRUCTOR_TRILINEAR_KERNEL
-            _F3D.addFT(src.iGetFT(_iPxl[i])
-                     * REAL(ctf.iGetFT(_iPxl[i]))
-                     * (sig == NULL ? 1 : (*sig)(_iSig[i]))
-                     * w,
-                       oldCor(0), 
-                       oldCor(1), 
-                       oldCor(2));
-#endif
 
 #ifdef RECONSTRUCTOR_ADD_T_DURING_INSERT
-
-#ifdef RECONSTRUCTOR_MKB_KERNEL
             _T3D.addFT(TSGSL_pow_2(REAL(ctf.iGetFT(_iPxl[i])))
                      * (sig == NULL ? 1 : (*sig)(_iSig[i]))
                      * w,
@@ -548,54 +677,534 @@ void Reconstructor::insertP(const Image& src,
                        _kernelFT);
 #endif
 
+#endif
+
 #ifdef RECONSTRUCTOR_TRILINEAR_KERNEL
-            _T3D.addFT(TSGSL_pow_2(REAL(ctf.iGetFT(_iPxl[i])))
-                     * (sig == NULL ? 1 : (*sig)(_iSig[i]))
-                     * w,
-                       oldCor(0), 
-                       oldCor(1), 
-                       oldCor(2));
+            insertLinear(src.iGetFT(_iPxl[i])
+                       * REAL(ctf.iGetFT(_iPxl[i]))
+                       * (sig == NULL ? 1 : (*sig)(_iSig[i]))
+                       * w,
+                         TSGSL_pow_2(REAL(ctf.iGetFT(_iPxl[i])))
+                       * (sig == NULL ? 1 : (*sig)(_iSig[i]))
+                       * w,
+                         oldCor(0),
+                         oldCor(1),
+                         oldCor(2));
 #endif
+        }
+    }
+}
+
+void Reconstructor::allocInsert(const size_t memory,
+                                const size_t nInsert)
+{
+    freeInsert();
+
+    _memory = memory;
+
+    // the stencils of symmetrizing cached in the last iteration stay resident
+    // through insertion, thus they are taken out of the memory for insertion
+
+    size_t memoryInsert = memory - GSL_MIN(memory, _symmetrizer.memory());
 
+    _nThread = omp_get_max_threads();
+
+    size_t sizeFT = (_mode == MODE_2D) ? _F2D.sizeFT() : _F3D.sizeFT();
+
+    if ((_mode == MODE_3D) &&
+        (_sym != NULL) &&
+        (_sym->nSymmetryElement() > 0))
+    {
+        if (_symmetrizeMode == SYMMETRIZE_BY_INSERT)
+            _insertSym = true;
+        else if (_symmetrizeMode == SYMMETRIZE_AUTO)
+        {
+            // all the processes of the hemisphere should take the same way,
+            // which is decided by the process inserting the most images
+
+            unsigned long nInsertMax = nInsert;
+
+            MPI_Allreduce(MPI_IN_PLACE, &nInsertMax, 1, MPI_UNSIGNED_LONG, MPI_MAX, _hemi);
+
+            // both ways cost in proportion to the number of symmetry elements,
+            // and symmetrizing after insertion interpolates F and T on each
+            // voxel of the half sphere of symmetrizing
+
+            RFLOAT nVoxel = 2 * M_PI / 3 * gsl_pow_3(_maxRadius * _pf + 1);
+
+            _insertSym = (nInsertMax > 0) &&
+                         (SYMMETRIZE_INSERT_COST * nInsertMax * _nPxl < 2 * nVoxel);
+        }
+    }
+
+    if (_insertSym)
+    {
+        mat33 L, R;
+
+        // the value at x is added on R * x in symmetrizing, thus a pixel
+        // inserted at y is inserted at R^T * y as well
+
+        for (int l = 0; l < _sym->nSymmetryElement(); l++)
+        {
+            _sym->get(L, R, l);
+
+            _symRot.push_back(R.transpose());
+        }
+
+        ALOG(INFO, "LOGGER_RECO") << "Inserting Images at "
+                                  << _symRot.size() + 1
+                                  << " Orientations Related by Symmetry";
+        BLOG(INFO, "LOGGER_RECO") << "Inserting Images at "
+                                  << _symRot.size() + 1
+                                  << " Orientations Related by Symmetry";
+    }
+
+    size_t nCopy = _symRot.size() + 1;
+
+    _insertMode = INSERT_ATOMIC;
+
+    // the partial volumes of each thread would take back the memory saved by
+    // sharing F and T on the node
+
+#ifdef RECONSTRUCTOR_TRILINEAR_KERNEL
+    if ((!nodeSharedTF()) &&
+        (_nThread * sizeFT * (sizeof(Complex) + sizeof(RFLOAT)) <= memoryInsert))
+        _insertMode = INSERT_THREAD_PRIVATE;
+    else if (_nThread * (size_t)_nPxl * nCopy * sizeof(InsertSplat) <= memoryInsert)
+        _insertMode = INSERT_TILE;
+#endif
+
+    // the processes sharing F and T on the node take the same way, as the
+    // additions of tiles are not atomic, which is INSERT_ATOMIC if any of them
+    // can not buffer by tiles
+
+    if (nodeSharedTF())
+        MPI_Allreduce(MPI_IN_PLACE, &_insertMode, 1, MPI_INT, MPI_MIN, _node);
+
+    if (_insertMode == INSERT_THREAD_PRIVATE)
+    {
+        ALOG(INFO, "LOGGER_RECO") << "Inserting Images into Thread-Private Volumes";
+        BLOG(INFO, "LOGGER_RECO") << "Inserting Images into Thread-Private Volumes";
+
+        _partF = new Complex[_nThread * sizeFT];
+        _partT = new RFLOAT[_nThread * sizeFT];
+
+        // each thread touches its own partial volume first, for placing it in
+        // the memory close to the thread
+
+        #pragma omp parallel
+        {
+            size_t offset = omp_get_thread_num() * sizeFT;
+
+            memset(_partF + offset, 0, sizeFT * sizeof(Complex));
+            memset(_partT + offset, 0, sizeFT * sizeof(RFLOAT));
+        }
+    }
+    else if (_insertMode == INSERT_TILE)
+    {
+        ALOG(INFO, "LOGGER_RECO") << "Inserting Images by Tiles";
+        BLOG(INFO, "LOGGER_RECO") << "Inserting Images by Tiles";
+
+        _nTile = INSERT_N_TILE;
+
+        _tile = new vector<InsertSplat>[_nThread * _nTile];
+
+        _nSplatMax = memoryInsert / sizeof(InsertSplat);
+    }
+    else
+    {
+        ALOG(INFO, "LOGGER_RECO") << "Inserting Images by Atomic Additions";
+        BLOG(INFO, "LOGGER_RECO") << "Inserting Images by Atomic Additions";
+    }
+}
+
+int Reconstructor::insertBatch() const
+{
+    if (_insertMode == INSERT_TILE)
+        return GSL_MAX_INT(1, (int)GSL_MIN(_nSplatMax / ((size_t)_nPxl * (_symRot.size() + 1)),
+                                           (size_t)INT_MAX));
+    else
+        return INT_MAX;
+}
+
+void Reconstructor::flushInsert()
+{
+    if (_insertMode != INSERT_TILE) return;
+
+    Complex* F = (_mode == MODE_2D) ? &_F2D[0] : &_F3D[0];
+    RFLOAT* T = (_mode == MODE_2D) ? &_T2D[0] : &_T3D[0];
+
+    if (nodeSharedTF())
+    {
+        // the processes on the node flush at different times, thus a tile is
+        // applied holding the locks of itself and the next one, taken in
+        // order, and the processes start from different tiles
+
+        int start = _nodeRank * _nTile / _nodeSize;
+
+        #pragma omp parallel for schedule(dynamic)
+        for (int s = 0; s < _nTile; s++)
+        {
+            int tile = (start + s) % _nTile;
+
+            bool empty = true;
+
+            for (int t = 0; t < _nThread; t++)
+                if (!_tile[t * _nTile + tile].empty()) empty = false;
+
+            if (empty) continue;
+
+            int next = (tile + 1) % _nTile;
+
+            lockShared(_tileLock + GSL_MIN_INT(tile, next));
+            lockShared(_tileLock + GSL_MAX_INT(tile, next));
+
+            for (int t = 0; t < _nThread; t++)
+            {
+                vector<InsertSplat>& buffer = _tile[t * _nTile + tile];
+
+                for (size_t i = 0; i < buffer.size(); i++)
+                    addSplat(F, T, buffer[i]);
+
+                buffer.clear();
+            }
+
+            unlockShared(_tileLock + GSL_MAX_INT(tile, next));
+            unlockShared(_tileLock + GSL_MIN_INT(tile, next));
+        }
+
+        return;
+    }
+
+    // a pixel in a tile is added on the tile and the next one, thus the even
+    // tiles and the odd tiles are applied in turn, and the last tile, which
+    // wraps around to the first one, is applied alone
+
+    for (int phase = 0; phase < 3; phase++)
+    {
+        #pragma omp parallel for schedule(dynamic)
+        for (int tile = 0; tile < _nTile; tile++)
+        {
+            if (((phase == 2) && (tile != _nTile - 1)) ||
+                ((phase != 2) && ((tile == _nTile - 1) || (tile % 2 != phase))))
+                continue;
+
+            for (int t = 0; t < _nThread; t++)
+            {
+                vector<InsertSplat>& buffer = _tile[t * _nTile + tile];
+
+                for (size_t i = 0; i < buffer.size(); i++)
+                    addSplat(F, T, buffer[i]);
+
+                buffer.clear();
+            }
+        }
+    }
+}
+
+void Reconstructor::insertLinear(const Complex f,
+                                 const RFLOAT t,
+                                 RFLOAT iCol,
+                                 RFLOAT iRow,
+                                 RFLOAT iSlc)
+{
+    if (_insertMode == INSERT_ATOMIC)
+    {
+        if (_mode == MODE_2D)
+        {
+            _F2D.addFT(f, iCol, iRow);
+#ifdef RECONSTRUCTOR_ADD_T_DURING_INSERT
+            _T2D.addFT(t, iCol, iRow);
 #endif
         }
+        else
+        {
+            _F3D.addFT(f, iCol, iRow, iSlc);
+#ifdef RECONSTRUCTOR_ADD_T_DURING_INSERT
+            _T3D.addFT(t, iCol, iRow, iSlc);
+#endif
+        }
+
+        return;
+    }
+
+    InsertSplat splat;
+
+    bool conj = conjHalf(iCol, iRow, iSlc);
+
+    splat.x[0] = iCol;
+    splat.x[1] = iRow;
+    splat.x[2] = iSlc;
+
+    splat.f = conj ? CONJUGATE(f) : f;
+    splat.t = t;
+
+    int thread = omp_get_thread_num();
+
+    if (_insertMode == INSERT_THREAD_PRIVATE)
+    {
+        size_t offset = thread * ((_mode == MODE_2D) ? _F2D.sizeFT() : _F3D.sizeFT());
+
+        addSplat(_partF + offset, _partT + offset, splat);
+    }
+    else
+    {
+        int x0 = floor(splat.x[(_mode == MODE_2D) ? 1 : 2]);
+
+        int tile = (x0 >= 0 ? x0 : x0 + PAD_SIZE) / INSERT_TILE_THICKNESS;
+
+        _tile[thread * _nTile + tile].push_back(splat);
+    }
+}
+
+void Reconstructor::addSplat(Complex* F,
+                             RFLOAT* T,
+                             const InsertSplat& splat) const
+{
+    if (_mode == MODE_2D)
+    {
+        RFLOAT w[2][2];
+        int x0[2];
+
+        WG_BI_INTERP_LINEAR(w, x0, splat.x);
+
+        FOR_CELL_DIM_2
+        {
+            size_t index = _F2D.iFTHalf(x0[0] + i, x0[1] + j);
+
+            F[index].dat[0] += splat.f.dat[0] * w[j][i];
+            F[index].dat[1] += splat.f.dat[1] * w[j][i];
+
+#ifdef RECONSTRUCTOR_ADD_T_DURING_INSERT
+            T[index] += splat.t * w[j][i];
+#endif
+        }
+    }
+    else
+    {
+        RFLOAT w[2][2][2];
+        int x0[3];
+
+        WG_TRI_INTERP_LINEAR(w, x0, splat.x);
+
+        const SphereIndex& sphere = _F3D.index();
+
+        for (int k = 0; k < 2; k++)
+            for (int j = 0; j < 2; j++)
+            {
+                size_t row = sphere.iRowFT(x0[1] + j, x0[2] + k);
+
+                for (int i = 0; i < 2; i++)
+                {
+                    if (x0[0] + i >= sphere.len(row)) continue;
+
+                    size_t index = sphere.offset(row) + x0[0] + i;
+
+                    F[index].dat[0] += splat.f.dat[0] * w[k][j][i];
+                    F[index].dat[1] += splat.f.dat[1] * w[k][j][i];
+
+#ifdef RECONSTRUCTOR_ADD_T_DURING_INSERT
+                    T[index] += splat.t * w[k][j][i];
+#endif
+                }
+            }
+    }
+}
+
+void Reconstructor::freeInsert()
+{
+    if (_insertMode == INSERT_THREAD_PRIVATE)
+    {
+        addPartT();
+        addPartF();
+    }
+    else if (_insertMode == INSERT_TILE)
+        flushInsert();
+
+    delete[] _partF;
+    delete[] _partT;
+    delete[] _tile;
+
+    _partF = NULL;
+    _partT = NULL;
+    _tile = NULL;
+
+    _nTile = 0;
+    _nSplatMax = 0;
+
+    _insertMode = INSERT_ATOMIC;
+
+    _insertSym = false;
+
+    _symRot.clear();
+}
+
+void Reconstructor::addPartT()
+{
+    if (_partT == NULL) return;
+
+    RFLOAT* T = (_mode == MODE_2D) ? &_T2D[0] : &_T3D[0];
+
+    size_t sizeFT = (_mode == MODE_2D) ? _T2D.sizeFT() : _T3D.sizeFT();
+
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < sizeFT; i++)
+        for (int t = 0; t < _nThread; t++)
+            T[i] += _partT[t * sizeFT + i];
+
+    delete[] _partT;
+
+    _partT = NULL;
+}
+
+void Reconstructor::addPartF()
+{
+    if (_partF == NULL) return;
+
+    Complex* F = (_mode == MODE_2D) ? &_F2D[0] : &_F3D[0];
+
+    size_t sizeFT = (_mode == MODE_2D) ? _F2D.sizeFT() : _F3D.sizeFT();
+
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < sizeFT; i++)
+        for (int t = 0; t < _nThread; t++)
+        {
+            F[i].dat[0] += _partF[t * sizeFT + i].dat[0];
+            F[i].dat[1] += _partF[t * sizeFT + i].dat[1];
+        }
+
+    delete[] _partF;
+
+    _partF = NULL;
 }
 
 void Reconstructor::prepareTF()
+{
+    beginPrepareTF();
+
+    endPrepareTF();
+}
+
+void Reconstructor::beginPrepareTF()
 {
     IF_MASTER return;
 
+    // F and T are symmetric already, if the images are inserted at all the
+    // orientations related by symmetry
+
+    _symmetrizedTF = _insertSym;
+
+    // T is all-reduced while the partial volumes of F are still being added
+    // up
+
+    if (_insertMode == INSERT_TILE) flushInsert();
+
+    addPartT();
+
+    // F and T shared on the node are all-reduced by the leaders of the nodes,
+    // after all the processes on the node finish inserting
+
+    if (nodeSharedTF()) MPI_Barrier(_node);
+
     ALOG(INFO, "LOGGER_RECO") << "Allreducing T";
     BLOG(INFO, "LOGGER_RECO") << "Allreducing T";
 
     allReduceT();
 
+    addPartF();
+
+    freeInsert();
+
+    ALOG(INFO, "LOGGER_RECO") << "Allreducing F";
+    BLOG(INFO, "LOGGER_RECO") << "Allreducing F";
+
+    allReduceF();
+}
+
+void Reconstructor::endPrepareTF()
+{
+    IF_MASTER return;
+
+    // F and T shared on the node are normalised and symmetrized by the
+    // leader, while the other processes wait
+
+    if (!nodeLeaderTF())
+    {
+        MPI_Barrier(_node);
+
+        return;
+    }
+
+    MPI_Wait_Large(_reduceT);
+
+#ifdef RECONSTRUCTOR_NORMALISE_T_F
+    ALOG(INFO, "LOGGER_RECO") << "Normalising T and F";
+    BLOG(INFO, "LOGGER_RECO") << "Normalising T and F";
+
+    RFLOAT sf = 1.0 / ((_mode == MODE_2D) ? _T2D[0] : _T3D[0]);
+
+    if (_mode == MODE_2D)
+    {
+        #pragma omp parallel for
+        SCALE_FT(_T2D, sf);
+    }
+    else if (_mode == MODE_3D)
+    {
+        #pragma omp parallel for
+        SCALE_FT(_T3D, sf);
+    }
+    else
+    {
+        REPORT_ERROR("INEXISTENT MODE");
+
+        abort();
+    }
+#endif
+
     // only in 3D mode, symmetry should be considered
     IF_MODE_3D
     {
 #ifdef RECONSTRUCTOR_SYMMETRIZE_DURING_RECONSTRUCT
-        ALOG(INFO, "LOGGER_RECO") << "Symmetrizing T";
-        BLOG(INFO, "LOGGER_RECO") << "Symmetrizing T";
+        if (!_symmetrizedTF)
+        {
+            ALOG(INFO, "LOGGER_RECO") << "Symmetrizing T";
+            BLOG(INFO, "LOGGER_RECO") << "Symmetrizing T";
 
-        symmetrizeT();
+            symmetrizeT();
+        }
 #endif
     }
 
-    ALOG(INFO, "LOGGER_RECO") << "Allreducing F";
-    BLOG(INFO, "LOGGER_RECO") << "Allreducing F";
+    MPI_Wait_Large(_reduceF);
 
-    allReduceF();
+#ifdef RECONSTRUCTOR_NORMALISE_T_F
+    if (_mode == MODE_2D)
+    {
+        #pragma omp parallel for
+        SCALE_FT(_F2D, sf);
+    }
+    else if (_mode == MODE_3D)
+    {
+        #pragma omp parallel for
+        SCALE_FT(_F3D, sf);
+    }
+#endif
 
     // only in 3D mode, symmetry should be considered
     IF_MODE_3D
     {
 #ifdef RECONSTRUCTOR_SYMMETRIZE_DURING_RECONSTRUCT
-        ALOG(INFO, "LOGGER_RECO") << "Symmetrizing F";
-        BLOG(INFO, "LOGGER_RECO") << "Symmetrizing F";
+        if (!_symmetrizedTF)
+        {
+            ALOG(INFO, "LOGGER_RECO") << "Symmetrizing F";
+            BLOG(INFO, "LOGGER_RECO") << "Symmetrizing F";
 
-        symmetrizeF();
+            symmetrizeF();
+        }
 #endif
     }
+
+    if (nodeSharedTF()) MPI_Barrier(_node);
 }
 
 void Reconstructor::reconstruct(Image& dst)
@@ -644,14 +1253,12 @@ void Reconstructor::reconstruct(Volume& dst)
         {
             ringAverage(avg,
                         _T2D,
-                        gsl_real,
                         _maxRadius * _pf - 1);
         }
         else if (_mode == MODE_3D)
         {
             shellAverage(avg,
                          _T3D,
-                         gsl_real,
                          _maxRadius * _pf - 1);
         }
         else
@@ -709,46 +1316,59 @@ void Reconstructor::reconstruct(Volume& dst)
 #endif
 
 #ifdef RECONSTRUCTOR_WIENER_FILTER_FSC_FREQ_AVG
-                    _T2D.setFT(_T2D.getFT(i, j)
-                             + COMPLEX((1 - FSC) / FSC * avg(u), 0),
-                               i,
-                               j);
+                    _T2D.setFTHalf(_T2D.getFTHalf(i, j)
+                                 + (1 - FSC) / FSC * avg(u),
+                                   i,
+                                   j);
 #else
-                    _T2D.setFT(_T2D.getFT(i, j) / FSC, i, j);
+                    _T2D.setFTHalf(_T2D.getFTHalf(i, j) / FSC, i, j);
 #endif
                 }
         }
         else if (_mode == MODE_3D)
         {
-            #pragma omp parallel for schedule(dynamic)
-            VOLUME_FOR_EACH_PIXEL_FT(_T3D)
-                if ((QUAD_3(i, j, k) >= TSGSL_pow_2(WIENER_FACTOR_MIN_R * _pf)) &&
-                    (QUAD_3(i, j, k) < TSGSL_pow_2(_maxRadius * _pf)))
-                {
-                    int u = AROUND(NORM_3(i, j, k));
+            // T shared on the node is divided once by the leader, after the
+            // other processes finish reading it, unless this process
+            // reconstructs alone
 
-                    RFLOAT FSC = (u / _pf >= _FSC.size())
-                               ? 0
-                               : _FSC(u / _pf);
+            bool waitNode = nodeSharedTF() && !_reconstructAlone;
 
-                    FSC = GSL_MAX_DBL(FSC_BASE_L, GSL_MIN_DBL(FSC_BASE_H, FSC));
+            if (waitNode) MPI_Barrier(_node);
+
+            if (_reconstructAlone || nodeLeaderTF())
+            {
+                #pragma omp parallel for schedule(dynamic)
+                VOLUME_FOR_EACH_PIXEL_FT(_T3D)
+                    if ((QUAD_3(i, j, k) >= TSGSL_pow_2(WIENER_FACTOR_MIN_R * _pf)) &&
+                        (QUAD_3(i, j, k) < TSGSL_pow_2(_maxRadius * _pf)))
+                    {
+                        int u = AROUND(NORM_3(i, j, k));
+
+                        RFLOAT FSC = (u / _pf >= _FSC.size())
+                                   ? 0
+                                   : _FSC(u / _pf);
+
+                        FSC = GSL_MAX_DBL(FSC_BASE_L, GSL_MIN_DBL(FSC_BASE_H, FSC));
 
 #ifdef RECONSTRUCTOR_ALWAYS_JOIN_HALF
-                    FSC = sqrt(2 * FSC / (1 + FSC));
+                        FSC = sqrt(2 * FSC / (1 + FSC));
 #else
-                    if (_joinHalf) FSC = sqrt(2 * FSC / (1 + FSC));
+                        if (_joinHalf) FSC = sqrt(2 * FSC / (1 + FSC));
 #endif
 
 #ifdef RECONSTRUCTOR_WIENER_FILTER_FSC_FREQ_AVG
-                    _T3D.setFT(_T3D.getFT(i, j, k)
-                             + COMPLEX((1 - FSC) / FSC * avg(u), 0),
-                               i,
-                               j,
-                               k);
+                        _T3D.setFTHalf(_T3D.getFTHalf(i, j, k)
+                                     + (1 - FSC) / FSC * avg(u),
+                                       i,
+                                       j,
+                                       k);
 #else
-                    _T3D.setFT(_T3D.getFT(i, j, k) / FSC, i, j, k);
+                        _T3D.setFTHalf(_T3D.getFTHalf(i, j, k) / FSC, i, j, k);
 #endif
-                }
+                    }
+            }
+
+            if (waitNode) MPI_Barrier(_node);
         }
         else
         {
@@ -766,30 +1386,13 @@ void Reconstructor::reconstruct(Volume& dst)
 
 #endif
 
-    if (_mode == MODE_2D)
-    {
-        #pragma omp parallel for
-        IMAGE_FOR_EACH_PIXEL_FT(_W2D)
-            if (QUAD(i, j) < TSGSL_pow_2(_maxRadius * _pf))
-                _W2D.setFTHalf(COMPLEX(1, 0), i, j);
-            else
-                _W2D.setFTHalf(COMPLEX(0, 0), i, j);
-    }
-    else if (_mode == MODE_3D)
-    {
-        #pragma omp parallel for
-        VOLUME_FOR_EACH_PIXEL_FT(_W3D)
-            if (QUAD_3(i, j, k) < TSGSL_pow_2(_maxRadius * _pf))
-                _W3D.setFTHalf(COMPLEX(1, 0), i, j, k);
-            else
-                _W3D.setFTHalf(COMPLEX(0, 0), i, j, k);
-    }
-    else
-    {
-        REPORT_ERROR("INEXISTENT MODE");
+    bool warm = _warmStartW && _validW;
 
-        abort();
-    }
+    initW(warm);
+
+    double start = omp_get_wtime();
+
+    RFLOAT relax = _balanceRelax;
 
     RFLOAT diffC = DBL_MAX;
     RFLOAT diffCPrev = DBL_MAX;
@@ -851,8 +1454,7 @@ void Reconstructor::reconstruct(Volume& dst)
             IMAGE_FOR_EACH_PIXEL_FT(_W2D)
                 if (QUAD(i, j) < TSGSL_pow_2(_maxRadius * _pf))
                     _W2D.setFTHalf(_W2D.getFTHalf(i, j)
-                                 / GSL_MAX_DBL(ABS(_C2D.getFTHalf(i, j)),
-                                               1e-6),
+                                 / balanceFactor(_C2D.getFTHalf(i, j), relax),
                                    i,
                                    j);
         }
@@ -862,8 +1464,7 @@ void Reconstructor::reconstruct(Volume& dst)
             VOLUME_FOR_EACH_PIXEL_FT(_W3D)
                 if (QUAD_3(i, j, k) < TSGSL_pow_2(_maxRadius * _pf))
                     _W3D.setFTHalf(_W3D.getFTHalf(i, j, k)
-                                 / GSL_MAX_DBL(ABS(_C3D.getFTHalf(i, j, k)),
-                                               1e-6),
+                                 / balanceFactor(_C3D.getFTHalf(i, j, k), relax),
                                    i,
                                    j,
                                    k);
@@ -893,6 +1494,34 @@ void Reconstructor::reconstruct(Volume& dst)
 
 #endif
 
+        if ((m == 0) && warm && (diffC > WARM_START_DIFF_C_THRES))
+        {
+            // the weights of the previous reconstruction are too far away from
+            // balanced, thus balancing restarts from 1
+
+            ALOG(INFO, "LOGGER_RECO") << "Distance to Total Balanced of Warm Start: "
+                                      << diffC
+                                      << ", Restarting Balancing Weights";
+            BLOG(INFO, "LOGGER_RECO") << "Distance to Total Balanced of Warm Start: "
+                                      << diffC
+                                      << ", Restarting Balancing Weights";
+
+            warm = false;
+
+            initW(warm);
+
+            diffC = DBL_MAX;
+
+            m = -1;
+
+            continue;
+        }
+
+        // over-relaxation is given up once it stops the distance from
+        // decreasing
+
+        if (diffC > diffCPrev) relax = 1;
+
         if (diffC > diffCPrev * DIFF_C_DECREASE_THRES)
             nDiffCNoDecrease += 1;
         else
@@ -901,19 +1530,35 @@ void Reconstructor::reconstruct(Volume& dst)
         if ((diffC < DIFF_C_THRES) ||
             ((m >= MIN_N_ITER_BALANCE) &&
              (nDiffCNoDecrease == N_DIFF_C_NO_DECREASE))) break;
-    }
 
-#ifdef VERBOSE_LEVEL_2
+        // in warm start, balancing stops as soon as the weights are as
+        // balanced as the previous reconstruction
 
-    ALOG(INFO, "LOGGER_SYS") << "After "
-                             << m
-                             << " Iterations, Distance to Total Balanced: "
-                             << diffC;
-    BLOG(INFO, "LOGGER_SYS") << "After "
-                             << m
-                             << " Iterations, Distance to Total Balanced: "
-                             << diffC;
-#endif
+        if (warm && (diffC <= _diffCW[_MAP])) break;
+    }
+
+    _validW = true;
+
+    _diffCW[_MAP] = diffC;
+
+    int nIter = GSL_MIN_INT(m + 1, MAX_N_ITER_BALANCE);
+
+    ALOG(INFO, "LOGGER_RECO") << "Balancing Weights"
+                              << (warm ? " from Warm Start" : "")
+                              << " in "
+                              << nIter
+                              << " Iterations, "
+                              << omp_get_wtime() - start
+                              << " Seconds, Distance to Total Balanced: "
+                              << diffC;
+    BLOG(INFO, "LOGGER_RECO") << "Balancing Weights"
+                              << (warm ? " from Warm Start" : "")
+                              << " in "
+                              << nIter
+                              << " Iterations, "
+                              << omp_get_wtime() - start
+                              << " Seconds, Distance to Total Balanced: "
+                              << diffC;
 
     if (_mode == MODE_2D)
     {
@@ -1122,79 +1767,142 @@ void Reconstructor::reconstruct(Volume& dst)
 
 void Reconstructor::allReduceF()
 {
-
-    ALOG(INFO, "LOGGER_RECO") << "Waiting for Synchronizing all Processes in Hemisphere A";
-    BLOG(INFO, "LOGGER_RECO") << "Waiting for Synchronizing all Processes in Hemisphere B";
-
-    MPI_Barrier(_hemi);
-
     if (_mode == MODE_2D)
-        MPI_Allreduce_Large(&_F2D[0],
-                            _F2D.sizeFT(),
-                            MPI_DOUBLE_COMPLEX,
-                            MPI_SUM,
-                            _hemi);
+        MPI_Iallreduce_Large(&_F2D[0],
+                             _F2D.sizeFT(),
+                             MPI_DOUBLE_COMPLEX,
+                             MPI_SUM,
+                             _hemi,
+                             _reduceF,
+                             _reduceChunk);
     else if (_mode == MODE_3D)
-        MPI_Allreduce_Large(&_F3D[0],
-                            _F3D.sizeFT(),
-                            MPI_DOUBLE_COMPLEX,
-                            MPI_SUM,
-                            _hemi);
+    {
+        if (!nodeLeaderTF()) return;
+
+        MPI_Iallreduce_Large(&_F3D[0],
+                             _F3D.sizeFT(),
+                             MPI_DOUBLE_COMPLEX,
+                             MPI_SUM,
+                             nodeSharedTF() ? _nodeLeader : _hemi,
+                             _reduceF,
+                             _reduceChunk);
+    }
     else
         REPORT_ERROR("INEXISTENT MODE");
-
-    MPI_Barrier(_hemi);
 }
 
 void Reconstructor::allReduceT()
 {
-    ALOG(INFO, "LOGGER_RECO") << "Waiting for Synchronizing all Processes in Hemisphere A";
-    BLOG(INFO, "LOGGER_RECO") << "Waiting for Synchronizing all Processes in Hemisphere B";
-
-    MPI_Barrier(_hemi);
-
     if (_mode == MODE_2D)
-        MPI_Allreduce_Large(&_T2D[0],
-                            _T2D.sizeFT(),
-                            MPI_DOUBLE_COMPLEX,
-                            MPI_SUM,
-                            _hemi);
+        MPI_Iallreduce_Large(&_T2D[0],
+                             _T2D.sizeFT(),
+                             MPI_DOUBLE,
+                             MPI_SUM,
+                             _hemi,
+                             _reduceT,
+                             _reduceChunk);
     else if (_mode == MODE_3D)
-        MPI_Allreduce_Large(&_T3D[0],
-                            _T3D.sizeFT(),
-                            MPI_DOUBLE_COMPLEX,
-                            MPI_SUM,
-                            _hemi);
+    {
+        if (!nodeLeaderTF()) return;
+
+        MPI_Iallreduce_Large(&_T3D[0],
+                             _T3D.sizeFT(),
+                             MPI_DOUBLE,
+                             MPI_SUM,
+                             nodeSharedTF() ? _nodeLeader : _hemi,
+                             _reduceT,
+                             _reduceChunk);
+    }
     else
     {
         REPORT_ERROR("INEXISTENT MODE");
 
         abort();
     }
+}
+
+void Reconstructor::allocNodeShared()
+{
+    freeNodeShared();
+
+    SphereIndex index;
+
+    index.alloc(PAD_SIZE, PAD_SIZE, PAD_SIZE, PAD_SPHERE_RADIUS);
+
+    size_t sizeF = index.size() * sizeof(Complex);
+    size_t sizeT = index.size() * sizeof(RFLOAT);
+
+    int nTile = INSERT_N_TILE;
+
+    // the leader allocates the memory, and the others query it
+
+    char* base;
+
+    MPI_Win_allocate_shared((_nodeRank == 0) ? sizeF + sizeT + nTile * sizeof(int) : 0,
+                            1,
+                            MPI_INFO_NULL,
+                            _node,
+                            &base,
+                            &_nodeWin);
+
+    if (_nodeRank != 0)
+    {
+        MPI_Aint size;
+        int dispUnit;
+
+        MPI_Win_shared_query(_nodeWin, 0, &size, &dispUnit, &base);
+    }
 
-    MPI_Barrier(_hemi);
+    _F3D.attach((Complex*)base, PAD_SIZE, PAD_SIZE, PAD_SIZE, PAD_SPHERE_RADIUS);
+    _T3D.attach((RFLOAT*)(base + sizeF), PAD_SIZE, PAD_SIZE, PAD_SIZE, PAD_SPHERE_RADIUS);
 
-#ifdef RECONSTRUCTOR_NORMALISE_T_F
-    ALOG(INFO, "LOGGER_RECO") << "Normalising T and F";
-    BLOG(INFO, "LOGGER_RECO") << "Normalising T and F";
+    _tileLock = (int*)(base + sizeF + sizeT);
+
+    if (_nodeRank == 0) memset(_tileLock, 0, nTile * sizeof(int));
+
+    MPI_Barrier(_node);
+}
+
+void Reconstructor::freeNodeShared()
+{
+    if (!nodeSharedTF()) return;
+
+    _F3D.clear();
+    _T3D.clear();
+
+    _tileLock = NULL;
+
+    MPI_Win_free(&_nodeWin);
+}
+
+void Reconstructor::initW(const bool warm)
+{
+    // in warm start, W inside the max radius is kept, except the frequencies
+    // which have no weight yet
 
     if (_mode == MODE_2D)
     {
-        RFLOAT sf = 1.0 / REAL(_T2D[0]);
-
         #pragma omp parallel for
-        SCALE_FT(_T2D, sf);
-        #pragma omp parallel for
-        SCALE_FT(_F2D, sf);
+        IMAGE_FOR_EACH_PIXEL_FT(_W2D)
+            if (QUAD(i, j) < TSGSL_pow_2(_maxRadius * _pf))
+            {
+                if (!warm || (_W2D.getFTHalf(i, j) <= 0))
+                    _W2D.setFTHalf(1, i, j);
+            }
+            else
+                _W2D.setFTHalf(0, i, j);
     }
     else if (_mode == MODE_3D)
     {
-        RFLOAT sf = 1.0 / REAL(_T3D[0]);
-
-        #pragma omp parallel for
-        SCALE_FT(_T3D, sf);
         #pragma omp parallel for
-        SCALE_FT(_F3D, sf);
+        VOLUME_FOR_EACH_PIXEL_FT(_W3D)
+            if (QUAD_3(i, j, k) < TSGSL_pow_2(_maxRadius * _pf))
+            {
+                if (!warm || (_W3D.getFTHalf(i, j, k) <= 0))
+                    _W3D.setFTHalf(1, i, j, k);
+            }
+            else
+                _W3D.setFTHalf(0, i, j, k);
     }
     else
     {
@@ -1202,7 +1910,6 @@ void Reconstructor::allReduceT()
 
         abort();
     }
-#endif
 }
 
 RFLOAT Reconstructor::checkC() const
@@ -1219,7 +1926,7 @@ RFLOAT Reconstructor::checkC() const
             if (QUAD(i, j) < TSGSL_pow_2(_maxRadius * _pf))
             {
                 #pragma omp atomic
-                diff += fabs(ABS(_C2D.getFT(i, j)) - 1);
+                diff += fabs(fabs(_C2D.getFT(i, j)) - 1);
                 #pragma omp atomic
                 counter += 1;
             }
@@ -1231,7 +1938,7 @@ RFLOAT Reconstructor::checkC() const
             if (QUAD_3(i, j, k) < TSGSL_pow_2(_maxRadius * _pf))
             {
                 #pragma omp atomic
-                diff += fabs(ABS(_C3D.getFT(i, j, k)) - 1);
+                diff += fabs(fabs(_C3D.getFT(i, j, k)) - 1);
                 #pragma omp atomic
                 counter += 1;
             }
@@ -1254,7 +1961,7 @@ RFLOAT Reconstructor::checkC() const
         #pragma omp parallel for schedule(dynamic)
         IMAGE_FOR_EACH_PIXEL_FT(_C2D)
             if (QUAD(i, j) < TSGSL_pow_2(_maxRadius * _pf))
-                diff[_C2D.iFTHalf(i, j)] = fabs(ABS(_C2D.getFTHalf(i, j)) - 1);
+                diff[_C2D.iFTHalf(i, j)] = fabs(fabs(_C2D.getFTHalf(i, j)) - 1);
 
         return *std::max_element(diff.begin(), diff.end());
     }
@@ -1265,7 +1972,7 @@ RFLOAT Reconstructor::checkC() const
         #pragma omp parallel for schedule(dynamic)
         VOLUME_FOR_EACH_PIXEL_FT(_C3D)
             if (QUAD_3(i, j, k) < TSGSL_pow_2(_maxRadius * _pf))
-                diff[_C3D.iFTHalf(i, j, k)] = fabs(ABS(_C3D.getFTHalf(i, j, k)) - 1);
+                diff[_C3D.iFTHalf(i, j, k)] = fabs(fabs(_C3D.getFTHalf(i, j, k)) - 1);
 
         return *std::max_element(diff.begin(), diff.end());
     }
@@ -1286,38 +1993,57 @@ void Reconstructor::convoluteC()
     RFLOAT nf = MKB_RL(0, _a, _alpha);
 #endif
 
+    // C is real, thus it is placed into the real part of a complex volume
+    // for Fourier transform, which only lives during convolution
+
     if (_mode == MODE_2D)
     {
-        _fft.bwExecutePlanMT(_C2D);
+        Image C(PAD_SIZE, PAD_SIZE, FT_SPACE);
 
         #pragma omp parallel for
-        IMAGE_FOR_EACH_PIXEL_RL(_C2D)
-            _C2D.setRL(_C2D.getRL(i, j)
-                     * _kernelRL(QUAD(i, j) / TSGSL_pow_2(_N * _pf))
-                     / nf,
-                       i,
-                       j);
+        FOR_EACH_PIXEL_FT(C)
+            C[i] = COMPLEX(_C2D[i], 0);
 
-        _fft.fwExecutePlanMT(_C2D);
+        _fft.bwExecutePlanMT(C);
 
-        _C2D.clearRL();
+        #pragma omp parallel for
+        IMAGE_FOR_EACH_PIXEL_RL(C)
+            C.setRL(C.getRL(i, j)
+                  * _kernelRL(QUAD(i, j) / TSGSL_pow_2(_N * _pf))
+                  / nf,
+                    i,
+                    j);
+
+        _fft.fwExecutePlanMT(C);
+
+        #pragma omp parallel for
+        FOR_EACH_PIXEL_FT(C)
+            _C2D[i] = REAL(C[i]);
     }
     else if (_mode == MODE_3D)
     {
-        _fft.bwExecutePlanMT(_C3D);
+        Volume C(PAD_SIZE, PAD_SIZE, PAD_SIZE, FT_SPACE);
 
         #pragma omp parallel for
-        VOLUME_FOR_EACH_PIXEL_RL(_C3D)
-            _C3D.setRL(_C3D.getRL(i, j, k)
-                     * _kernelRL(QUAD_3(i, j, k) / TSGSL_pow_2(_N * _pf))
-                     / nf,
-                       i,
-                       j,
-                       k);
+        VOLUME_FOR_EACH_PIXEL_FT(C)
+            C.setFTHalf(COMPLEX(_C3D.getFTHalf(i, j, k), 0), i, j, k);
 
-        _fft.fwExecutePlanMT(_C3D);
+        _fft.bwExecutePlanMT(C);
 
-        _C3D.clearRL();
+        #pragma omp parallel for
+        VOLUME_FOR_EACH_PIXEL_RL(C)
+            C.setRL(C.getRL(i, j, k)
+                  * _kernelRL(QUAD_3(i, j, k) / TSGSL_pow_2(_N * _pf))
+                  / nf,
+                    i,
+                    j,
+                    k);
+
+        _fft.fwExecutePlanMT(C);
+
+        #pragma omp parallel for
+        VOLUME_FOR_EACH_PIXEL_FT(C)
+            _C3D.setFTHalf(REAL(C.getFTHalf(i, j, k)), i, j, k);
     }
     else
     {
@@ -1330,7 +2056,17 @@ void Reconstructor::convoluteC()
 void Reconstructor::symmetrizeF()
 {
     if (_sym != NULL)
-        SYMMETRIZE_FT(_F3D, _F3D, *_sym, _maxRadius * _pf + 1, LINEAR_INTERP);
+    {
+        _symmetrizer.init(*_sym,
+                          _F3D.index(),
+                          PAD_SIZE,
+                          PAD_SIZE,
+                          PAD_SIZE,
+                          _maxRadius * _pf + 1,
+                          _memory);
+
+        _symmetrizer.apply(_F3D, _F3D);
+    }
     else
         CLOG(WARNING, "LOGGER_SYS") << "Symmetry Information Not Assigned in Reconstructor";
 }
@@ -1338,7 +2074,20 @@ void Reconstructor::symmetrizeF()
 void Reconstructor::symmetrizeT()
 {
     if (_sym != NULL)
-        SYMMETRIZE_FT(_T3D, _T3D, *_sym, _maxRadius * _pf + 1, LINEAR_INTERP);
+    {
+        // the stencils are prepared once and kept through iterations, as long
+        // as the size and the radius stay the same
+
+        _symmetrizer.init(*_sym,
+                          _T3D.index(),
+                          PAD_SIZE,
+                          PAD_SIZE,
+                          PAD_SIZE,
+                          _maxRadius * _pf + 1,
+                          _memory);
+
+        _symmetrizer.apply(_T3D, _T3D);
+    }
     else
         CLOG(WARNING, "LOGGER_SYS") << "Symmetry Information Not Assigned in Reconstructor";
 }
@@ -3,6 +3,7 @@
 #include "Utils.h"
 
 #include <stdexcept>
+#include <cstdio>
 #include <regex.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -63,3 +64,25 @@ const char* getTempDirectory(void)
     mkdir(tmp, 0755);
     return tmp;
 }
+
+size_t availableMemory(void)
+{
+    FILE* file = fopen("/proc/meminfo", "r");
+
+    if (file)
+    {
+        char line[256];
+        unsigned long kb;
+
+        while (fgets(line, sizeof(line), file))
+            if (sscanf(line, "MemAvailable: %lu kB", &kb) == 1)
+            {
+                fclose(file);
+                return (size_t)kb * 1024;
+            }
+
+        fclose(file);
+    }
+
+    return (size_t)sysconf(_SC_AVPHYS_PAGES) * (size_t)sysconf(_SC_PAGESIZE);
+}
@@ -266,3 +266,18 @@ void TSFFTW_set_timelimit(RFLOAT seconds)
 	fftw_set_timelimit(seconds);
 }
 
+int TSFFTW_alignment_of(RFLOAT *p)
+{
+	return fftw_alignment_of(p);
+}
+
+int TSFFTW_import_wisdom_from_filename(const char *filename)
+{
+	return fftw_import_wisdom_from_filename(filename);
+}
+
+int TSFFTW_export_wisdom_to_filename(const char *filename)
+{
+	return fftw_export_wisdom_to_filename(filename);
+}
+
@@ -0,0 +1,133 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: BatchProjectionTest
+ * Description: a volume too large for the cache is projected at random
+ *              rotations on pre-determined pixels, one rotation after another
+ *              and in batches of several sizes ordered along the Hilbert
+ *              curve, comparing the projections per second on a single core
+ *              and the projections
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include "Projector.h"
+#include "Random.h"
+#include "Euler.h"
+
+#define N 192
+
+#define N_ROT 1024
+
+#define N_BATCH 4
+
+#define N_REPEAT 7
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    omp_set_num_threads(1);
+
+    Projector proj;
+
+    {
+        Volume vol(N, N, N, FT_SPACE);
+
+        VOLUME_FOR_EACH_PIXEL_FT(vol)
+            vol.setFTHalf(COMPLEX(exp(-0.001 * QUAD_3(i, j, k)),
+                                  0.1 * sin(0.3 * i + 0.2 * j - 0.1 * k)),
+                          i,
+                          j,
+                          k);
+
+        proj.setProjectee(boost::move(vol));
+    }
+
+    int r = proj.maxRadius();
+
+    vector<int> iCol, iRow;
+
+    IMAGE_FOR_PIXEL_R_FT(r)
+        if (QUAD(i, j) < r * r)
+        {
+            iCol.push_back(i);
+            iRow.push_back(j);
+        }
+
+    int nPxl = iCol.size();
+
+    mat33* rot = new mat33[N_ROT];
+
+    for (int l = 0; l < N_ROT; l++)
+        randRotate3D(rot[l]);
+
+    // the projections of all the rotations, one rotation after another
+
+    Complex* ref = new Complex[(size_t)nPxl * N_ROT];
+    Complex* batch = new Complex[(size_t)nPxl * N_ROT];
+
+    const int batchSize[N_BATCH] = {1, 16, 64, 256};
+
+    double time[N_BATCH];
+
+    for (int s = 0; s < N_BATCH; s++)
+        time[s] = 1e30;
+
+    for (int repeat = 0; repeat < N_REPEAT; repeat++)
+        for (int s = 0; s < N_BATCH; s++)
+        {
+            Complex* dst = (s == 0) ? ref : batch;
+
+            double start = omp_get_wtime();
+
+            for (int m = 0; m < N_ROT; m += batchSize[s])
+            {
+                if (s == 0)
+                    proj.project(dst + (size_t)nPxl * m, rot[m], &iCol[0], &iRow[0], nPxl);
+                else
+                    proj.projectBatch(dst + (size_t)nPxl * m,
+                                      rot + m,
+                                      GSL_MIN_INT(batchSize[s], N_ROT - m),
+                                      &iCol[0],
+                                      &iRow[0],
+                                      nPxl);
+            }
+
+            time[s] = GSL_MIN_DBL(time[s], omp_get_wtime() - start);
+
+            if (s == 0) continue;
+
+            RFLOAT diff = 0;
+
+            for (size_t i = 0; i < (size_t)nPxl * N_ROT; i++)
+                diff = GSL_MAX_DBL(diff, ABS(batch[i] - ref[i]));
+
+            if (repeat == N_REPEAT - 1)
+                CLOG(INFO, "LOGGER_SYS") << "Batch of "
+                                         << batchSize[s]
+                                         << " Rotations: Max Difference = "
+                                         << diff;
+        }
+
+    for (int s = 0; s < N_BATCH; s++)
+        CLOG(INFO, "LOGGER_SYS") << "Batch of "
+                                 << batchSize[s]
+                                 << " Rotations, "
+                                 << nPxl
+                                 << " Pixels: "
+                                 << N_ROT / time[s]
+                                 << " Projections per Second per Core";
+
+    delete[] rot;
+
+    delete[] ref;
+    delete[] batch;
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: BrickProjectionTest
+ * Description: central slices of random orientations are interpolated from
+ *              padded volumes of 128, 256 and 512 voxels cropped to the
+ *              inscribed sphere, stored row by row and in bricks, comparing
+ *              the best throughput of several runs and the projections
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include "SphereVolume.h"
+#include "Random.h"
+#include "Euler.h"
+
+#define PF 2
+
+#define N_SIZE 3
+
+#define N_ROT 200
+
+#define N_REPEAT 5
+
+INITIALIZE_EASYLOGGINGPP
+
+/**
+ * fill the voxels inside the sphere by a smooth function of the frequency,
+ * keeping the others 0
+ */
+static void fill(SphereVolume& vol)
+{
+    memset(&vol[0], 0, vol.sizeFT() * sizeof(Complex));
+
+    int n = vol.nRowRL();
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t row = 0; row < vol.index().nRowFT(); row++)
+    {
+        int j = row % n;
+        int k = row / n;
+
+        int jj = (j <= n / 2) ? j : j - n;
+        int kk = (k <= n / 2) ? k : k - n;
+
+        for (int i = 0; i < vol.index().len(row); i++)
+            vol.setFTHalf(COMPLEX(exp(-1e-4 * QUAD_3(i, jj, kk)),
+                                  sin(0.05 * i + 0.03 * jj - 0.02 * kk)),
+                          i,
+                          j,
+                          k);
+    }
+}
+
+/**
+ * project the volume at the rotations, one pixel after another
+ */
+static void project(const SphereVolume& vol,
+                    const mat33* rot,
+                    const int r,
+                    Complex* dst)
+{
+    int nPxl = 0;
+
+    for (int l = 0; l < N_ROT; l++)
+        for (int j = -r; j < r; j++)
+            for (int i = 0; i <= r; i++)
+                if (QUAD(i, j) < r * r)
+                {
+                    vec3 newCor((RFLOAT)(i * PF), (RFLOAT)(j * PF), 0);
+                    vec3 oldCor = rot[l] * newCor;
+
+                    dst[nPxl++] = vol.getByInterpolationFT(oldCor(0),
+                                                           oldCor(1),
+                                                           oldCor(2),
+                                                           LINEAR_INTERP);
+                }
+}
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    const int size[N_SIZE] = {128, 256, 512};
+
+    mat33 rot[N_ROT];
+
+    for (int l = 0; l < N_ROT; l++)
+        randRotate3D(rot[l]);
+
+    for (int s = 0; s < N_SIZE; s++)
+    {
+        int n = size[s];
+
+        // the max radius of the projection before padding
+
+        int r = n / PF / 2 - 1;
+
+        size_t nPxl = 0;
+
+        for (int j = -r; j < r; j++)
+            for (int i = 0; i <= r; i++)
+                if (QUAD(i, j) < r * r) nPxl++;
+
+        nPxl *= N_ROT;
+
+        SphereVolume vol[2];
+
+        vol[0].alloc(n, n, n, n / 2);
+        vol[1].alloc(n, n, n, n / 2, true);
+
+        Complex* result[2];
+
+        double time[2] = {1e30, 1e30};
+
+        size_t memory[2];
+
+        for (int brick = 0; brick < 2; brick++)
+        {
+            fill(vol[brick]);
+
+            memory[brick] = vol[brick].sizeFT() * sizeof(Complex) / MEGABYTE;
+
+            result[brick] = new Complex[nPxl];
+        }
+
+        // the layouts take turns, keeping the best time of each
+
+        for (int repeat = 0; repeat < N_REPEAT; repeat++)
+            for (int brick = 0; brick < 2; brick++)
+            {
+                double start = omp_get_wtime();
+
+                project(vol[brick], rot, r, result[brick]);
+
+                time[brick] = GSL_MIN_DBL(time[brick], omp_get_wtime() - start);
+            }
+
+        RFLOAT diff = 0;
+
+        for (size_t i = 0; i < nPxl; i++)
+            diff = GSL_MAX_DBL(diff, ABS(result[1][i] - result[0][i]));
+
+        for (int brick = 0; brick < 2; brick++)
+            CLOG(INFO, "LOGGER_SYS") << "Box of "
+                                     << n
+                                     << (brick ? ", Bricks: " : ", Rows: ")
+                                     << memory[brick]
+                                     << " MB, "
+                                     << nPxl / time[brick] / 1e6
+                                     << " Million Pixels per Second";
+
+        CLOG(INFO, "LOGGER_SYS") << "Box of "
+                                 << n
+                                 << ": Max Difference of Projections = "
+                                 << diff;
+
+        delete[] result[0];
+        delete[] result[1];
+    }
+
+    return 0;
+}
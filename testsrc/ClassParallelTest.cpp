@@ -0,0 +1,327 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: mpirun -n 4 ClassParallelTest
+ * Description: the projectees of several classes are built by every process,
+ *              and by the processes in turn, broadcast to the others or shared
+ *              on the node, comparing the projections and the time, and the
+ *              classes are reconstructed from F and T shared on the node by
+ *              every process, and by the processes in turn, comparing the
+ *              reconstructed volumes
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include <gsl/gsl_randist.h>
+
+#include "Projector.h"
+#include "Reconstructor.h"
+#include "FFT.h"
+#include "Random.h"
+#include "Euler.h"
+#include "DirectionalStat.h"
+#include "Transformation.h"
+
+#define N 32
+
+#define K 6
+
+#define N_ROT 50
+
+#define N_IMG 100
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    MPI_Init(&argc, &argv);
+
+    TSFFTW_init_threads();
+
+    int commSize, commRank;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &commSize);
+    MPI_Comm_rank(MPI_COMM_WORLD, &commRank);
+
+    MPI_Comm node;
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node);
+
+    int nodeRank, nodeSize;
+
+    MPI_Comm_rank(node, &nodeRank);
+    MPI_Comm_size(node, &nodeSize);
+
+    // the references of the classes, the same in all the processes
+
+    Volume ref[K];
+
+    for (int l = 0; l < K; l++)
+    {
+        ref[l].alloc(N, N, N, FT_SPACE);
+
+        VOLUME_FOR_EACH_PIXEL_FT(ref[l])
+            ref[l].setFTHalf(COMPLEX(exp(-0.01 * QUAD_3(i, j, k)) * (l + 1),
+                                     0.1 * sin(0.3 * i + 0.2 * j - 0.1 * k + l)),
+                             i,
+                             j,
+                             k);
+    }
+
+    // every process builds all the projectees, the processes build them in
+    // turn and broadcast them, and the processes of the node build them in
+    // turn and share them
+
+    const char* caseName[3] = {"Every Process", "In Turn, Broadcast", "In Turn, Shared on Node"};
+
+    Projector proj[3][K];
+
+    for (int c = 0; c < 3; c++)
+    {
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        double start = MPI_Wtime();
+
+        if (c == 0)
+        {
+            for (int l = 0; l < K; l++)
+                proj[c][l].setProjectee(ref[l].copyVolume());
+        }
+        else
+        {
+            MPI_Comm comm = (c == 1) ? MPI_COMM_WORLD : node;
+
+            int rank = (c == 1) ? commRank : nodeRank;
+            int size = (c == 1) ? commSize : nodeSize;
+
+            for (int l = 0; l < K; l++)
+            {
+                if (c == 2) proj[c][l].setNode(node);
+
+                if (l % size == rank)
+                    proj[c][l].buildProjectee(ref[l].copyVolume());
+            }
+
+            for (int l = 0; l < K; l++)
+            {
+                if (c == 1)
+                    proj[c][l].bcastProjectee(l % size, comm);
+                else
+                    proj[c][l].shareProjectee(l % size);
+            }
+        }
+
+        double time = MPI_Wtime() - start;
+
+        RFLOAT diff = 0;
+
+        Image img(N, N, FT_SPACE);
+        Image imgCase(N, N, FT_SPACE);
+
+        for (int r = 0; r < N_ROT; r++)
+        {
+            mat33 rot;
+
+            randRotate3D(rot);
+
+            for (int l = 0; l < K; l++)
+            {
+                SET_0_FT(img);
+                SET_0_FT(imgCase);
+
+                proj[0][l].project(img, rot);
+                proj[c][l].project(imgCase, rot);
+
+                FOR_EACH_PIXEL_FT(img)
+                    diff = GSL_MAX_DBL(diff, ABS(img[i] - imgCase[i]));
+            }
+        }
+
+        MPI_Allreduce(MPI_IN_PLACE, &diff, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+        if (commRank == 0)
+            CLOG(INFO, "LOGGER_SYS") << caseName[c]
+                                     << ": Building "
+                                     << K
+                                     << " Projectees in "
+                                     << time
+                                     << " Seconds, Max Difference of Projections = "
+                                     << diff;
+    }
+
+    // the projectors shared on the node are destroyed before MPI is finalised
+
+    for (int l = 0; l < K; l++)
+    {
+        Projector tmp;
+
+        tmp.swap(proj[2][l]);
+    }
+
+    // the images inserted into the reconstructors of the classes
+
+    gsl_rng* engine = get_random_engine();
+
+    Image img[N_IMG];
+
+    for (int l = 0; l < N_IMG; l++)
+    {
+        img[l].alloc(N, N, FT_SPACE);
+
+        IMAGE_FOR_EACH_PIXEL_FT(img[l])
+            img[l].setFTHalf(COMPLEX(TSGSL_ran_gaussian(engine, 1),
+                                     TSGSL_ran_gaussian(engine, 1)),
+                             i,
+                             j);
+    }
+
+    Image ctf(N, N, FT_SPACE);
+
+    SET_1_FT(ctf);
+
+    mat4 quat(N_IMG, 4);
+
+    sampleACG(quat, 1, 1, 1, N_IMG);
+
+    int maxRadius = N / 2 - 2;
+
+    vector<int> iCol, iRow, iPxl, iSig;
+
+    IMAGE_FOR_EACH_PIXEL_FT(ctf)
+        if (QUAD(i, j) < TSGSL_pow_2(maxRadius))
+        {
+            iCol.push_back(i);
+            iRow.push_back(j);
+            iPxl.push_back(ctf.iFTHalf(i, j));
+            iSig.push_back(AROUND(NORM(i, j)));
+        }
+
+    int nPxl = iCol.size();
+
+    Symmetry sym("C1");
+
+    Volume result[2][K];
+
+    for (int c = 0; c < 2; c++)
+    {
+        Reconstructor reco[K];
+
+        for (int l = 0; l < K; l++)
+        {
+            reco[l].init(MODE_3D, N, N, 2, &sym);
+
+            reco[l].setMPIEnv(commSize + 1, commRank + 1, MPI_COMM_WORLD);
+
+            reco[l].setNodeShared(true);
+
+            reco[l].setReconstructAlone(c == 1);
+
+            reco[l].setMaxRadius(maxRadius);
+
+            reco[l].setMAP(false);
+
+            reco[l].setPreCal(nPxl, &iCol[0], &iRow[0], &iPxl[0], &iSig[0]);
+
+            reco[l].allocInsert(0, N_IMG);
+
+            #pragma omp parallel for
+            for (int m = l; m < N_IMG; m++)
+            {
+                mat33 rot;
+
+                rotate3D(rot, quat.row(m).transpose());
+
+                reco[l].insertP(img[m], ctf, rot, 1);
+            }
+
+            reco[l].flushInsert();
+
+            reco[l].prepareTF();
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        double start = MPI_Wtime();
+
+        for (int l = 0; l < K; l++)
+        {
+            if ((c == 1) && (l % commSize != commRank)) continue;
+
+            Volume vol;
+
+            reco[l].reconstruct(vol);
+
+            if (c == 1)
+            {
+                FFT fft;
+                fft.fwMT(vol);
+
+                vol.clearRL();
+            }
+
+            result[c][l].swap(vol);
+        }
+
+        // the classes reconstructed in turn are broadcast to the others
+
+        if (c == 1)
+            for (int l = 0; l < K; l++)
+            {
+                if (l % commSize != commRank)
+                    result[c][l].alloc(N, N, N, FT_SPACE);
+
+                MPI_Bcast_Large(&result[c][l][0],
+                                result[c][l].sizeFT(),
+                                MPI_DOUBLE_COMPLEX,
+                                l % commSize,
+                                MPI_COMM_WORLD);
+            }
+
+        double time = MPI_Wtime() - start;
+
+        if (commRank == 0)
+            CLOG(INFO, "LOGGER_SYS") << ((c == 0) ? "Every Process" : "In Turn")
+                                     << ": Reconstructing "
+                                     << K
+                                     << " Classes in "
+                                     << time
+                                     << " Seconds";
+    }
+
+    FFT fft;
+
+    RFLOAT rel = 0;
+
+    for (int l = 0; l < K; l++)
+    {
+        fft.fwMT(result[0][l]);
+
+        RFLOAT diff = 0;
+        RFLOAT norm = 0;
+
+        FOR_EACH_PIXEL_FT(result[0][l])
+        {
+            diff += TSGSL_pow_2(ABS(result[1][l][i] - result[0][l][i]));
+            norm += TSGSL_pow_2(ABS(result[0][l][i]));
+        }
+
+        rel = GSL_MAX_DBL(rel, sqrt(diff / norm));
+    }
+
+    MPI_Allreduce(MPI_IN_PLACE, &rel, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+    if (commRank == 0)
+        CLOG(INFO, "LOGGER_SYS") << "Max Relative Difference of Reconstructions = "
+                                 << rel;
+
+    MPI_Comm_free(&node);
+
+    MPI_Finalize();
+
+    return 0;
+}
@@ -0,0 +1,191 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: FFTPlanCacheTest
+ * Description: images are transformed forth and back one after another by
+ *              creating and destroying a plan for each transform, and by the
+ *              plans in the plan cache of FFT, comparing the transforms per
+ *              second on a single core and the images, then transformed by
+ *              several threads at the same time, and the wisdom of FFTW is
+ *              exported and imported
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include "FFT.h"
+
+#define N 128
+
+#define N_IMG 200
+
+#define N_REPEAT 3
+
+#define WISDOM "FFTPlanCacheTest.wisdom"
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    TSFFTW_init_threads();
+
+    omp_set_num_threads(1);
+
+    Image img(N, N, RL_SPACE);
+
+    IMAGE_FOR_EACH_PIXEL_RL(img)
+        img.setRL(exp(-0.01 * QUAD(i, j)) + 0.1 * sin(0.3 * i + 0.2 * j), i, j);
+
+    Image ref = img.copyImage();
+    Image result = img.copyImage();
+
+    FFT fft;
+
+    double time[2] = {1e30, 1e30};
+
+    for (int repeat = 0; repeat < N_REPEAT; repeat++)
+    {
+        // creating and destroying a plan for each transform
+
+        double start = omp_get_wtime();
+
+        for (int l = 0; l < N_IMG; l++)
+        {
+            ref.alloc(FT_SPACE);
+
+            TSFFTW_PLAN plan = TSFFTW_plan_dft_r2c_2d(N,
+                                                      N,
+                                                      &ref(0),
+                                                      (TSFFTW_COMPLEX*)&ref[0],
+                                                      FFTW_ESTIMATE);
+            TSFFTW_execute(plan);
+            TSFFTW_destroy_plan(plan);
+
+            plan = TSFFTW_plan_dft_c2r_2d(N,
+                                          N,
+                                          (TSFFTW_COMPLEX*)&ref[0],
+                                          &ref(0),
+                                          FFTW_ESTIMATE);
+            TSFFTW_execute(plan);
+            TSFFTW_destroy_plan(plan);
+
+            SCALE_RL(ref, 1.0 / ref.sizeRL());
+
+            ref.clearFT();
+        }
+
+        time[0] = GSL_MIN_DBL(time[0], omp_get_wtime() - start);
+
+        // the plans in the plan cache
+
+        start = omp_get_wtime();
+
+        for (int l = 0; l < N_IMG; l++)
+        {
+            fft.fw(result);
+            fft.bw(result);
+        }
+
+        time[1] = GSL_MIN_DBL(time[1], omp_get_wtime() - start);
+    }
+
+    RFLOAT diff = 0;
+
+    IMAGE_FOR_EACH_PIXEL_RL(ref)
+        diff = GSL_MAX_DBL(diff, fabs(result.getRL(i, j) - ref.getRL(i, j)));
+
+    CLOG(INFO, "LOGGER_SYS") << "Size "
+                             << N
+                             << ": "
+                             << N_IMG / time[0]
+                             << " Transforms per Second per Core (Plan per Transform), "
+                             << N_IMG / time[1]
+                             << " (Plan Cache), Max Difference = "
+                             << diff;
+
+    // transforming by several threads at the same time
+
+    omp_set_num_threads(4);
+
+    Image imgs[N_IMG];
+
+    #pragma omp parallel for
+    for (int l = 0; l < N_IMG; l++)
+    {
+        imgs[l] = img.copyImage();
+
+        FFT fftThread;
+
+        fftThread.fw(imgs[l]);
+
+        SCALE_FT(imgs[l], 0.5 * (l % 2 + 1));
+
+        fftThread.bw(imgs[l]);
+    }
+
+    diff = 0;
+
+    for (int l = 0; l < N_IMG; l++)
+        IMAGE_FOR_EACH_PIXEL_RL(img)
+            diff = GSL_MAX_DBL(diff, fabs(imgs[l].getRL(i, j) - 0.5 * (l % 2 + 1) * img.getRL(i, j)));
+
+    CLOG(INFO, "LOGGER_SYS") << "Transforming by "
+                             << omp_get_max_threads()
+                             << " Threads, Max Difference = "
+                             << diff;
+
+    // measuring plans and the wisdom of FFTW
+
+    Image estimated = img.copyImage();
+
+    fft.fw(estimated);
+    fft.bw(estimated);
+
+    for (int round = 0; round < 2; round++)
+    {
+        if (round == 1)
+        {
+            CLOG(INFO, "LOGGER_SYS") << "Exporting Wisdom: "
+                                     << (FFT::exportWisdom(WISDOM) ? "Succeeded" : "Failed");
+
+            FFT::destroyPlans();
+
+            CLOG(INFO, "LOGGER_SYS") << "Importing Wisdom: "
+                                     << (FFT::importWisdom(WISDOM) ? "Succeeded" : "Failed");
+        }
+
+        Image measured = img.copyImage();
+
+        double start = omp_get_wtime();
+
+        fft.fwCreatePlan(N, N);
+        fft.bwCreatePlan(N, N);
+
+        double timeCreate = omp_get_wtime() - start;
+
+        fft.fwExecutePlan(measured);
+        fft.bwExecutePlan(measured);
+
+        diff = 0;
+
+        IMAGE_FOR_EACH_PIXEL_RL(img)
+            diff = GSL_MAX_DBL(diff, fabs(measured.getRL(i, j) - estimated.getRL(i, j)));
+
+        CLOG(INFO, "LOGGER_SYS") << "Measuring Plans"
+                                 << ((round == 0) ? "" : " with Wisdom")
+                                 << ": "
+                                 << timeCreate
+                                 << " Seconds, Max Difference = "
+                                 << diff;
+    }
+
+    FFT::destroyPlans();
+
+    TSFFTW_cleanup_threads();
+
+    return 0;
+}
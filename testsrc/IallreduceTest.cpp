@@ -0,0 +1,202 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: mpirun -n 4 IallreduceTest
+ * Description: buffers are all-reduced by MPI_Allreduce_Large and by
+ *              MPI_Iallreduce_Large of different chunk sizes, checking the
+ *              results, and two buffers are all-reduced at the same time
+ *              while the processes keep working on another buffer, comparing
+ *              the time with all-reducing them one after another
+ * ****************************************************************************/
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#include "Parallel.h"
+
+#define N_DATA 10000019
+
+#define N_CHUNK 4
+
+#define N_WORK 40
+
+INITIALIZE_EASYLOGGINGPP
+
+/**
+ * some work on a buffer, standing for the work overlapped with all-reducing
+ */
+static double work(double* buf,
+                   const size_t n)
+{
+    double sum = 0;
+
+    for (int r = 0; r < N_WORK; r++)
+        for (size_t i = 0; i < n; i++)
+        {
+            buf[i] = sqrt(buf[i] + r);
+            sum += buf[i];
+        }
+
+    return sum;
+}
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    MPI_Init(&argc, &argv);
+
+    int commSize, commRank;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &commSize);
+    MPI_Comm_rank(MPI_COMM_WORLD, &commRank);
+
+    // integers kept in double are summed up exactly in any order
+
+    double* ref = new double[N_DATA];
+    double* buf = new double[N_DATA];
+
+    for (size_t i = 0; i < N_DATA; i++)
+        ref[i] = (double)((i * (commRank + 1)) % 1000);
+
+    for (size_t i = 0; i < N_DATA; i++)
+        buf[i] = ref[i];
+
+    MPI_Allreduce_Large(ref, N_DATA, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+    size_t chunk[N_CHUNK] = {64 * 1024,
+                             1024 * 1024,
+                             MPI_IALLREDUCE_CHUNK,
+                             (size_t)N_DATA * sizeof(double)};
+
+    double* local = new double[N_DATA];
+
+    for (size_t i = 0; i < N_DATA; i++)
+        local[i] = buf[i];
+
+    for (int c = 0; c < N_CHUNK; c++)
+    {
+        for (size_t i = 0; i < N_DATA; i++)
+            buf[i] = local[i];
+
+        MPI_Request_Large request;
+
+        MPI_Iallreduce_Large(buf,
+                             N_DATA,
+                             MPI_DOUBLE,
+                             MPI_SUM,
+                             MPI_COMM_WORLD,
+                             request,
+                             chunk[c]);
+
+        MPI_Wait_Large(request);
+
+        size_t nError = 0;
+
+        for (size_t i = 0; i < N_DATA; i++)
+            if (buf[i] != ref[i]) nError++;
+
+        if (commRank == 0)
+            CLOG(INFO, "LOGGER_SYS") << "Chunk of "
+                                     << chunk[c]
+                                     << " Bytes, "
+                                     << request.request.size()
+                                     << " Requests Left, "
+                                     << nError
+                                     << " Errors";
+    }
+
+    // two buffers, such as T and F, all-reduced one after another with
+    // barriers, or at the same time while working on a third one
+
+    double* bufF = new double[N_DATA];
+    double* other = new double[N_DATA / 4];
+
+    for (int run = 0; run < 2; run++)
+    {
+        for (size_t i = 0; i < N_DATA; i++)
+        {
+            buf[i] = local[i];
+            bufF[i] = 2 * local[i];
+        }
+
+        for (size_t i = 0; i < N_DATA / 4; i++)
+            other[i] = i;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        double start = MPI_Wtime();
+
+        double sum;
+
+        if (run == 0)
+        {
+            MPI_Barrier(MPI_COMM_WORLD);
+
+            MPI_Allreduce_Large(buf, N_DATA, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+            MPI_Barrier(MPI_COMM_WORLD);
+
+            sum = work(other, N_DATA / 4);
+
+            MPI_Barrier(MPI_COMM_WORLD);
+
+            MPI_Allreduce_Large(bufF, N_DATA, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+        else
+        {
+            MPI_Request_Large requestT, requestF;
+
+            MPI_Iallreduce_Large(buf, N_DATA, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, requestT);
+            MPI_Iallreduce_Large(bufF, N_DATA, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD, requestF);
+
+            // the work is done piece by piece, driving the all-reducing in
+            // between
+
+            sum = 0;
+
+            for (size_t i = 0; i < N_DATA / 4; i += N_DATA / 64)
+            {
+                sum += work(other + i, std::min((size_t)N_DATA / 64, (size_t)N_DATA / 4 - i));
+
+                MPI_Test_Large(requestT);
+                MPI_Test_Large(requestF);
+            }
+
+            MPI_Wait_Large(requestT);
+            MPI_Wait_Large(requestF);
+        }
+
+        double time = MPI_Wtime() - start;
+
+        size_t nError = 0;
+
+        for (size_t i = 0; i < N_DATA; i++)
+            if ((buf[i] != ref[i]) || (bufF[i] != 2 * ref[i])) nError++;
+
+        if (commRank == 0)
+            CLOG(INFO, "LOGGER_SYS") << ((run == 0) ? "Blocking" : "Overlapped")
+                                     << ": "
+                                     << time
+                                     << " Seconds, "
+                                     << nError
+                                     << " Errors, Work = "
+                                     << sum;
+    }
+
+    delete[] ref;
+    delete[] buf;
+    delete[] local;
+    delete[] bufF;
+    delete[] other;
+
+    MPI_Finalize();
+
+    return 0;
+}
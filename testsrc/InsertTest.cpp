@@ -0,0 +1,148 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: InsertTest
+ * Description: random images are inserted into reconstructors by atomic
+ *              additions, by thread-private volumes and by tiles, comparing
+ *              the time of insertion and the reconstructed volumes
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include <gsl/gsl_randist.h>
+
+#include "Random.h"
+#include "Euler.h"
+#include "DirectionalStat.h"
+#include "Reconstructor.h"
+
+#define N 32
+
+#define N_IMG 2000
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    MPI_Init(&argc, &argv);
+
+    TSFFTW_init_threads();
+
+    gsl_rng* engine = get_random_engine();
+
+    Image* img = new Image[N_IMG];
+
+    for (int l = 0; l < N_IMG; l++)
+    {
+        img[l].alloc(N, N, FT_SPACE);
+
+        IMAGE_FOR_EACH_PIXEL_FT(img[l])
+            img[l].setFTHalf(COMPLEX(TSGSL_ran_gaussian(engine, 1),
+                                     TSGSL_ran_gaussian(engine, 1)),
+                             i,
+                             j);
+    }
+
+    Image ctf(N, N, FT_SPACE);
+
+    SET_1_FT(ctf);
+
+    mat4 quat(N_IMG, 4);
+
+    sampleACG(quat, 1, 1, 1, N_IMG);
+
+    int maxRadius = N / 2 - 2;
+
+    vector<int> iCol, iRow, iPxl, iSig;
+
+    IMAGE_FOR_EACH_PIXEL_FT(ctf)
+        if (QUAD(i, j) < TSGSL_pow_2(maxRadius))
+        {
+            iCol.push_back(i);
+            iRow.push_back(j);
+            iPxl.push_back(ctf.iFTHalf(i, j));
+            iSig.push_back(AROUND(NORM(i, j)));
+        }
+
+    int nPxl = iCol.size();
+
+    size_t memory[3] = {0,
+                        (size_t)-1,
+                        4 * omp_get_max_threads() * nPxl * sizeof(InsertSplat)};
+
+    const char* name[3] = {"Atomic", "Thread-Private", "Tile"};
+
+    Volume result[3];
+
+    for (int mode = 0; mode < 3; mode++)
+    {
+        Reconstructor reco(MODE_3D, N, N);
+
+        reco.setMPIEnv(2, 1, MPI_COMM_SELF);
+
+        reco.setMaxRadius(maxRadius);
+
+        reco.setMAP(false);
+
+        reco.setPreCal(nPxl, &iCol[0], &iRow[0], &iPxl[0], &iSig[0]);
+
+        reco.allocInsert(memory[mode]);
+
+        int nImgBatch = GSL_MIN_INT(reco.insertBatch(), N_IMG);
+
+        double start = omp_get_wtime();
+
+        for (int lBatch = 0; lBatch < N_IMG; lBatch += nImgBatch)
+        {
+            int lEnd = GSL_MIN_INT(lBatch + nImgBatch, N_IMG);
+
+            #pragma omp parallel for
+            for (int l = lBatch; l < lEnd; l++)
+            {
+                mat33 rot;
+
+                rotate3D(rot, quat.row(l).transpose());
+
+                reco.insertP(img[l], ctf, rot, 1);
+            }
+
+            reco.flushInsert();
+        }
+
+        reco.prepareTF();
+
+        CLOG(INFO, "LOGGER_SYS") << name[mode]
+                                 << ": Insertion in "
+                                 << omp_get_wtime() - start
+                                 << " Seconds";
+
+        reco.reconstruct(result[mode]);
+    }
+
+    for (int mode = 1; mode < 3; mode++)
+    {
+        RFLOAT diff = 0;
+        RFLOAT norm = 0;
+
+        FOR_EACH_PIXEL_RL(result[0])
+        {
+            diff += TSGSL_pow_2(result[mode](i) - result[0](i));
+            norm += TSGSL_pow_2(result[0](i));
+        }
+
+        CLOG(INFO, "LOGGER_SYS") << name[mode]
+                                 << ": Relative Difference to Atomic = "
+                                 << sqrt(diff / norm);
+    }
+
+    delete[] img;
+
+    MPI_Finalize();
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: mpirun -n 4 NodeSharedTest
+ * Description: the processes insert different numbers of images, flushing at
+ *              different times, into reconstructors of their own F and T, and
+ *              of F and T shared on the node, by atomic additions and by tiles,
+ *              comparing the reconstructed volumes and the time
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include <gsl/gsl_randist.h>
+
+#include "Random.h"
+#include "Euler.h"
+#include "DirectionalStat.h"
+#include "Reconstructor.h"
+
+#define N 16
+
+#define N_IMG 200
+
+#define N_CASE 4
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    MPI_Init(&argc, &argv);
+
+    TSFFTW_init_threads();
+
+    int commSize, commRank;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &commSize);
+    MPI_Comm_rank(MPI_COMM_WORLD, &commRank);
+
+    gsl_rng* engine = get_random_engine();
+
+    // each process inserts a different number of images
+
+    int nImg = N_IMG + 37 * commRank;
+
+    Image* img = new Image[nImg];
+
+    for (int l = 0; l < nImg; l++)
+    {
+        img[l].alloc(N, N, FT_SPACE);
+
+        IMAGE_FOR_EACH_PIXEL_FT(img[l])
+            img[l].setFTHalf(COMPLEX(TSGSL_ran_gaussian(engine, 1),
+                                     TSGSL_ran_gaussian(engine, 1)),
+                             i,
+                             j);
+    }
+
+    Image ctf(N, N, FT_SPACE);
+
+    SET_1_FT(ctf);
+
+    mat4 quat(nImg, 4);
+
+    sampleACG(quat, 1, 1, 1, nImg);
+
+    int maxRadius = N / 2 - 2;
+
+    vector<int> iCol, iRow, iPxl, iSig;
+
+    IMAGE_FOR_EACH_PIXEL_FT(ctf)
+        if (QUAD(i, j) < TSGSL_pow_2(maxRadius))
+        {
+            iCol.push_back(i);
+            iRow.push_back(j);
+            iPxl.push_back(ctf.iFTHalf(i, j));
+            iSig.push_back(AROUND(NORM(i, j)));
+        }
+
+    int nPxl = iCol.size();
+
+    Symmetry sym("C4");
+
+    // no memory for buffering leads to atomic additions, while the memory
+    // for buffering a few images leads to tiles, flushed at different times
+    // as the numbers of images differ
+
+    const bool shared[N_CASE] = {false, false, true, true};
+
+    const size_t memory[N_CASE] = {0, 64 * 1024, 0, 64 * 1024};
+
+    const char* modeName[2] = {"Atomic", "Tile"};
+
+    Volume result[N_CASE];
+
+    for (int c = 0; c < N_CASE; c++)
+    {
+        Reconstructor reco(MODE_3D, N, N, 2, &sym);
+
+        // the rank of the master is kept away from the processes
+
+        reco.setMPIEnv(commSize + 1, commRank + 1, MPI_COMM_WORLD);
+
+        reco.setNodeShared(shared[c]);
+
+        reco.setMaxRadius(maxRadius);
+
+        reco.setMAP(false);
+
+        reco.setPreCal(nPxl, &iCol[0], &iRow[0], &iPxl[0], &iSig[0]);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        double start = MPI_Wtime();
+
+        reco.allocInsert(memory[c], nImg);
+
+        int batch = reco.insertBatch();
+
+        for (int lBatch = 0; lBatch < nImg; lBatch += batch)
+        {
+            #pragma omp parallel for
+            for (int l = lBatch; l < GSL_MIN_INT(lBatch + batch, nImg); l++)
+            {
+                mat33 rot;
+
+                rotate3D(rot, quat.row(l).transpose());
+
+                reco.insertP(img[l], ctf, rot, 1);
+            }
+
+            reco.flushInsert();
+        }
+
+        reco.prepareTF();
+
+        double time = MPI_Wtime() - start;
+
+        reco.reconstruct(result[c]);
+
+        if (commRank == 0)
+            CLOG(INFO, "LOGGER_SYS") << (shared[c] ? "Shared on Node" : "Own")
+                                     << ", "
+                                     << modeName[(memory[c] == 0) ? 0 : 1]
+                                     << ": Inserting and Preparing F and T in "
+                                     << time
+                                     << " Seconds";
+    }
+
+    // the sums differ in the order of additions only
+
+    for (int c = 1; c < N_CASE; c++)
+    {
+        RFLOAT diff = 0;
+        RFLOAT norm = 0;
+
+        FOR_EACH_PIXEL_RL(result[0])
+        {
+            diff += TSGSL_pow_2(result[c](i) - result[0](i));
+            norm += TSGSL_pow_2(result[0](i));
+        }
+
+        RFLOAT rel = sqrt(diff / norm);
+
+        MPI_Allreduce(MPI_IN_PLACE, &rel, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+        if (commRank == 0)
+            CLOG(INFO, "LOGGER_SYS") << "Case "
+                                     << c
+                                     << ": Max Relative Difference of Reconstructions to Case 0 = "
+                                     << rel;
+    }
+
+    delete[] img;
+
+    MPI_Finalize();
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: ProjectionCacheTest
+ * Description: projections of rotations perturbed around a few preferred
+ *              orientations are looked up in the cache by multiple threads,
+ *              checking that a hit returns the projection of the bin, and
+ *              reporting the hit rate, then a zero quaternion is quantised,
+ *              checking that it falls on the identity, and caches of small
+ *              memory are initialised, checking that they fit in it
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include "Logging.h"
+#include "Random.h"
+#include "DirectionalStat.h"
+#include "ProjectionCache.h"
+
+#define N_PXL 1000
+
+#define N_PREFER 20
+
+#define N_LOOK_UP 100000
+
+INITIALIZE_EASYLOGGINGPP
+
+// a fake projection, depending on the class and the rotation only
+
+static void project(EFLOAT* re,
+                    EFLOAT* im,
+                    const unsigned int cls,
+                    const vec4& quat)
+{
+    for (int i = 0; i < N_PXL; i++)
+    {
+        re[i] = cls + quat(i % 4) * i;
+        im[i] = cls - quat((i + 1) % 4) * i;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    RFLOAT step = 0.01;
+
+    ProjectionCache cache(8.0, N_PXL, step, true);
+
+    CLOG(INFO, "LOGGER_SYS") << "Capacity: " << cache.capacity();
+
+    mat4 prefer(N_PREFER, 4);
+
+    sampleACG(prefer, 1, 1, 1, N_PREFER);
+
+    size_t nWrong = 0;
+
+    #pragma omp parallel for reduction(+:nWrong)
+    for (int i = 0; i < N_LOOK_UP; i++)
+    {
+        mat4 d(1, 4);
+
+        sampleACG(d, 1e-5, 1e-5, 1e-5, 1);
+
+        vec4 quat;
+
+        quaternion_mul(quat,
+                       d.row(0).transpose(),
+                       prefer.row(i % N_PREFER).transpose());
+
+        // q and -q are the same rotation
+
+        if (i % 2 == 0) quat = -quat;
+
+        unsigned int cls = i % 2;
+
+        EFLOAT re[N_PXL], im[N_PXL];
+
+        vec4 quatQ;
+
+        cache.quantise(quatQ, quat);
+
+        if (cache.get(re, im, cls, quat))
+        {
+            EFLOAT reQ[N_PXL], imQ[N_PXL];
+
+            project(reQ, imQ, cls, quatQ);
+
+            for (int j = 0; j < N_PXL; j++)
+                if ((reQ[j] != re[j]) || (imQ[j] != im[j]))
+                {
+                    nWrong++;
+
+                    break;
+                }
+        }
+        else
+        {
+            project(re, im, cls, quatQ);
+
+            cache.put(re, im, cls, quat);
+        }
+    }
+
+    CLOG(INFO, "LOGGER_SYS") << "Hit: " << cache.nHit()
+                             << ", Miss: " << cache.nMiss()
+                             << ", Hit Rate: " << (RFLOAT)cache.nHit() / N_LOOK_UP;
+
+    CLOG(INFO, "LOGGER_SYS") << "Hits with Wrong Projection: " << nWrong;
+
+    if (nWrong != 0)
+    {
+        CLOG(ERROR, "LOGGER_SYS") << "Wrong Projections Returned by Cache";
+
+        return 1;
+    }
+
+    // a zero quaternion is quantised to the identity
+
+    vec4 zero;
+
+    cache.quantise(zero, vec4::Zero());
+
+    CLOG(INFO, "LOGGER_SYS") << "Zero Quaternion Quantised to: " << zero.transpose();
+
+    if (zero != vec4(1, 0, 0, 0))
+    {
+        CLOG(ERROR, "LOGGER_SYS") << "Zero Quaternion Not Quantised to Identity";
+
+        return 1;
+    }
+
+    // caches holding fewer projections than shards stay within the memory
+
+    RFLOAT size[] = {0.05, 0.5, 1.5};
+
+    for (int i = 0; i < 3; i++)
+    {
+        ProjectionCache small(size[i], N_PXL, step, true);
+
+        RFLOAT memory = (RFLOAT)small.capacity() * 2 * N_PXL * sizeof(EFLOAT) / 1024 / 1024;
+
+        CLOG(INFO, "LOGGER_SYS") << "Memory: " << size[i]
+                                 << " MB, Capacity: " << small.capacity()
+                                 << ", Memory Used: " << memory << " MB";
+
+        if (memory > size[i])
+        {
+            CLOG(ERROR, "LOGGER_SYS") << "Cache Exceeding the Memory Given";
+
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: ProjectionKernelTest
+ * Description: an image and a volume are projected at many orientations on
+ *              pre-determined pixels by the projection kernel of Projector,
+ *              and by rotating and interpolating pixel by pixel, comparing the
+ *              projections per second on a single core and the projections
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include "Projector.h"
+#include "Random.h"
+#include "Euler.h"
+
+#define N 128
+
+#define N_ROT 400
+
+#define N_REPEAT 3
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    omp_set_num_threads(1);
+
+    Image img(N, N, FT_SPACE);
+
+    IMAGE_FOR_EACH_PIXEL_FT(img)
+        img.setFTHalf(COMPLEX(exp(-0.001 * QUAD(i, j)),
+                              0.1 * sin(0.3 * i + 0.2 * j)),
+                      i,
+                      j);
+
+    Volume vol(N, N, N, FT_SPACE);
+
+    VOLUME_FOR_EACH_PIXEL_FT(vol)
+        vol.setFTHalf(COMPLEX(exp(-0.001 * QUAD_3(i, j, k)),
+                              0.1 * sin(0.3 * i + 0.2 * j - 0.1 * k)),
+                      i,
+                      j,
+                      k);
+
+    Projector proj2D, proj3D;
+
+    proj2D.setMode(MODE_2D);
+    proj2D.setProjectee(img.copyImage());
+
+    proj3D.setProjectee(vol.copyVolume());
+
+    int r = proj3D.maxRadius();
+
+    vector<int> iCol, iRow;
+
+    IMAGE_FOR_PIXEL_R_FT(r)
+        if (QUAD(i, j) < r * r)
+        {
+            iCol.push_back(i);
+            iRow.push_back(j);
+        }
+
+    int nPxl = iCol.size();
+
+    mat22 rot2D[N_ROT];
+    mat33 rot3D[N_ROT];
+
+    for (int l = 0; l < N_ROT; l++)
+    {
+        rotate2D(rot2D[l], 2 * M_PI * l / N_ROT);
+
+        randRotate3D(rot3D[l]);
+    }
+
+    Complex* kernel = new Complex[nPxl];
+    Complex* ref = new Complex[nPxl];
+
+    for (int dim = 2; dim <= 3; dim++)
+    {
+        double time[2] = {1e30, 1e30};
+
+        RFLOAT diff = 0;
+
+        for (int repeat = 0; repeat < N_REPEAT; repeat++)
+        {
+            double start = omp_get_wtime();
+
+            for (int l = 0; l < N_ROT; l++)
+            {
+                if (dim == 2)
+                    proj2D.project(kernel, rot2D[l], &iCol[0], &iRow[0], nPxl);
+                else
+                    proj3D.project(kernel, rot3D[l], &iCol[0], &iRow[0], nPxl);
+            }
+
+            time[0] = GSL_MIN_DBL(time[0], omp_get_wtime() - start);
+
+            // rotating and interpolating pixel by pixel
+
+            start = omp_get_wtime();
+
+            for (int l = 0; l < N_ROT; l++)
+            {
+                for (int i = 0; i < nPxl; i++)
+                {
+                    if (dim == 2)
+                    {
+                        vec2 newCor((RFLOAT)(iCol[i] * 2), (RFLOAT)(iRow[i] * 2));
+                        vec2 oldCor = rot2D[l] * newCor;
+
+                        ref[i] = proj2D.projectee2D().getByInterpolationFT(oldCor(0),
+                                                                           oldCor(1),
+                                                                           LINEAR_INTERP);
+                    }
+                    else
+                    {
+                        vec3 newCor((RFLOAT)(iCol[i] * 2), (RFLOAT)(iRow[i] * 2), 0);
+                        vec3 oldCor = rot3D[l] * newCor;
+
+                        ref[i] = proj3D.projectee3D().getByInterpolationFT(oldCor(0),
+                                                                           oldCor(1),
+                                                                           oldCor(2),
+                                                                           LINEAR_INTERP);
+                    }
+                }
+            }
+
+            time[1] = GSL_MIN_DBL(time[1], omp_get_wtime() - start);
+        }
+
+        // the projections of the last orientation
+
+        if (dim == 2)
+            proj2D.project(kernel, rot2D[N_ROT - 1], &iCol[0], &iRow[0], nPxl);
+        else
+            proj3D.project(kernel, rot3D[N_ROT - 1], &iCol[0], &iRow[0], nPxl);
+
+        for (int i = 0; i < nPxl; i++)
+            diff = GSL_MAX_DBL(diff, ABS(kernel[i] - ref[i]));
+
+        CLOG(INFO, "LOGGER_SYS") << dim
+                                 << "D, "
+                                 << nPxl
+                                 << " Pixels: "
+                                 << N_ROT / time[0]
+                                 << " Projections per Second per Core (Kernel), "
+                                 << N_ROT / time[1]
+                                 << " (Pixel by Pixel), Max Difference = "
+                                 << diff;
+    }
+
+    delete[] kernel;
+    delete[] ref;
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: ProjectorResizeTest
+ * Description: projectees are built from a particle of Gaussian blobs and
+ *              from the particle cropped in Fourier space to several
+ *              frequencies plus margins, comparing the memory, the projections
+ *              per second on a single core and the projections of random
+ *              rotations within the frequency
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include "Projector.h"
+#include "Random.h"
+#include "Euler.h"
+#include "FFT.h"
+
+#define N 128
+
+#define N_R 2
+
+#define N_MARGIN 4
+
+#define N_ROT 200
+
+#define N_BLOB 20
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    omp_set_num_threads(1);
+
+    gsl_rng* engine = get_random_engine();
+
+    // a particle of Gaussian blobs inside the sphere of a quarter of the box
+
+    Volume vol(N, N, N, RL_SPACE);
+
+    SET_0_RL(vol);
+
+    for (int b = 0; b < N_BLOB; b++)
+    {
+        vec3 centre;
+
+        do
+        {
+            for (int d = 0; d < 3; d++)
+                centre(d) = (TSGSL_rng_uniform(engine) - 0.5) * N / 2;
+        } while (centre.norm() > N / 4);
+
+        VOLUME_FOR_EACH_PIXEL_RL(vol)
+            vol.setRL(vol.getRL(i, j, k)
+                    + exp(-QUAD_3(i - centre(0),
+                                  j - centre(1),
+                                  k - centre(2)) / 8),
+                      i,
+                      j,
+                      k);
+    }
+
+    FFT fft;
+    fft.fwMT(vol);
+    vol.clearRL();
+
+    Projector full;
+
+    full.setProjectee(vol.copyVolume());
+
+    const int r[N_R] = {16, 32};
+
+    const int margin[N_MARGIN] = {1, 2, 4, 8};
+
+    mat33 rot[N_ROT];
+
+    for (int m = 0; m < N_ROT; m++)
+        randRotate3D(rot[m]);
+
+    for (int s = 0; s < N_R; s++)
+    {
+        vector<int> iCol, iRow;
+
+        IMAGE_FOR_PIXEL_R_FT(r[s])
+            if (QUAD(i, j) < TSGSL_pow_2(r[s]))
+            {
+                iCol.push_back(i);
+                iRow.push_back(j);
+            }
+
+        int nPxl = iCol.size();
+
+        Complex* ref = new Complex[(size_t)nPxl * N_ROT];
+        Complex* result = new Complex[(size_t)nPxl * N_ROT];
+
+        full.setMaxRadius(r[s]);
+
+        double start = omp_get_wtime();
+
+        full.projectBatch(ref, rot, N_ROT, &iCol[0], &iRow[0], nPxl);
+
+        double time = omp_get_wtime() - start;
+
+        CLOG(INFO, "LOGGER_SYS") << "Frequency "
+                                 << r[s]
+                                 << ", Size "
+                                 << N
+                                 << ": "
+                                 << full.projectee3D().sizeFT() * sizeof(Complex) / MEGABYTE
+                                 << " MB, "
+                                 << N_ROT / time
+                                 << " Projections per Second per Core";
+
+        for (int t = 0; t < N_MARGIN; t++)
+        {
+            int size = GSL_MIN_INT(N, (r[s] + margin[t]) * 2);
+
+            Volume crop;
+
+            VOL_EXTRACT_FT(crop, vol, (RFLOAT)size / N);
+
+            Projector proj;
+
+            proj.setProjectee(boost::move(crop));
+
+            proj.setMaxRadius(r[s]);
+
+            start = omp_get_wtime();
+
+            proj.projectBatch(result, rot, N_ROT, &iCol[0], &iRow[0], nPxl);
+
+            time = omp_get_wtime() - start;
+
+            RFLOAT diff = 0;
+            RFLOAT norm = 0;
+
+            for (size_t i = 0; i < (size_t)nPxl * N_ROT; i++)
+            {
+                diff += TSGSL_pow_2(ABS(result[i] - ref[i]));
+                norm += TSGSL_pow_2(ABS(ref[i]));
+            }
+
+            CLOG(INFO, "LOGGER_SYS") << "Frequency "
+                                     << r[s]
+                                     << ", Size "
+                                     << size
+                                     << ": "
+                                     << proj.projectee3D().sizeFT() * sizeof(Complex) / MEGABYTE
+                                     << " MB, "
+                                     << N_ROT / time
+                                     << " Projections per Second per Core, Relative Difference = "
+                                     << sqrt(diff / norm);
+        }
+
+        delete[] ref;
+        delete[] result;
+    }
+
+    return 0;
+}
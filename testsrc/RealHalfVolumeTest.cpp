@@ -0,0 +1,76 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: RealHalfVolumeTest
+ * Description: a real and even volume is stored both as a complex volume and
+ *              as a real volume of half spectrum, comparing the shell averages
+ *              and the symmetrized volumes of both
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include "Spectrum.h"
+#include "Transformation.h"
+
+#define N 32
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    Volume cpx(N, N, N, FT_SPACE);
+
+    RealHalfVolume real(N, N, N);
+
+    VOLUME_FOR_EACH_PIXEL_FT(cpx)
+    {
+        RFLOAT v = exp(-0.01 * QUAD_3(i, j, k))
+                 * (1 + 0.3 * cos(0.2 * i * j));
+
+        cpx.setFTHalf(COMPLEX(v, 0), i, j, k);
+        real.setFTHalf(v, i, j, k);
+    }
+
+    vec avgCpx = vec::Zero(N / 2);
+    vec avgReal = vec::Zero(N / 2);
+
+    shellAverage(avgCpx, cpx, gsl_real, N / 2);
+    shellAverage(avgReal, real, N / 2);
+
+    CLOG(INFO, "LOGGER_SYS") << "Shell Average, Max Difference = "
+                             << (avgCpx - avgReal).cwiseAbs().maxCoeff();
+
+    const char* sym[3] = {"C4", "D7", "O"};
+
+    for (int s = 0; s < 3; s++)
+    {
+        Symmetry symmetry(sym[s]);
+
+        Volume symCpx = cpx.copyVolume();
+
+        RealHalfVolume symReal(N, N, N);
+
+        FOR_EACH_PIXEL_FT(real)
+            symReal[i] = real[i];
+
+        SYMMETRIZE_FT(symCpx, symCpx, symmetry, N / 2 - 1, LINEAR_INTERP);
+        SYMMETRIZE_FT(symReal, symReal, symmetry, N / 2 - 1);
+
+        RFLOAT diff = 0;
+
+        FOR_EACH_PIXEL_FT(symReal)
+            diff = GSL_MAX_DBL(diff, fabs(REAL(symCpx[i]) - symReal[i]));
+
+        CLOG(INFO, "LOGGER_SYS") << "Symmetrizing in "
+                                 << sym[s]
+                                 << ", Max Difference = "
+                                 << diff;
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: mpirun -n 4 SharedProjectorTest
+ * Description: a volume is set as the projectee of a projector of its own and
+ *              of a projector sharing the projectee on the node, over several
+ *              rounds, comparing the projections and the memory kept by each
+ *              process
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include "Projector.h"
+#include "FFT.h"
+#include "Random.h"
+#include "Transformation.h"
+
+#define N 64
+
+#define N_ROUND 3
+
+#define N_ROT 100
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    MPI_Init(&argc, &argv);
+
+    TSFFTW_init_threads();
+
+    int commRank;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &commRank);
+
+    MPI_Comm node;
+
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node);
+
+    int nodeSize;
+
+    MPI_Comm_size(node, &nodeSize);
+
+    Projector own, shared;
+
+    shared.setNode(node);
+
+    Image img(N, N, FT_SPACE);
+    Image sharedImg(N, N, FT_SPACE);
+
+    for (int round = 0; round < N_ROUND; round++)
+    {
+        // the volumes of the rounds differ, and are the same in all the
+        // processes
+
+        Volume ref(N, N, N, FT_SPACE);
+
+        VOLUME_FOR_EACH_PIXEL_FT(ref)
+            ref.setFTHalf(COMPLEX(exp(-0.01 * QUAD_3(i, j, k)) * (round + 1),
+                                  0.1 * sin(0.3 * i + 0.2 * j - 0.1 * k + round)),
+                          i,
+                          j,
+                          k);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        double start = MPI_Wtime();
+
+        own.setProjectee(ref.copyVolume());
+
+        double timeOwn = MPI_Wtime() - start;
+
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        start = MPI_Wtime();
+
+        shared.setProjectee(ref.copyVolume());
+
+        double timeShared = MPI_Wtime() - start;
+
+        RFLOAT diff = 0;
+
+        for (int l = 0; l < N_ROT; l++)
+        {
+            mat33 rot;
+
+            randRotate3D(rot);
+
+            SET_0_FT(img);
+            SET_0_FT(sharedImg);
+
+            own.project(img, rot);
+            shared.project(sharedImg, rot);
+
+            FOR_EACH_PIXEL_FT(img)
+                diff = GSL_MAX_DBL(diff, ABS(img[i] - sharedImg[i]));
+        }
+
+        MPI_Allreduce(MPI_IN_PLACE, &diff, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+        if (commRank == 0)
+            CLOG(INFO, "LOGGER_SYS") << "Round "
+                                     << round
+                                     << ": Setting Projectee in "
+                                     << timeOwn
+                                     << " Seconds (Own), "
+                                     << timeShared
+                                     << " Seconds (Shared by "
+                                     << nodeSize
+                                     << " Processes), Max Difference of Projections = "
+                                     << diff
+                                     << ", Max Radius "
+                                     << own.maxRadius()
+                                     << " (Own), "
+                                     << shared.maxRadius()
+                                     << " (Shared)";
+    }
+
+    if (commRank == 0)
+        CLOG(INFO, "LOGGER_SYS") << "Projectee of "
+                                 << own.projectee3D().sizeFT() * sizeof(Complex) / MEGABYTE
+                                 << " MB Kept by Each Process (Own), and by the Node (Shared)";
+
+    // the projectors are destroyed before MPI is finalised, freeing the
+    // memory shared on the node
+
+    {
+        Projector tmp;
+
+        tmp.swap(shared);
+    }
+
+    MPI_Comm_free(&node);
+
+    MPI_Finalize();
+
+    return 0;
+}
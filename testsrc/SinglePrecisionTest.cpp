@@ -0,0 +1,384 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: SinglePrecisionTest (with ref.mrc of ProjRecoTest)
+ * Description: accuracy of scoring in single precision against double
+ *              precision, on the reference and the CTFs of ProjRecoTest
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include <gsl/gsl_randist.h>
+
+#include "Projector.h"
+#include "FFT.h"
+#include "ImageFile.h"
+#include "Particle.h"
+#include "CTF.h"
+#include "Random.h"
+#include "Optimiser.h"
+
+#define PF 2
+
+#define N 200
+
+// radius of the pixels involved in scoring, as in global search
+#define RU 25
+
+#define N_IMG 16
+#define N_R 200
+#define N_T 20
+#define TRANS_S 2
+
+#define PIXEL_SIZE 1.32
+#define VOLTAGE 3e5
+#define DEFOCUS 1.3e4
+#define DEFOCUS_STEP 1e3
+#define THETA 0
+#define CS 0
+
+#define NOISE_FACTOR 3
+
+INITIALIZE_EASYLOGGINGPP
+
+/**
+ * normalise the logarithm of possibilities of an image over all poses by
+ * log-sum-exp, in double precision
+ */
+static void normalise(vec& w)
+{
+    RFLOAT wMax = w.maxCoeff();
+
+    w.array() -= wMax + log((w.array() - wMax).exp().sum());
+}
+
+static void report(const char* name,
+                   const mat& dbl,
+                   const mat& sgl)
+{
+    RFLOAT maxDiffScore = 0;
+    RFLOAT maxRelDiffScore = 0;
+    RFLOAT maxDiffLogW = 0;
+    RFLOAT maxDiffW = 0;
+
+    int nBestDiff = 0;
+
+    for (int l = 0; l < dbl.rows(); l++)
+    {
+        vec wD = dbl.row(l).transpose();
+        vec wS = sgl.row(l).transpose();
+
+        maxDiffScore = GSL_MAX_DBL(maxDiffScore, (wD - wS).cwiseAbs().maxCoeff());
+        maxRelDiffScore = GSL_MAX_DBL(maxRelDiffScore,
+                                      ((wD - wS).array() / wD.array()).abs().maxCoeff());
+
+        int bestD, bestS;
+
+        wD.maxCoeff(&bestD);
+        wS.maxCoeff(&bestS);
+
+        if (bestD != bestS) nBestDiff++;
+
+        normalise(wD);
+        normalise(wS);
+
+        // only the poses carrying weight matter in expectation
+
+        for (int i = 0; i < wD.size(); i++)
+            if (wD(i) > log(1e-10))
+                maxDiffLogW = GSL_MAX_DBL(maxDiffLogW, fabs(wD(i) - wS(i)));
+
+        maxDiffW = GSL_MAX_DBL(maxDiffW,
+                               (wD.array().exp() - wS.array().exp()).abs().maxCoeff());
+    }
+
+    CLOG(INFO, "LOGGER_SYS") << name
+                             << ": Max Abs Diff of Score = " << maxDiffScore
+                             << ", Max Rel Diff of Score = " << maxRelDiffScore
+                             << ", Max Diff of Log Posterior (> 1e-10) = " << maxDiffLogW
+                             << ", Max Diff of Posterior = " << maxDiffW
+                             << ", Images with Different Best Pose = " << nBestDiff
+                             << " / " << dbl.rows();
+}
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    FFT fft;
+
+    Symmetry sym("C1");
+
+    CLOG(INFO, "LOGGER_SYS") << "Read-in Ref";
+
+    Volume ref;
+    ImageFile imf("ref.mrc", "r");
+    imf.readMetaData();
+    imf.readVolume(ref);
+
+    if ((ref.nColRL() != N) ||
+        (ref.nRowRL() != N))
+    {
+        CLOG(FATAL, "LOGGER_SYS") << "Wrong Size!";
+
+        abort();
+    }
+
+    fft.fwMT(ref);
+
+    Projector projector;
+    projector.setPf(PF);
+    projector.setProjectee(ref.copyVolume());
+
+    CLOG(INFO, "LOGGER_SYS") << "Generating Pixel Indices";
+
+    vector<int> iColV, iRowV, iPxlV;
+
+    Image image(N, N, FT_SPACE);
+
+    IMAGE_FOR_PIXEL_R_FT(RU + 1)
+        if (QUAD(i, j) < TSGSL_pow_2(RU))
+        {
+            iColV.push_back(i);
+            iRowV.push_back(j);
+            iPxlV.push_back(image.iFTHalf(i, j));
+        }
+
+    int m = iColV.size();
+
+    const int* iCol = &iColV[0];
+    const int* iRow = &iRowV[0];
+
+    CLOG(INFO, "LOGGER_SYS") << "Number of Pixels: " << m;
+
+    CLOG(INFO, "LOGGER_SYS") << "Sampling Poses";
+
+    Particle par(MODE_3D, 1, N_R, N_T, 1, TRANS_S, 0.01, &sym);
+
+    mat33 rot;
+    vec2 t;
+
+    CLOG(INFO, "LOGGER_SYS") << "Generating Images";
+
+    gsl_rng* engine = get_random_engine();
+
+    // images, CTFs and reciprocal of sigma in pixel major, as global search
+    // the double precision reference is scored on interleaved complex numbers,
+    // while the single precision is scored on split real and imaginary part
+
+    vector<Complex> datD(N_IMG * m);
+    vector<RFLOAT> ctfD(N_IMG * m);
+    vector<RFLOAT> sigRcpD(N_IMG * m);
+
+    vector<float> datReS(N_IMG * m);
+    vector<float> datImS(N_IMG * m);
+    vector<float> ctfS(N_IMG * m);
+    vector<float> sigRcpS(N_IMG * m);
+
+    vector<Complex> pri(m);
+    vector<Complex> tra(m);
+
+    for (int l = 0; l < N_IMG; l++)
+    {
+        Image ctf(N, N, FT_SPACE);
+
+        CTF(ctf,
+            PIXEL_SIZE,
+            VOLTAGE,
+            DEFOCUS + DEFOCUS_STEP * (l % 8),
+            DEFOCUS + DEFOCUS_STEP * (l % 8),
+            THETA,
+            CS);
+
+        par.rot(rot, (l * N_R) / N_IMG);
+        par.t(t, l % N_T);
+
+        projector.project(&pri[0], rot, iCol, iRow, m);
+
+        translate(&tra[0], t(0), t(1), N, N, iCol, iRow, m);
+
+        RFLOAT power = 0;
+
+        for (int i = 0; i < m; i++)
+            power += ABS2(pri[i]);
+
+        RFLOAT sigma = NOISE_FACTOR * sqrt(power / m);
+
+        for (int i = 0; i < m; i++)
+        {
+            size_t idx = i * N_IMG + l;
+
+            ctfD[idx] = REAL(ctf.iGetFT(iPxlV[i]));
+
+            datD[idx] = tra[i] * pri[i] * ctfD[idx]
+                      + COMPLEX(TSGSL_ran_gaussian(engine, sigma / sqrt(2)),
+                                TSGSL_ran_gaussian(engine, sigma / sqrt(2)));
+
+            sigRcpD[idx] = -0.5 / TSGSL_pow_2(sigma);
+
+            datReS[idx] = REAL(datD[idx]);
+            datImS[idx] = IMAG(datD[idx]);
+            ctfS[idx] = ctfD[idx];
+            sigRcpS[idx] = sigRcpD[idx];
+        }
+    }
+
+    CLOG(INFO, "LOGGER_SYS") << "Generating Translations";
+
+    vector<Complex> traD(N_T * m);
+    vector<RFLOAT> traReD(N_T * m), traImD(N_T * m);
+    vector<float> traReS(N_T * m), traImS(N_T * m);
+
+    for (int n = 0; n < N_T; n++)
+    {
+        par.t(t, n);
+
+        translate(&traD[n * m], t(0), t(1), N, N, iCol, iRow, m);
+        translate(&traReD[n * m], &traImD[n * m], t(0), t(1), N, N, iCol, iRow, m);
+        translate(&traReS[n * m], &traImS[n * m], t(0), t(1), N, N, iCol, iRow, m);
+    }
+
+    CLOG(INFO, "LOGGER_SYS") << "Scoring";
+
+    mat scoreD(N_IMG, N_R * N_T);
+    mat scoreS(N_IMG, N_R * N_T);
+
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+    mat scoreGEMMD(N_IMG, N_R * N_T);
+    mat scoreGEMMS(N_IMG, N_R * N_T);
+
+    vector<RFLOAT> datCrossReD(N_IMG * m), datCrossImD(N_IMG * m);
+    vector<RFLOAT> ctf2SigRcpD(N_IMG * m);
+    vector<float> datCrossReS(N_IMG * m), datCrossImS(N_IMG * m);
+    vector<float> ctf2SigRcpS(N_IMG * m);
+
+    vec datNorm = vec::Zero(N_IMG);
+
+    for (int i = 0; i < m; i++)
+        for (int l = 0; l < N_IMG; l++)
+        {
+            size_t idx = i * N_IMG + l;
+
+            Complex datCross = CONJUGATE(datD[idx]) * (ctfD[idx] * sigRcpD[idx]);
+
+            datCrossReD[idx] = REAL(datCross);
+            datCrossImD[idx] = IMAG(datCross);
+            ctf2SigRcpD[idx] = TSGSL_pow_2(ctfD[idx]) * sigRcpD[idx];
+
+            datCrossReS[idx] = datCrossReD[idx];
+            datCrossImS[idx] = datCrossImD[idx];
+            ctf2SigRcpS[idx] = ctf2SigRcpD[idx];
+
+            datNorm(l) += ABS2(datD[idx]) * sigRcpD[idx];
+        }
+#endif
+
+    #pragma omp parallel for private(rot, t)
+    for (int r = 0; r < N_R; r++)
+    {
+        vector<Complex> priRotD(m), priAllD(m);
+        vector<ComplexF> priRotS(m);
+        vector<float> priRotReS(m), priRotImS(m), priAllReS(m), priAllImS(m);
+
+        par.rot(rot, r);
+
+        projector.project(&priRotD[0], rot, iCol, iRow, m);
+        projector.project(&priRotS[0], rot, iCol, iRow, m);
+
+        for (int i = 0; i < m; i++)
+        {
+            priRotReS[i] = REAL(priRotS[i]);
+            priRotImS[i] = IMAG(priRotS[i]);
+        }
+
+        for (int n = 0; n < N_T; n++)
+        {
+            for (int i = 0; i < m; i++)
+            {
+                priAllD[i] = traD[n * m + i] * priRotD[i];
+
+                priAllReS[i] = traReS[n * m + i] * priRotReS[i] - traImS[n * m + i] * priRotImS[i];
+                priAllImS[i] = traReS[n * m + i] * priRotImS[i] + traImS[n * m + i] * priRotReS[i];
+            }
+
+            scoreD.col(r * N_T + n) = logDataVSPrior(&datD[0],
+                                                     &priAllD[0],
+                                                     &ctfD[0],
+                                                     &sigRcpD[0],
+                                                     N_IMG,
+                                                     m);
+
+            scoreS.col(r * N_T + n) = logDataVSPrior(&datReS[0],
+                                                     &datImS[0],
+                                                     &priAllReS[0],
+                                                     &priAllImS[0],
+                                                     &ctfS[0],
+                                                     &sigRcpS[0],
+                                                     N_IMG,
+                                                     m);
+        }
+
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+        vector<RFLOAT> priRotReD(m), priRotImD(m);
+
+        for (int i = 0; i < m; i++)
+        {
+            priRotReD[i] = REAL(priRotD[i]);
+            priRotImD[i] = IMAG(priRotD[i]);
+        }
+
+        vector<RFLOAT> workReD(N_T * m), workImD(N_T * m);
+        vector<float> workReS(N_T * m), workImS(N_T * m);
+
+        mat resultD(N_IMG, N_T);
+        mat resultS(N_IMG, N_T);
+
+        logDataVSPrior(resultD,
+                       &datCrossReD[0],
+                       &datCrossImD[0],
+                       &ctf2SigRcpD[0],
+                       datNorm.data(),
+                       &priRotReD[0],
+                       &priRotImD[0],
+                       &traReD[0],
+                       &traImD[0],
+                       &workReD[0],
+                       &workImD[0],
+                       N_T,
+                       N_IMG,
+                       m);
+
+        logDataVSPrior(resultS,
+                       &datCrossReS[0],
+                       &datCrossImS[0],
+                       &ctf2SigRcpS[0],
+                       datNorm.data(),
+                       &priRotReS[0],
+                       &priRotImS[0],
+                       &traReS[0],
+                       &traImS[0],
+                       &workReS[0],
+                       &workImS[0],
+                       N_T,
+                       N_IMG,
+                       m);
+
+        scoreGEMMD.middleCols(r * N_T, N_T) = resultD;
+        scoreGEMMS.middleCols(r * N_T, N_T) = resultS;
+#endif
+    }
+
+    CLOG(INFO, "LOGGER_SYS") << "Accuracy against Double Precision Direct Scoring";
+
+    report("Single Precision, Direct", scoreD, scoreS);
+
+#ifdef OPTIMISER_GLOBAL_SEARCH_GEMM
+    report("Double Precision, GEMM", scoreD, scoreGEMMD);
+    report("Single Precision, GEMM", scoreD, scoreGEMMS);
+#endif
+
+    return 0;
+}
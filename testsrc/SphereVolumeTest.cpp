@@ -0,0 +1,120 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: SphereVolumeTest
+ * Description: a volume is stored both as a complex volume and as a volume
+ *              cropped to a sphere, comparing the interpolated values, the
+ *              additions, the symmetrized volumes and the conversion back to
+ *              a complex volume inside the sphere
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include "Random.h"
+#include "Transformation.h"
+
+#define N 64
+
+#define R (N / 2)
+
+#define N_POINT 100000
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    gsl_rng* engine = get_random_engine();
+
+    Volume cpx(N, N, N, FT_SPACE);
+
+    VOLUME_FOR_EACH_PIXEL_FT(cpx)
+        cpx.setFTHalf(COMPLEX(exp(-0.01 * QUAD_3(i, j, k)),
+                              0.1 * sin(0.3 * i + 0.2 * j - 0.1 * k)),
+                      i,
+                      j,
+                      k);
+
+    SphereVolume sphere;
+
+    sphere.fromVolume(cpx, R);
+
+    CLOG(INFO, "LOGGER_SYS") << "Voxels in Sphere / Voxels in Half Spectrum = "
+                             << (RFLOAT)sphere.sizeFT() / cpx.sizeFT();
+
+    // interpolation and addition at random points inside the sphere, keeping
+    // the cell of interpolation inside as well
+
+    Volume addCpx(N, N, N, FT_SPACE);
+    SET_0_FT(addCpx);
+
+    SphereVolume addSphere(N, N, N, R);
+    SET_0_FT(addSphere);
+
+    RFLOAT diffInterp = 0;
+
+    for (int p = 0; p < N_POINT; p++)
+    {
+        RFLOAT x, y, z;
+
+        do
+        {
+            x = TSGSL_ran_flat(engine, -R, R);
+            y = TSGSL_ran_flat(engine, -R, R);
+            z = TSGSL_ran_flat(engine, -R, R);
+        } while (NORM_3(x, y, z) >= R - 2);
+
+        diffInterp = GSL_MAX_DBL(diffInterp,
+                                 ABS(cpx.getByInterpolationFT(x, y, z, LINEAR_INTERP)
+                                   - sphere.getByInterpolationFT(x, y, z, LINEAR_INTERP)));
+
+        Complex v = COMPLEX(TSGSL_ran_gaussian(engine, 1),
+                            TSGSL_ran_gaussian(engine, 1));
+
+        addCpx.addFT(v, x, y, z);
+        addSphere.addFT(v, x, y, z);
+    }
+
+    CLOG(INFO, "LOGGER_SYS") << "Interpolation, Max Difference = " << diffInterp;
+
+    RFLOAT diffAdd = 0;
+
+    VOLUME_FOR_EACH_PIXEL_FT(addCpx)
+        if (addSphere.inside(i, j, k))
+            diffAdd = GSL_MAX_DBL(diffAdd,
+                                  ABS(addCpx.getFTHalf(i, j, k)
+                                    - addSphere.getFTHalf(i, j, k)));
+
+    CLOG(INFO, "LOGGER_SYS") << "Addition, Max Difference = " << diffAdd;
+
+    Symmetry symmetry("D7");
+
+    Volume symCpx = cpx.copyVolume();
+
+    SphereVolume symSphere;
+
+    symSphere.fromVolume(cpx, R);
+
+    SYMMETRIZE_FT(symCpx, symCpx, symmetry, R - 2, LINEAR_INTERP);
+    SYMMETRIZE_FT(symSphere, symSphere, symmetry, R - 2, LINEAR_INTERP);
+
+    Volume back;
+
+    symSphere.toVolume(back);
+
+    RFLOAT diffSym = 0;
+
+    VOLUME_FOR_EACH_PIXEL_FT(back)
+        if (QUAD_3(i, j, k) < TSGSL_pow_2(R))
+            diffSym = GSL_MAX_DBL(diffSym,
+                                  ABS(symCpx.getFTHalf(i, j, k)
+                                    - back.getFTHalf(i, j, k)));
+
+    CLOG(INFO, "LOGGER_SYS") << "Symmetrizing in D7, Max Difference = " << diffSym;
+
+    return 0;
+}
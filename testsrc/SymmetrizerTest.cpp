@@ -0,0 +1,127 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: SymmetrizerTest
+ * Description: a volume cropped to a sphere, and a real volume, are
+ *              symmetrized by SYMMETRIZE_FT, by a Symmetrizer of cached
+ *              stencils and by a Symmetrizer of stencils computed on the fly,
+ *              comparing the results and the time
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include "Transformation.h"
+#include "Symmetrizer.h"
+
+#define N 64
+
+#define R (N / 2)
+
+#define N_SYM 3
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    Volume cpx(N, N, N, FT_SPACE);
+
+    VOLUME_FOR_EACH_PIXEL_FT(cpx)
+        cpx.setFTHalf(COMPLEX(exp(-0.01 * QUAD_3(i, j, k)),
+                              0.1 * sin(0.3 * i + 0.2 * j - 0.1 * k)),
+                      i,
+                      j,
+                      k);
+
+    SphereVolume sphere;
+
+    sphere.fromVolume(cpx, R);
+
+    RealHalfVolume real(N, N, N, R);
+
+    VOLUME_FOR_EACH_PIXEL_FT(real)
+        real.setFTHalf(exp(-0.01 * QUAD_3(i, j, k)) + 0.1 * cos(0.3 * i), i, j, k);
+
+    const char* symName[N_SYM] = {"C4", "D7", "I"};
+
+    for (int s = 0; s < N_SYM; s++)
+    {
+        Symmetry sym(symName[s]);
+
+        SphereVolume ref;
+        ref.fromVolume(cpx, R);
+
+        RealHalfVolume refReal(N, N, N, R);
+
+        FOR_EACH_PIXEL_FT(refReal)
+            refReal[i] = real[i];
+
+        double start = omp_get_wtime();
+
+        SYMMETRIZE_FT(ref, ref, sym, R - 2, LINEAR_INTERP);
+        SYMMETRIZE_FT(refReal, refReal, sym, R - 2);
+
+        CLOG(INFO, "LOGGER_SYS") << symName[s]
+                                 << ", SYMMETRIZE_FT: "
+                                 << omp_get_wtime() - start
+                                 << " Seconds";
+
+        // the first Symmetrizer caches the stencils, the second one has no
+        // memory for them
+
+        for (int run = 0; run < 2; run++)
+        {
+            Symmetrizer symmetrizer;
+
+            start = omp_get_wtime();
+
+            symmetrizer.init(sym,
+                             sphere.index(),
+                             N,
+                             N,
+                             N,
+                             R - 2,
+                             (run == 0) ? (size_t)1 << 32 : 0);
+
+            double prepare = omp_get_wtime() - start;
+
+            SphereVolume dst;
+            dst.fromVolume(cpx, R);
+
+            RealHalfVolume dstReal(N, N, N, R);
+
+            FOR_EACH_PIXEL_FT(dstReal)
+                dstReal[i] = real[i];
+
+            start = omp_get_wtime();
+
+            symmetrizer.apply(dst, dst);
+            symmetrizer.apply(dstReal, dstReal);
+
+            double apply = omp_get_wtime() - start;
+
+            RFLOAT diff = 0;
+
+            FOR_EACH_PIXEL_FT(dst)
+                diff = GSL_MAX_DBL(diff, ABS(dst[i] - ref[i]));
+
+            FOR_EACH_PIXEL_FT(dstReal)
+                diff = GSL_MAX_DBL(diff, fabs(dstReal[i] - refReal[i]));
+
+            CLOG(INFO, "LOGGER_SYS") << symName[s]
+                                     << (symmetrizer.cached() ? ", Cached" : ", On the Fly")
+                                     << ": Preparing in "
+                                     << prepare
+                                     << " Seconds, Symmetrizing in "
+                                     << apply
+                                     << " Seconds, Max Difference to SYMMETRIZE_FT = "
+                                     << diff;
+        }
+    }
+
+    return 0;
+}
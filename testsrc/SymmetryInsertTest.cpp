@@ -0,0 +1,184 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: SymmetryInsertTest
+ * Description: images are inserted into a reconstructor in C1, D7 and I
+ *              symmetry, symmetrizing F and T after insertion and inserting
+ *              each image at all the orientations related by symmetry,
+ *              comparing the time of insertion and preparing F and T, and the
+ *              reconstructed volumes
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include <gsl/gsl_randist.h>
+
+#include "Random.h"
+#include "Euler.h"
+#include "DirectionalStat.h"
+#include "Reconstructor.h"
+
+#define N 32
+
+#define N_IMG 1000
+
+#define N_SYM 3
+
+#define MEMORY ((size_t)1 << 30)
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    MPI_Init(&argc, &argv);
+
+    TSFFTW_init_threads();
+
+    gsl_rng* engine = get_random_engine();
+
+    Image* img = new Image[N_IMG];
+
+    for (int l = 0; l < N_IMG; l++)
+    {
+        img[l].alloc(N, N, FT_SPACE);
+
+        IMAGE_FOR_EACH_PIXEL_FT(img[l])
+            img[l].setFTHalf(COMPLEX(TSGSL_ran_gaussian(engine, 1),
+                                     TSGSL_ran_gaussian(engine, 1)),
+                             i,
+                             j);
+    }
+
+    Image ctf(N, N, FT_SPACE);
+
+    SET_1_FT(ctf);
+
+    mat4 quat(N_IMG, 4);
+
+    sampleACG(quat, 1, 1, 1, N_IMG);
+
+    int maxRadius = N / 2 - 2;
+
+    vector<int> iCol, iRow, iPxl, iSig;
+
+    IMAGE_FOR_EACH_PIXEL_FT(ctf)
+        if (QUAD(i, j) < TSGSL_pow_2(maxRadius))
+        {
+            iCol.push_back(i);
+            iRow.push_back(j);
+            iPxl.push_back(ctf.iFTHalf(i, j));
+            iSig.push_back(AROUND(NORM(i, j)));
+        }
+
+    int nPxl = iCol.size();
+
+    const char* symName[N_SYM] = {"C1", "D7", "I"};
+
+    const char* modeName[2] = {"After Insertion", "By Insertion"};
+
+    for (int s = 0; s < N_SYM; s++)
+    {
+        Symmetry sym(symName[s]);
+
+        Volume result[2];
+
+        for (int mode = 0; mode < 2; mode++)
+        {
+            Reconstructor reco(MODE_3D, N, N, 2, &sym);
+
+            reco.setMPIEnv(2, 1, MPI_COMM_SELF);
+
+            reco.setMaxRadius(maxRadius);
+
+            reco.setMAP(false);
+
+            reco.setPreCal(nPxl, &iCol[0], &iRow[0], &iPxl[0], &iSig[0]);
+
+            reco.setSymmetrizeMode(mode == 0 ? SYMMETRIZE_AFTER_INSERT : SYMMETRIZE_BY_INSERT);
+
+            double start = omp_get_wtime();
+
+            reco.allocInsert(MEMORY, N_IMG);
+
+            #pragma omp parallel for
+            for (int l = 0; l < N_IMG; l++)
+            {
+                mat33 rot;
+
+                rotate3D(rot, quat.row(l).transpose());
+
+                reco.insertP(img[l], ctf, rot, 1);
+            }
+
+            reco.flushInsert();
+
+            double insert = omp_get_wtime() - start;
+
+            start = omp_get_wtime();
+
+            reco.prepareTF();
+
+            double prepare = omp_get_wtime() - start;
+
+            CLOG(INFO, "LOGGER_SYS") << symName[s]
+                                     << ", "
+                                     << modeName[mode]
+                                     << ": Inserting in "
+                                     << insert
+                                     << " Seconds, Preparing F and T in "
+                                     << prepare
+                                     << " Seconds, Total "
+                                     << insert + prepare
+                                     << " Seconds";
+
+            reco.reconstruct(result[mode]);
+        }
+
+        RFLOAT diff = 0;
+        RFLOAT norm = 0;
+
+        FOR_EACH_PIXEL_RL(result[0])
+        {
+            diff += TSGSL_pow_2(result[1](i) - result[0](i));
+            norm += TSGSL_pow_2(result[0](i));
+        }
+
+        CLOG(INFO, "LOGGER_SYS") << symName[s]
+                                 << ": Relative Difference of Reconstructions = "
+                                 << sqrt(diff / norm);
+
+        // the way SYMMETRIZE_AUTO takes at different numbers of images
+
+        for (int nImg = N_IMG / 100; nImg <= N_IMG * 100; nImg *= 10)
+        {
+            Reconstructor reco(MODE_3D, N, N, 2, &sym);
+
+            reco.setMPIEnv(2, 1, MPI_COMM_SELF);
+
+            reco.setMaxRadius(maxRadius);
+
+            reco.setPreCal(nPxl, &iCol[0], &iRow[0], &iPxl[0], &iSig[0]);
+
+            reco.setSymmetrizeMode(SYMMETRIZE_AUTO);
+
+            reco.allocInsert(MEMORY, nImg);
+
+            CLOG(INFO, "LOGGER_SYS") << symName[s]
+                                     << ", Auto, "
+                                     << nImg
+                                     << " Images: "
+                                     << modeName[reco.symmetrizeByInsert() ? 1 : 0];
+        }
+    }
+
+    delete[] img;
+
+    MPI_Finalize();
+
+    return 0;
+}
@@ -0,0 +1,196 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: TransSearchFFTTest
+ * Description: an image is scored against a projection under translations by
+ *              the inverse Fourier transform of the cross terms, and by
+ *              translating the projection pixel by pixel, which agree up to
+ *              rounding on the grid of the padded cross correlation map and
+ *              within the error of bilinear interpolation off the grid,
+ *              relative to the cross term
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include "Optimiser.h"
+
+#define N 64
+
+#define PF 2
+
+#define N_ON_GRID 4
+
+#define N_OFF_GRID 2
+
+#define THRES_ON_GRID 1e-10
+
+#define THRES_OFF_GRID 0.1
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    TSFFTW_init_threads();
+
+    omp_set_num_threads(1);
+
+    int r = N / 2 - 1;
+
+    vector<int> iCol, iRow;
+
+    IMAGE_FOR_PIXEL_R_FT(r)
+        if (QUAD(i, j) < TSGSL_pow_2(r))
+        {
+            iCol.push_back(i);
+            iRow.push_back(j);
+        }
+
+    int m = iCol.size();
+
+    vector<RFLOAT> datRe(m), datIm(m), priRe(m), priIm(m), ctf(m), sigRcp(m);
+    vector<RFLOAT> traRe(m), traIm(m), priAllRe(m), priAllIm(m);
+
+    // the image is the projection under CTF translated by (3.2, -4.7), plus a
+    // deterministic disturbance
+
+    for (int i = 0; i < m; i++)
+    {
+        RFLOAT q = QUAD(iCol[i], iRow[i]);
+
+        // a spectrum decaying as that of a particle
+
+        priRe[i] = exp(-0.005 * q) * (1 + 0.2 * cos(0.7 * iCol[i] - 0.3 * iRow[i]));
+        priIm[i] = exp(-0.005 * q) * 0.2 * sin(0.5 * iCol[i] + 0.9 * iRow[i]);
+
+        ctf[i] = 1 - 0.8 * cos(0.01 * q);
+        sigRcp[i] = 1.0 / (1 + 0.05 * sqrt(q));
+    }
+
+    translate(&traRe[0], &traIm[0], 3.2, -4.7, N, N, &iCol[0], &iRow[0], m);
+
+    for (int i = 0; i < m; i++)
+    {
+        Complex d = COMPLEX(priRe[i], priIm[i])
+                  * COMPLEX(traRe[i], traIm[i])
+                  * ctf[i];
+
+        datRe[i] = REAL(d) + 0.05 * sin(1.3 * i);
+        datIm[i] = IMAG(d) + 0.05 * cos(0.7 * i);
+    }
+
+    // translations on the grid of the map, integers and multiples of 1 / PF,
+    // then off the grid
+
+    mat2 tra(N_ON_GRID + N_OFF_GRID, 2);
+
+    tra << 0, 0,
+           3, -5,
+           1.0 / PF, -7.0 / PF,
+           -9.0 / PF, 4,
+           3.2, -4.7,
+           -1.3, 2.35;
+
+    Image cc(N * PF, N * PF, RL_SPACE);
+
+    Complex* ccFT = (Complex*)TSFFTW_malloc((N * PF / 2 + 1) * N * PF * sizeof(Complex));
+
+    FFT fft;
+
+    fft.bwCreatePlan(N * PF, N * PF);
+
+    vec result(tra.rows());
+
+    // the terms independent of translations
+
+    RFLOAT norm = 0;
+
+    for (int i = 0; i < m; i++)
+        norm += (TSGSL_pow_2(datRe[i]) + TSGSL_pow_2(datIm[i])
+               + TSGSL_pow_2(ctf[i]) * (TSGSL_pow_2(priRe[i]) + TSGSL_pow_2(priIm[i])))
+              * sigRcp[i];
+
+    // the workspaces are reused, thus the second round checks that nothing is
+    // left over from the first one
+
+    bool pass = true;
+
+    for (int round = 0; round < 2; round++)
+    {
+        logDataVSPrior(result,
+                       cc,
+                       ccFT,
+                       fft,
+                       &datRe[0],
+                       &datIm[0],
+                       &priRe[0],
+                       &priIm[0],
+                       &ctf[0],
+                       &sigRcp[0],
+                       &iCol[0],
+                       &iRow[0],
+                       tra,
+                       PF,
+                       m,
+                       1);
+
+        for (int n = 0; n < tra.rows(); n++)
+        {
+            translate(&traRe[0], &traIm[0], tra(n, 0), tra(n, 1), N, N, &iCol[0], &iRow[0], m);
+
+            for (int i = 0; i < m; i++)
+            {
+                Complex p = COMPLEX(priRe[i], priIm[i]) * COMPLEX(traRe[i], traIm[i]);
+
+                priAllRe[i] = REAL(p);
+                priAllIm[i] = IMAG(p);
+            }
+
+            RFLOAT ref = logDataVSPrior(&datRe[0],
+                                        &datIm[0],
+                                        &priAllRe[0],
+                                        &priAllIm[0],
+                                        &ctf[0],
+                                        &sigRcp[0],
+                                        m);
+
+            // the score vanishes at the peak, thus the difference is relative
+            // to the cross term, which is interpolated in the map
+
+            RFLOAT diff = fabs(result(n) - ref) / fabs(norm - ref);
+
+            bool onGrid = (n < N_ON_GRID);
+
+            if (diff > (onGrid ? THRES_ON_GRID : THRES_OFF_GRID))
+                pass = false;
+
+            if (round == 0)
+                CLOG(INFO, "LOGGER_SYS") << "Translation ("
+                                         << tra(n, 0)
+                                         << ", "
+                                         << tra(n, 1)
+                                         << ")"
+                                         << (onGrid ? " on Grid" : " off Grid")
+                                         << ": Fourier Transform = "
+                                         << result(n)
+                                         << ", Pixel by Pixel = "
+                                         << ref
+                                         << ", Relative Difference = "
+                                         << diff;
+        }
+    }
+
+    CLOG(INFO, "LOGGER_SYS") << (pass ? "Passed" : "Failed");
+
+    TSFFTW_free(ccFT);
+
+    fft.bwDestroyPlan();
+
+    TSFFTW_cleanup_threads();
+
+    return pass ? 0 : 1;
+}
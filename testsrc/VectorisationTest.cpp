@@ -0,0 +1,198 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: VectorisationTest
+ * Description: throughput of the pixel loops of expectation, calling the out
+ *              of line complex functions of GSL, on interleaved complex numbers
+ *              with inline operators and on split real and imaginary part in
+ *              double and single precision
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include <gsl/gsl_randist.h>
+
+#include "Complex.h"
+#include "Random.h"
+#include "Optimiser.h"
+
+// number of pixels, around the number of pixels in global search
+#define M 4096
+
+// number of images scored at once, pixel major
+#define N_IMG 64
+
+#define N_REPEAT 200
+
+INITIALIZE_EASYLOGGINGPP
+
+static RFLOAT logDataVSPriorGSL(const Complex* dat,
+                                const Complex* pri,
+                                const RFLOAT* ctf,
+                                const RFLOAT* sigRcp,
+                                const int m)
+{
+    RFLOAT result = 0;
+
+    for (int i = 0; i < m; i++)
+        result += gsl_complex_abs2(gsl_complex_sub(dat[i],
+                                                   gsl_complex_mul_real(pri[i], ctf[i])))
+                * sigRcp[i];
+
+    return result;
+}
+
+static void report(const char* name,
+                   const double time,
+                   const size_t nPxl,
+                   const RFLOAT result)
+{
+    CLOG(INFO, "LOGGER_SYS") << name
+                             << ": " << nPxl / time / 1e6 << " MPixel/s"
+                             << " (Check Sum = " << result << ")";
+}
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    gsl_rng* engine = get_random_engine();
+
+    vector<Complex> dat(M * N_IMG), pri(M), tra(M), priAll(M);
+    vector<RFLOAT> ctf(M * N_IMG), sigRcp(M * N_IMG);
+
+    vector<RFLOAT> datReD(M * N_IMG), datImD(M * N_IMG), priReD(M), priImD(M), traReD(M), traImD(M), priAllReD(M), priAllImD(M);
+    vector<float> datReS(M * N_IMG), datImS(M * N_IMG), priReS(M), priImS(M), traReS(M), traImS(M), priAllReS(M), priAllImS(M);
+    vector<float> ctfS(M * N_IMG), sigRcpS(M * N_IMG);
+
+    for (int i = 0; i < M; i++)
+    {
+        pri[i] = COMPLEX(TSGSL_ran_gaussian(engine, 1), TSGSL_ran_gaussian(engine, 1));
+        tra[i] = COMPLEX_POLAR(TSGSL_ran_flat(engine, -M_PI, M_PI));
+
+        priReD[i] = priReS[i] = REAL(pri[i]);
+        priImD[i] = priImS[i] = IMAG(pri[i]);
+        traReD[i] = traReS[i] = REAL(tra[i]);
+        traImD[i] = traImS[i] = IMAG(tra[i]);
+    }
+
+    for (int i = 0; i < M * N_IMG; i++)
+    {
+        dat[i] = COMPLEX(TSGSL_ran_gaussian(engine, 1), TSGSL_ran_gaussian(engine, 1));
+        ctf[i] = TSGSL_ran_flat(engine, -1, 1);
+        sigRcp[i] = -0.5;
+
+        datReD[i] = datReS[i] = REAL(dat[i]);
+        datImD[i] = datImS[i] = IMAG(dat[i]);
+        ctfS[i] = ctf[i];
+        sigRcpS[i] = sigRcp[i];
+    }
+
+    double start;
+    RFLOAT result;
+
+    CLOG(INFO, "LOGGER_SYS") << "Translating Projection";
+
+    start = omp_get_wtime();
+    result = 0;
+    for (int r = 0; r < N_REPEAT * N_IMG; r++)
+    {
+        for (int i = 0; i < M; i++)
+            priAll[i] = gsl_complex_mul(tra[i], pri[i]);
+        result += REAL(priAll[r % M]);
+    }
+    report("GSL, Interleaved, Double", omp_get_wtime() - start, (size_t)N_REPEAT * N_IMG * M, result);
+
+    start = omp_get_wtime();
+    result = 0;
+    for (int r = 0; r < N_REPEAT * N_IMG; r++)
+    {
+        for (int i = 0; i < M; i++)
+            priAll[i] = tra[i] * pri[i];
+        result += REAL(priAll[r % M]);
+    }
+    report("Inline, Interleaved, Double", omp_get_wtime() - start, (size_t)N_REPEAT * N_IMG * M, result);
+
+    start = omp_get_wtime();
+    result = 0;
+    for (int r = 0; r < N_REPEAT * N_IMG; r++)
+    {
+        #pragma omp simd
+        for (int i = 0; i < M; i++)
+        {
+            priAllReD[i] = traReD[i] * priReD[i] - traImD[i] * priImD[i];
+            priAllImD[i] = traReD[i] * priImD[i] + traImD[i] * priReD[i];
+        }
+        result += priAllReD[r % M];
+    }
+    report("Inline, Split, Double", omp_get_wtime() - start, (size_t)N_REPEAT * N_IMG * M, result);
+
+    start = omp_get_wtime();
+    result = 0;
+    for (int r = 0; r < N_REPEAT * N_IMG; r++)
+    {
+        #pragma omp simd
+        for (int i = 0; i < M; i++)
+        {
+            priAllReS[i] = traReS[i] * priReS[i] - traImS[i] * priImS[i];
+            priAllImS[i] = traReS[i] * priImS[i] + traImS[i] * priReS[i];
+        }
+        result += priAllReS[r % M];
+    }
+    report("Inline, Split, Single", omp_get_wtime() - start, (size_t)N_REPEAT * N_IMG * M, result);
+
+    CLOG(INFO, "LOGGER_SYS") << "Scoring an Image, Local Search";
+
+    start = omp_get_wtime();
+    result = 0;
+    for (int r = 0; r < N_REPEAT; r++)
+        for (int l = 0; l < N_IMG; l++)
+            result += logDataVSPriorGSL(&dat[l * M], &pri[0], &ctf[l * M], &sigRcp[l * M], M);
+    report("GSL, Interleaved, Double", omp_get_wtime() - start, (size_t)N_REPEAT * N_IMG * M, result);
+
+    start = omp_get_wtime();
+    result = 0;
+    for (int r = 0; r < N_REPEAT; r++)
+        for (int l = 0; l < N_IMG; l++)
+            result += logDataVSPrior(&dat[l * M], &pri[0], &ctf[l * M], &sigRcp[l * M], M);
+    report("Inline, Interleaved, Double", omp_get_wtime() - start, (size_t)N_REPEAT * N_IMG * M, result);
+
+    start = omp_get_wtime();
+    result = 0;
+    for (int r = 0; r < N_REPEAT; r++)
+        for (int l = 0; l < N_IMG; l++)
+            result += logDataVSPrior(&datReD[l * M], &datImD[l * M], &priReD[0], &priImD[0], &ctf[l * M], &sigRcp[l * M], M);
+    report("Inline, Split, Double", omp_get_wtime() - start, (size_t)N_REPEAT * N_IMG * M, result);
+
+    start = omp_get_wtime();
+    result = 0;
+    for (int r = 0; r < N_REPEAT; r++)
+        for (int l = 0; l < N_IMG; l++)
+            result += logDataVSPrior(&datReS[l * M], &datImS[l * M], &priReS[0], &priImS[0], &ctfS[l * M], &sigRcpS[l * M], M);
+    report("Inline, Split, Single", omp_get_wtime() - start, (size_t)N_REPEAT * N_IMG * M, result);
+
+    CLOG(INFO, "LOGGER_SYS") << "Scoring Images in Pixel Major, Global Search";
+
+    start = omp_get_wtime();
+    result = 0;
+    for (int r = 0; r < N_REPEAT; r++)
+        result += logDataVSPrior(&dat[0], &pri[0], &ctf[0], &sigRcp[0], N_IMG, M).sum();
+    report("Inline, Interleaved, Double", omp_get_wtime() - start, (size_t)N_REPEAT * N_IMG * M, result);
+
+    start = omp_get_wtime();
+    result = 0;
+    for (int r = 0; r < N_REPEAT; r++)
+        result += logDataVSPrior(&datReD[0], &datImD[0], &priReD[0], &priImD[0], &ctf[0], &sigRcp[0], N_IMG, M).sum();
+    report("Inline, Split, Double", omp_get_wtime() - start, (size_t)N_REPEAT * N_IMG * M, result);
+
+    start = omp_get_wtime();
+    result = 0;
+    for (int r = 0; r < N_REPEAT; r++)
+        result += logDataVSPrior(&datReS[0], &datImS[0], &priReS[0], &priImS[0], &ctfS[0], &sigRcpS[0], N_IMG, M).sum();
+    report("Inline, Split, Single", omp_get_wtime() - start, (size_t)N_REPEAT * N_IMG * M, result);
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+//This header file is add by huabin
+#include "huabin.h"
+/*******************************************************************************
+ * Author: Mingxu Hu
+ * Dependecy:
+ * Test:
+ * Execution: WarmStartTest
+ * Description: images are inserted into a reconstructor in two rounds, of
+ *              which the second round has slightly perturbed rotations,
+ *              balancing the weights of the second round from 1, from the
+ *              weights of the first round, and from the weights of the first
+ *              round with over-relaxation, comparing the time of balancing and
+ *              the reconstructed volumes
+ * ****************************************************************************/
+
+#include <iostream>
+
+#include <gsl/gsl_randist.h>
+
+#include "Random.h"
+#include "Euler.h"
+#include "DirectionalStat.h"
+#include "Reconstructor.h"
+
+#define N 32
+
+#define N_IMG 2000
+
+#define BALANCE_RELAX 1.5
+
+INITIALIZE_EASYLOGGINGPP
+
+int main(int argc, char* argv[])
+{
+    loggerInit(argc, argv);
+
+    MPI_Init(&argc, &argv);
+
+    TSFFTW_init_threads();
+
+    gsl_rng* engine = get_random_engine();
+
+    Image* img = new Image[N_IMG];
+
+    for (int l = 0; l < N_IMG; l++)
+    {
+        img[l].alloc(N, N, FT_SPACE);
+
+        IMAGE_FOR_EACH_PIXEL_FT(img[l])
+            img[l].setFTHalf(COMPLEX(TSGSL_ran_gaussian(engine, 1),
+                                     TSGSL_ran_gaussian(engine, 1)),
+                             i,
+                             j);
+    }
+
+    Image ctf(N, N, FT_SPACE);
+
+    SET_1_FT(ctf);
+
+    // the rotations of the second round are perturbed from the first round
+
+    mat4 quat(N_IMG, 4);
+    mat4 quatPerturb(N_IMG, 4);
+
+    sampleACG(quat, 1, 1, 1, N_IMG);
+
+    mat4 d(N_IMG, 4);
+
+    sampleACG(d, 1e-5, 1e-5, 1e-5, N_IMG);
+
+    for (int l = 0; l < N_IMG; l++)
+    {
+        vec4 q;
+
+        quaternion_mul(q,
+                       d.row(l).transpose(),
+                       quat.row(l).transpose());
+
+        quatPerturb.row(l) = q.transpose();
+    }
+
+    int maxRadius = N / 2 - 2;
+
+    vector<int> iCol, iRow, iPxl, iSig;
+
+    IMAGE_FOR_EACH_PIXEL_FT(ctf)
+        if (QUAD(i, j) < TSGSL_pow_2(maxRadius))
+        {
+            iCol.push_back(i);
+            iRow.push_back(j);
+            iPxl.push_back(ctf.iFTHalf(i, j));
+            iSig.push_back(AROUND(NORM(i, j)));
+        }
+
+    int nPxl = iCol.size();
+
+    const char* name[3] = {"Cold Start", "Warm Start", "Warm Start, Over-Relaxed"};
+
+    Volume result[3];
+
+    for (int run = 0; run < 3; run++)
+    {
+        Reconstructor reco(MODE_3D, N, N);
+
+        reco.setMPIEnv(2, 1, MPI_COMM_SELF);
+
+        reco.setWarmStartW(run > 0);
+
+        reco.setBalanceRelax(run == 2 ? BALANCE_RELAX : 1);
+
+        for (int round = 0; round < 2; round++)
+        {
+            if (round > 0) reco.reset();
+
+            reco.setMaxRadius(maxRadius);
+
+            reco.setMAP(false);
+
+            reco.setPreCal(nPxl, &iCol[0], &iRow[0], &iPxl[0], &iSig[0]);
+
+            const mat4& q = (round == 0) ? quat : quatPerturb;
+
+            #pragma omp parallel for
+            for (int l = 0; l < N_IMG; l++)
+            {
+                mat33 rot;
+
+                rotate3D(rot, q.row(l).transpose());
+
+                reco.insertP(img[l], ctf, rot, 1);
+            }
+
+            reco.prepareTF();
+
+            double start = omp_get_wtime();
+
+            reco.reconstruct(result[run]);
+
+            CLOG(INFO, "LOGGER_SYS") << name[run]
+                                     << ", Round "
+                                     << round
+                                     << ": Reconstruction in "
+                                     << omp_get_wtime() - start
+                                     << " Seconds";
+        }
+    }
+
+    for (int run = 1; run < 3; run++)
+    {
+        RFLOAT diff = 0;
+        RFLOAT norm = 0;
+
+        FOR_EACH_PIXEL_RL(result[0])
+        {
+            diff += TSGSL_pow_2(result[run](i) - result[0](i));
+            norm += TSGSL_pow_2(result[0](i));
+        }
+
+        CLOG(INFO, "LOGGER_SYS") << name[run]
+                                 << ": Relative Difference to Cold Start = "
+                                 << sqrt(diff / norm);
+    }
+
+    delete[] img;
+
+    MPI_Finalize();
+
+    return 0;
+}